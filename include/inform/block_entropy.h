@@ -4,6 +4,7 @@
 #pragma once
 
 #include <inform/error.h>
+#include <inform/shannon.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -24,6 +25,22 @@ extern "C"
 EXPORT double inform_block_entropy(int const *series, size_t n, size_t m, int b,
     size_t k, inform_error *err);
 
+/**
+ * Estimate the block entropy of an ensemble of time series, with the bias of
+ * the estimate corrected by the given estimator
+ *
+ * @param[in] series the ensemble of time series
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the block length
+ * @param[in] est    the entropy estimator
+ * @param[out] err   an error structure
+ * @return the block entropy for the ensemble
+ */
+EXPORT double inform_block_entropy_est(int const *series, size_t n, size_t m,
+    int b, size_t k, inform_estimator est, inform_error *err);
+
 /**
  * Compute the local block entropy of a ensemble of time series
  *
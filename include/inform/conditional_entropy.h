@@ -4,6 +4,7 @@
 #pragma once
 
 #include <inform/error.h>
+#include <inform/shannon.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -17,6 +18,14 @@ extern "C"
 EXPORT double inform_conditional_entropy(int const *xs, int const *ys,
     size_t n, int bx, int by, inform_error *err);
 
+/**
+ * Estimate the conditional entropy between two timeseries, using the first
+ * as the condition, with the bias of the estimate corrected by the given
+ * estimator.
+ */
+EXPORT double inform_conditional_entropy_est(int const *xs, int const *ys,
+    size_t n, int bx, int by, inform_estimator est, inform_error *err);
+
 /**
  * Compute the local conditional entropy between two timeseries, using the
  * first as the condition.
@@ -0,0 +1,70 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/export.h>
+#include <inform/pool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * The kinds of histogram with which an estimator may count observations.
+ *
+ * Dense histograms have a cell for every possible state, e.g. `b^(k+1)` for
+ * the active information, and are the fastest to fill. Sparse histograms
+ * sort the encoded observations and count the runs of equal states, so they
+ * use memory in proportion to the number of observations, however large the
+ * state space.
+ */
+typedef enum
+{
+    INFORM_HISTOGRAM_AUTO   = 0, /// dense, falling back to sparse if over budget or too large to index
+    INFORM_HISTOGRAM_DENSE  = 1, /// dense only
+    INFORM_HISTOGRAM_SPARSE = 2, /// sparse only
+} inform_histogram;
+
+/**
+ * The extent to which an estimator validates its inputs.
+ */
+typedef enum
+{
+    INFORM_VALIDATE_FULL = 0, /// check the arguments and every state of the time series
+    INFORM_VALIDATE_ARGS = 1, /// check the arguments, but trust the states of the time series
+} inform_validation;
+
+/**
+ * The resources and algorithms an estimator may use, accepted by the `_ex`
+ * variants of the estimators. A `NULL` configuration is equivalent to that
+ * of `inform_config_default`.
+ */
+typedef struct inform_config
+{
+    /// the pool on which to run, or `NULL` for the default pool
+    inform_pool *pool;
+    /// the greatest number of the pool's threads to use, or zero for all of them
+    size_t threads;
+    /// the greatest number of bytes to allocate for histograms, or zero for no limit
+    size_t memory;
+    /// the kind of histogram to use
+    inform_histogram histogram;
+    /// the extent of input validation
+    inform_validation validation;
+} inform_config;
+
+/**
+ * The default configuration: every thread of the default pool, no memory
+ * limit, dense histograms falling back to sparse ones when they cannot be
+ * indexed, and full validation.
+ *
+ * @return the default configuration
+ */
+EXPORT inform_config inform_config_default(void);
+
+#ifdef __cplusplus
+}
+#endif
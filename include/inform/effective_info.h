@@ -4,6 +4,7 @@
 #pragma once
 
 #include <inform/error.h>
+#include <inform/utilities/tpm.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -24,6 +25,92 @@ extern "C"
 EXPORT double inform_effective_info(double const *tpm, double const *inter,
     size_t n, inform_error *err);
 
+/**
+ * Compute the effective information of an intervention for a transition
+ * probability matrix in compressed sparse row form.
+ *
+ * Only the non-zero entries of the matrix are visited, so the cost is
+ * proportional to their number rather than to the square of the number of
+ * states, and the rows are divided among threads for large matrices. The
+ * matrix must be square, with the entries of each row summing to one.
+ *
+ * A row may be empty if the corresponding state was never observed, e.g. a
+ * history which never occurs in the data from which `inform_tpm_k` estimated
+ * the matrix, provided that the intervention gives that state no weight. If
+ * the provided intervention is @c NULL, the uniform distribution over the
+ * states with non-empty rows is assumed.
+ *
+ * @param[in] tpm   the sparse transition probability matrix
+ * @param[in] inter the intervention distribution
+ * @return the effective information of the intervention
+ */
+EXPORT double inform_effective_info_sparse(inform_sparse_tpm const *tpm,
+    double const *inter, inform_error *err);
+
+/**
+ * Compute the effective information of each of a batch of interventions for
+ * a given transition probability matrix.
+ *
+ * The interventions are the `k` rows of the `k x n` row-major matrix
+ * `inters`. The entropy of each row of the TPM is computed only once, and the
+ * effect distributions are computed together as a cache-blocked product of
+ * the interventions with the TPM, with blocks of interventions distributed
+ * across threads. This is much faster than `k` calls to
+ * `inform_effective_info`.
+ *
+ * If `ei` is `NULL`, an array of `k` doubles is allocated.
+ *
+ * @param[in] tpm    the transition probability matrix
+ * @param[in] inters the intervention distributions
+ * @param[in] n      the number of states in the system
+ * @param[in] k      the number of interventions
+ * @param[out] ei    the effective information of each intervention
+ * @param[out] err   an error code
+ * @return the effective information of each intervention
+ */
+EXPORT double *inform_effective_info_batch(double const *tpm,
+    double const *inters, size_t n, size_t k, double *ei, inform_error *err);
+
+/**
+ * Search the coarse-grainings of a system of `l` variables for causal
+ * emergence, the largest gain in effective information of a macroscale over
+ * the microscale.
+ *
+ * The rows of the sparse micro TPM are the joint states of the variables,
+ * encoded as by `inform_black_box` with the first variable most significant,
+ * so that the matrix has `b[0] * ... * b[l-1]` rows. Each partition of the
+ * variables is a candidate macroscale, in which each block of variables is
+ * replaced by a single macro variable whose state is the sum of its members'
+ * states. The macro TPM of each candidate is aggregated directly from the
+ * micro TPM as by `inform_tpm_coarse_grain`, without constructing it, and its
+ * effective information under a uniform intervention over the macro states
+ * which are ever observed is compared with that of the micro TPM, as computed
+ * by `inform_effective_info_sparse` with a `NULL` intervention.
+ *
+ * Every partition is considered, but candidates are evaluated in parallel and
+ * any whose number of macro states is too small for it to improve upon the
+ * best found so far is pruned without being evaluated, which makes an
+ * exhaustive search of systems of a dozen or so variables feasible.
+ *
+ * If `parts` is not `NULL`, the partition of the best macroscale is written
+ * to it in the format of `inform_next_partitioning`; the finest partition is
+ * written if no coarse-graining improves upon the microscale, and ties are
+ * broken in favor of the first in that order. If `groups` is not `NULL`, the
+ * macro state of each micro state is written to it, for use with
+ * `inform_tpm_coarse_grain`.
+ *
+ * @param[in] tpm     the sparse micro transition probability matrix
+ * @param[in] l       the number of micro variables
+ * @param[in] b       the base of each micro variable
+ * @param[out] parts  the `l` block indices of the best partition (or `NULL`)
+ * @param[out] groups the macro state of each micro state (or `NULL`)
+ * @param[out] err    an error code
+ * @return the causal emergence, i.e. the effective information of the best
+ *         macroscale less that of the microscale
+ */
+EXPORT double inform_causal_emergence(inform_sparse_tpm const *tpm, size_t l,
+    int const *b, size_t *parts, size_t *groups, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,7 +3,9 @@
 // license that can be found in the LICENSE file.
 #pragma once
 
+#include <inform/config.h>
 #include <inform/error.h>
+#include <inform/shannon.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -24,6 +26,45 @@ extern "C"
 EXPORT double inform_entropy_rate(int const *series, size_t n, size_t m, int b,
     size_t k, inform_error *err);
 
+/**
+ * Estimate the entropy rate of an ensemble of time series, with the bias of
+ * the estimate corrected by the given estimator
+ *
+ * @param[in] series the ensemble of time series
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the history length used to calculate the entropy rate
+ * @param[in] est    the entropy estimator
+ * @param[out] err   an error structure
+ * @return the entropy rate for the ensemble
+ */
+EXPORT double inform_entropy_rate_est(int const *series, size_t n, size_t m,
+    int b, size_t k, inform_estimator est, inform_error *err);
+
+/**
+ * Estimate the entropy rate of an ensemble of time series as does
+ * `inform_entropy_rate_est`, within the limits of a configuration.
+ *
+ * The dense histograms have `b^(k+1) + b^k` cells. If they would exceed the
+ * configuration's memory budget, or are too large to index, sparse histograms
+ * are used instead if the configuration allows, needing `24` bytes per
+ * observation, and `INFORM_EBUDGET` is reported otherwise.
+ *
+ * @param[in] series the ensemble of time series
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the history length used to calculate the entropy rate
+ * @param[in] est    the entropy estimator
+ * @param[in] config the configuration (or `NULL` for the default)
+ * @param[out] err   an error structure
+ * @return the entropy rate for the ensemble
+ */
+EXPORT double inform_entropy_rate_ex(int const *series, size_t n, size_t m,
+    int b, size_t k, inform_estimator est, inform_config const *config,
+    inform_error *err);
+
 /**
  * Compute the local entropy rate of an ensemble of time series
  *
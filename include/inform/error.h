@@ -38,6 +38,7 @@ typedef enum
     INFORM_ETPMROW      = 17, /// all zero row in transition probability matrix
     INFORM_ESIZE        = 18, /// invalid size,
     INFORM_EPARTS       = 19, /// invalid partitioning
+    INFORM_EBUDGET      = 20, /// allocation would exceed the memory budget
 } inform_error;
 
 /// set an error as pointed to by ERR
@@ -3,6 +3,7 @@
 // license that can be found in the LICENSE file.
 #pragma once
 
+#include <inform/config.h>
 #include <inform/dist.h>
 #include <inform/error.h>
 #include <inform/utilities.h>
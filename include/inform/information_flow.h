@@ -29,6 +29,54 @@ EXPORT double inform_information_flow(int const *src, int const *dst,
     int const *back, size_t l_src, size_t l_dst, size_t l_back, size_t n,
     size_t m, int b, inform_error *err);
 
+/**
+ * A generator of interventional samples for
+ * `inform_information_flow_generated`.
+ *
+ * The generator writes up to `n` samples of each variable, each variable's
+ * samples contiguous and `n` elements apart as in a batch of time series:
+ * sample `i` of source variable `k` is `src[k*n + i]`, and likewise for the
+ * destination and background variables. `back` is `NULL` if there are no
+ * background variables. It returns the number of samples written, fewer
+ * than `n` (e.g. zero) once there are no more.
+ *
+ * @param[out] src     the samples of the source variables
+ * @param[out] dst     the samples of the destination variables
+ * @param[out] back    the samples of the background variables
+ * @param[in] n        the greatest number of samples to write
+ * @param[in] context  the user-provided context
+ * @return the number of samples written
+ */
+typedef size_t (*inform_flow_generator)(int *src, int *dst, int *back,
+    size_t n, void *context);
+
+/**
+ * Compute the information flow from one collection of variables to another,
+ * requesting the interventional samples from a generator rather than reading
+ * them from memory.
+ *
+ * Samples are requested in batches and accumulated into histograms as they
+ * arrive, so the memory used is bounded by the size of the histograms, not
+ * by the number of samples. While one batch is accumulated, the generator
+ * fills the next on another thread. The generator is never called
+ * concurrently with itself, but need not be called on the calling thread.
+ *
+ * The histograms count in 32 bits, so at most `UINT32_MAX` samples may be
+ * generated; `INFORM_ESIZE` is reported if the generator provides more.
+ *
+ * @param[in] generate the sample generator
+ * @param[in] context  a context passed to each call of the generator
+ * @param[in] l_src    the number of source variables
+ * @param[in] l_dst    the number of destination variables
+ * @param[in] l_back   the number of background variables
+ * @param[in] b        the base or number of distinct states of each variable
+ * @param[out] err     an error structure
+ * @return the information flow
+ */
+EXPORT double inform_information_flow_generated(inform_flow_generator generate,
+    void *context, size_t l_src, size_t l_dst, size_t l_back, int b,
+    inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,7 +3,10 @@
 // license that can be found in the LICENSE file.
 #pragma once
 
+#include <inform/config.h>
 #include <inform/error.h>
+#include <inform/shannon.h>
+#include <inform/utilities/view.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -23,6 +26,21 @@ extern "C"
 EXPORT double inform_mutual_info(int const *series, size_t l, size_t n,
     int const *b, inform_error *err);
 
+/**
+ * Estimate the mutual information between time series, with the bias of the
+ * estimate corrected by the given estimator
+ *
+ * @param[in] series the time series
+ * @param[in] l      the number of time series
+ * @param[in] n      the number of elements per time series
+ * @param[in] b      the base of each time series
+ * @param[in] est    the entropy estimator
+ * @param[in] err    an error code
+ * @return the mutual information between the time series
+ */
+EXPORT double inform_mutual_info_est(int const *series, size_t l, size_t n,
+    int const *b, inform_estimator est, inform_error *err);
+
 /**
  * Compute the pointwise mutual information between time series
  *
@@ -37,6 +55,97 @@ EXPORT double inform_mutual_info(int const *series, size_t l, size_t n,
 EXPORT double *inform_local_mutual_info(int const *series, size_t l, size_t n,
     int const *b, double *mi, inform_error *err);
 
+/**
+ * Compute the mutual information between time series read in place through
+ * a strided view. The initial condition stride of the view is unused.
+ *
+ * @param[in] series the view of the time series
+ * @param[in] l      the number of time series
+ * @param[in] n      the number of elements per time series
+ * @param[in] b      the base of each time series
+ * @param[in] err    an error code
+ * @return the mutual information between the time series
+ */
+EXPORT double inform_mutual_info_view(inform_view series, size_t l, size_t n,
+    int const *b, inform_error *err);
+
+/**
+ * Compute the pointwise mutual information between time series read in place
+ * through a strided view.
+ *
+ * @param[in] series the view of the time series
+ * @param[in] l      the number of time series
+ * @param[in] n      the number of elements per time series
+ * @param[in] b      the base of each time series
+ * @param[out] mi    the pointwise mutual information
+ * @param[in] err    an error code
+ * @return the pointwise mutual information between the time series
+ */
+EXPORT double *inform_local_mutual_info_view(inform_view series, size_t l,
+    size_t n, int const *b, double *mi, inform_error *err);
+
+/**
+ * Compute the mutual information between every pair of time series.
+ *
+ * The result is the symmetric `l x l` matrix, in row-major order, whose
+ * `(i,j)` entry is the mutual information between series `i` and `j`; the
+ * diagonal holds the entropy of each series. Each marginal is histogrammed
+ * once, and the pairs are distributed across threads in cache-sized tiles.
+ * Only the bases of each pair, not of all `l` series, need have a joint
+ * support representable as an `int`.
+ *
+ * If `mi` is `NULL`, an array of `l * l` doubles is allocated.
+ *
+ * @param[in] series the time series
+ * @param[in] l      the number of time series
+ * @param[in] n      the number of elements per time series
+ * @param[in] b      the base of each time series
+ * @param[out] mi    the pairwise mutual information
+ * @param[in] err    an error code
+ * @return the pairwise mutual information between the time series
+ */
+EXPORT double *inform_mutual_info_matrix(int const *series, size_t l,
+    size_t n, int const *b, double *mi, inform_error *err);
+
+/**
+ * Compute the mutual information between every pair of time series as does
+ * `inform_mutual_info_matrix`, within the limits of a configuration.
+ *
+ * Each tile of pairs in progress holds its own dense joint histograms, so no
+ * more tiles run at once than the configuration's threads and memory budget
+ * allow; `INFORM_EBUDGET` is reported if not even one fits. The pairwise
+ * histograms are always dense, so sparse histograms are rejected with
+ * `INFORM_EARG`.
+ *
+ * @param[in] series the time series
+ * @param[in] l      the number of time series
+ * @param[in] n      the number of elements per time series
+ * @param[in] b      the base of each time series
+ * @param[out] mi    the pairwise mutual information
+ * @param[in] config the configuration (or `NULL` for the default)
+ * @param[in] err    an error code
+ * @return the pairwise mutual information between the time series
+ */
+EXPORT double *inform_mutual_info_matrix_ex(int const *series, size_t l,
+    size_t n, int const *b, double *mi, inform_config const *config,
+    inform_error *err);
+
+/**
+ * Compute the mutual information between every pair of time series read in
+ * place through a strided view. The initial condition stride of the view is
+ * unused.
+ *
+ * @param[in] series the view of the time series
+ * @param[in] l      the number of time series
+ * @param[in] n      the number of elements per time series
+ * @param[in] b      the base of each time series
+ * @param[out] mi    the pairwise mutual information
+ * @param[in] err    an error code
+ * @return the pairwise mutual information between the time series
+ */
+EXPORT double *inform_mutual_info_matrix_view(inform_view series, size_t l,
+    size_t n, int const *b, double *mi, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,6 +33,180 @@ EXPORT void inform_pid_lattice_free(inform_pid_lattice *l);
 EXPORT inform_pid_lattice *inform_pid(int const *stimulus, int const *responses, size_t l,
         size_t n, int bs, int const *br, inform_error *err);
 
+/**
+ * A partial information decomposition over a redundancy lattice in a flat,
+ * pointer-free form.
+ *
+ * The nodes are indexed from the bottom of the lattice, `0`, to the top,
+ * `size - 1`, in the same topological order as the `sources` of an
+ * `inform_pid_lattice`. The name of node `i` is the antichain `names[j]` for
+ * `j` in `[name_offsets[i], name_offsets[i+1])`, each element of which is a
+ * subset of the responses encoded as a bitmask, so that response `k` is a
+ * member of the subset `x` if `x & (1 << k)` is non-zero. The indices of the
+ * nodes which cover node `i` are stored likewise in `above` and
+ * `above_offsets`, and those which it covers in `below` and `below_offsets`.
+ *
+ * The structure of the lattice depends only on the number of responses, and
+ * is shared by every decomposition with that many; it must not be modified.
+ */
+typedef struct inform_pid_flat_lattice
+{
+    /// the number of nodes
+    size_t size;
+    /// the `size + 1` offsets of each node's name in `names`
+    size_t const *name_offsets;
+    /// the subsets of responses in each node's name, as bitmasks
+    size_t const *names;
+    /// the `size + 1` offsets of each node's covers in `above`
+    size_t const *above_offsets;
+    /// the indices of the nodes which cover each node
+    size_t const *above;
+    /// the `size + 1` offsets of each node's covered nodes in `below`
+    size_t const *below_offsets;
+    /// the indices of the nodes which each node covers
+    size_t const *below;
+    /// the redundancy of each node
+    double *imin;
+    /// the partial information of each node
+    double *pi;
+} inform_pid_flat_lattice;
+
+/**
+ * The redundancy measures with which a partial information decomposition can
+ * be computed.
+ */
+typedef enum
+{
+    INFORM_PID_IMIN  = 0, /// the minimum specific information of Williams and Beer (2010)
+    INFORM_PID_CCS   = 1, /// the common change in surprisal of Ince (2017)
+    INFORM_PID_BROJA = 2, /// the measure of Bertschinger et al. (2014), for pairs of responses
+} inform_pid_measure;
+
+/**
+ * Free a flat partial information decomposition.
+ *
+ * @param[in] l the decomposition
+ */
+EXPORT void inform_pid_flat_lattice_free(inform_pid_flat_lattice *l);
+
+/**
+ * Compute the partial information decomposition of the information about a
+ * stimulus provided by a collection of responses, as does `inform_pid`, but
+ * returning the decomposition in flat form.
+ *
+ * The lattice is not copied, so only the `imin` and `pi` arrays are
+ * allocated with the result.
+ *
+ * @param[in] stimulus  the stimulus time series
+ * @param[in] responses the `l` response time series, one after another
+ * @param[in] l         the number of responses
+ * @param[in] n         the number of time steps
+ * @param[in] bs        the base of the stimulus
+ * @param[in] br        the base of each response
+ * @param[out] err      an error code
+ * @return the decomposition, or `NULL` on error
+ */
+EXPORT inform_pid_flat_lattice *inform_pid_flat(int const *stimulus,
+        int const *responses, size_t l, size_t n, int bs, int const *br,
+        inform_error *err);
+
+/**
+ * Compute the partial information decomposition of the information about a
+ * stimulus provided by a collection of responses in flat form, as does
+ * `inform_pid_flat`, but with the given redundancy measure.
+ *
+ * The redundancy of each node is written to `imin`, whichever the measure.
+ * The partial information of each node is its redundancy less the partial
+ * information of every node below it. The measures other than
+ * `INFORM_PID_IMIN` are computed from the joint distribution of the stimulus
+ * and each node's subsets of responses, so the product of the stimulus' base
+ * and the sizes of the joint supports of those subsets may not exceed
+ * `INT_MAX`. `INFORM_PID_BROJA` is only defined for two responses.
+ *
+ * @param[in] stimulus  the stimulus time series
+ * @param[in] responses the `l` response time series, one after another
+ * @param[in] l         the number of responses
+ * @param[in] n         the number of time steps
+ * @param[in] bs        the base of the stimulus
+ * @param[in] br        the base of each response
+ * @param[in] measure   the redundancy measure
+ * @param[out] err      an error code
+ * @return the decomposition, or `NULL` on error
+ */
+EXPORT inform_pid_flat_lattice *inform_pid_flat_measure(int const *stimulus,
+        int const *responses, size_t l, size_t n, int bs, int const *br,
+        inform_pid_measure measure, inform_error *err);
+
+/**
+ * The number of nodes in the redundancy lattice of `l` responses, i.e. the
+ * number of partial information atoms in a decomposition.
+ *
+ * @param[in] l    the number of responses
+ * @param[out] err an error code
+ * @return the number of nodes, or zero on error
+ */
+EXPORT size_t inform_pid_lattice_size(size_t l, inform_error *err);
+
+/**
+ * Compute the partial information decomposition of the information about a
+ * single stimulus provided by each of many tuples of responses.
+ *
+ * The `nresponses` response time series are laid out one after another, and
+ * tuple `i` consists of the `l` responses `tuples[i*l]` through
+ * `tuples[i*l + l - 1]`. The stimulus distribution and the lattice are
+ * computed once and shared by every tuple, and the tuples are decomposed in
+ * parallel.
+ *
+ * Row `i` of the `ntuples x inform_pid_lattice_size(l)` row-major table `pi`
+ * holds the partial information of each node of the lattice for tuple `i`,
+ * in the order of the nodes of `inform_pid_flat`, so that the first column
+ * is the redundancy and the last is the synergy. For pairs of responses the
+ * columns are the redundancy, the unique information of each response and
+ * the synergy. If `pi` is `NULL`, the table is allocated.
+ *
+ * @param[in] stimulus   the stimulus time series
+ * @param[in] responses  the response time series, one after another
+ * @param[in] nresponses the number of response time series
+ * @param[in] n          the number of time steps
+ * @param[in] bs         the base of the stimulus
+ * @param[in] br         the base of each response
+ * @param[in] tuples     the `l` response indices of each tuple
+ * @param[in] l          the number of responses in each tuple
+ * @param[in] ntuples    the number of tuples
+ * @param[out] pi        the partial information table (or `NULL`)
+ * @param[out] err       an error code
+ * @return the partial information table, or `NULL` on error
+ */
+EXPORT double *inform_pid_batch(int const *stimulus, int const *responses,
+        size_t nresponses, size_t n, int bs, int const *br,
+        size_t const *tuples, size_t l, size_t ntuples, double *pi,
+        inform_error *err);
+
+/**
+ * Compute the partial information decomposition of the information about a
+ * single stimulus provided by each of many tuples of responses, as does
+ * `inform_pid_batch`, but with the given redundancy measure, as described
+ * for `inform_pid_flat_measure`.
+ *
+ * @param[in] stimulus   the stimulus time series
+ * @param[in] responses  the response time series, one after another
+ * @param[in] nresponses the number of response time series
+ * @param[in] n          the number of time steps
+ * @param[in] bs         the base of the stimulus
+ * @param[in] br         the base of each response
+ * @param[in] tuples     the `l` response indices of each tuple
+ * @param[in] l          the number of responses in each tuple
+ * @param[in] ntuples    the number of tuples
+ * @param[in] measure    the redundancy measure
+ * @param[out] pi        the partial information table (or `NULL`)
+ * @param[out] err       an error code
+ * @return the partial information table, or `NULL` on error
+ */
+EXPORT double *inform_pid_batch_measure(int const *stimulus,
+        int const *responses, size_t nresponses, size_t n, int bs,
+        int const *br, size_t const *tuples, size_t l, size_t ntuples,
+        inform_pid_measure measure, double *pi, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,98 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/error.h>
+#include <inform/export.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * A pool of threads on which the parallel estimators run their tasks.
+ *
+ * Every parallel estimator submits its tasks to a pool rather than starting
+ * threads of its own, so that concurrent calls share the pool's threads
+ * rather than oversubscribing the processors. Within each call, the tasks
+ * are divided among the threads, and threads which run out of tasks steal
+ * from the others. A parallel estimator called from within a task of a pool,
+ * e.g. by a user-supplied generator, runs serially on the calling thread.
+ *
+ * Unless told otherwise, the estimators use a pool shared by the whole
+ * library, with a thread per processor, which is started on first use.
+ */
+typedef struct inform_pool inform_pool;
+
+/**
+ * A function by which a host application runs `run(arg)` on one of the
+ * threads of its own pool, at its leisure.
+ *
+ * @param[in] run  the function to run
+ * @param[in] arg  the argument to pass to `run`
+ * @param[in] host the host's context, as given to `inform_pool_alloc_shared`
+ */
+typedef void (*inform_pool_submit)(void (*run)(void *arg), void *arg,
+    void *host);
+
+/**
+ * Allocate a pool of `nthreads` threads, including the thread which submits
+ * the tasks, so that `nthreads - 1` threads are started.
+ *
+ * @param[in] nthreads the number of threads, or zero for one per processor
+ * @param[out] err     the error code
+ * @return the pool, or `NULL` on error
+ */
+EXPORT inform_pool *inform_pool_alloc(size_t nthreads, inform_error *err);
+
+/**
+ * Allocate a pool which starts no threads of its own, but borrows up to
+ * `nthreads - 1` threads of the host application's pool for each parallel
+ * call through `submit`.
+ *
+ * The estimators never wait for a submitted function to start, so the host
+ * may run it whenever it likes, even after the estimator has returned, when
+ * it simply returns. However, the host must run every function it is given
+ * before the pool is freed.
+ *
+ * @param[in] nthreads the greatest number of threads to use, including the
+ *                     calling thread, or zero for one per processor
+ * @param[in] submit   the host's submission function
+ * @param[in] host     the host's context, passed to `submit`
+ * @param[out] err     the error code
+ * @return the pool, or `NULL` on error
+ */
+EXPORT inform_pool *inform_pool_alloc_shared(size_t nthreads,
+    inform_pool_submit submit, void *host, inform_error *err);
+
+/**
+ * Free a pool, waiting for its threads to exit, or for the host to run the
+ * functions submitted to it. The pool must not be in use. If the pool is
+ * the default, the library's own pool becomes the default again.
+ *
+ * @param[in] pool the pool
+ */
+EXPORT void inform_pool_free(inform_pool *pool);
+
+/**
+ * Get the number of threads in a pool, including the calling thread.
+ *
+ * @param[in] pool the pool, or `NULL` for the default pool
+ * @return the number of threads
+ */
+EXPORT size_t inform_pool_size(inform_pool const *pool);
+
+/**
+ * Set the pool used by estimators which are not given one. This must not be
+ * called while any estimator is running.
+ *
+ * @param[in] pool the pool, or `NULL` for the library's own pool
+ */
+EXPORT void inform_pool_set_default(inform_pool *pool);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <inform/error.h>
+#include <inform/shannon.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -25,6 +26,24 @@ extern "C"
 EXPORT double inform_predictive_info(int const *series, size_t n, size_t m,
     int b, size_t kpast, size_t kfuture, inform_error *err);
 
+/**
+ * Estimate the predictive information of an ensemble of time series, with the
+ * bias of the estimate corrected by the given estimator
+ *
+ * @param[in] series  the ensemble of time series
+ * @param[in] n       the number of initial conditions
+ * @param[in] m       the number of time steps in each time series
+ * @param[in] b       the base or number of distinct states at each time step
+ * @param[in] kpast   the history length
+ * @param[in] kfuture the future length
+ * @param[in] est     the entropy estimator
+ * @param[out] err    an error structure
+ * @return the predictive information for the ensemble
+ */
+EXPORT double inform_predictive_info_est(int const *series, size_t n, size_t m,
+    int b, size_t kpast, size_t kfuture, inform_estimator est,
+    inform_error *err);
+
 /**
  * Compute the local predictive information of a ensemble of time series
  *
@@ -11,6 +11,23 @@ extern "C"
 {
 #endif
 
+/**
+ * The estimators of entropy from a histogram of observations.
+ *
+ * The plug-in estimate, which treats the observed frequencies as the true
+ * probabilities, is biased downward by roughly `(K-1)/2N` nats for a support
+ * of `K` states and `N` observations. The other estimators correct for this
+ * bias analytically, which is often far cheaper than correcting for it with
+ * surrogate data.
+ */
+typedef enum
+{
+    INFORM_PLUGIN       = 0, /// the maximum likelihood (plug-in) estimate
+    INFORM_MILLER_MADOW = 1, /// the plug-in estimate with the Miller-Madow correction
+    INFORM_GRASSBERGER  = 2, /// Grassberger's (2003) digamma-based estimator
+    INFORM_NSB          = 3, /// the Nemenman-Shafee-Bialek Bayesian estimator
+} inform_estimator;
+
 /**
  * Compute the Shannon self-information of an event given some distribution
  *
@@ -196,6 +213,82 @@ EXPORT double inform_shannon_multi_pmi(inform_dist const *joint,
 EXPORT double inform_shannon_multi_mi(inform_dist const *joint,
     inform_dist const **marginals, size_t n, double base);
 
+/**
+ * Estimate the Shannon information of a distribution with a given estimator.
+ *
+ * The Miller-Madow and Grassberger estimators depend only on the observed
+ * counts; the NSB estimator also uses the size of the distribution's support,
+ * which should be the number of states the variable can take.
+ *
+ * This function will return `NaN` if the distribution is not valid or the
+ * estimator is not recognized.
+ *
+ * @param[in] dist the probability distribution
+ * @param[in] base the logarithmic base
+ * @param[in] est  the estimator
+ * @return the estimated shannon information
+ */
+EXPORT double inform_shannon_entropy_est(inform_dist const *dist, double base,
+    inform_estimator est);
+
+/**
+ * Estimate the mutual information of a distribution and two marginals, with
+ * each entropy computed by a given estimator.
+ *
+ * @param[in] joint      the joint probability distribution
+ * @param[in] marginal_x a marginal distribution
+ * @param[in] marginal_y a marginal distribution
+ * @param[in] base       the logarithmic base
+ * @param[in] est        the estimator
+ * @return the estimated mutual information
+ */
+EXPORT double inform_shannon_mi_est(inform_dist const *joint,
+    inform_dist const *marginal_x, inform_dist const *marginal_y, double base,
+    inform_estimator est);
+
+/**
+ * Estimate the conditional entropy of a joint distribution and a marginal,
+ * with each entropy computed by a given estimator.
+ *
+ * @param[in] joint    the joint probability distribution
+ * @param[in] marginal a marginal distribution
+ * @param[in] base     the logarithmic base
+ * @param[in] est      the estimator
+ * @return the estimated conditional entropy
+ */
+EXPORT double inform_shannon_ce_est(inform_dist const *joint,
+    inform_dist const *marginal, double base, inform_estimator est);
+
+/**
+ * Estimate the conditional mutual information of a joint distribution and the
+ * xz-, yz- and z-marginals, with each entropy computed by a given estimator.
+ *
+ * @param[in] joint       the joint probability distribution
+ * @param[in] marginal_xz the xz-marginal
+ * @param[in] marginal_yz the yz-marginal
+ * @param[in] marginal_z  the z-marginal
+ * @param[in] base        the logarithmic base
+ * @param[in] est         the estimator
+ * @return the estimated conditional mutual information
+ */
+EXPORT double inform_shannon_cmi_est(inform_dist const *joint,
+    inform_dist const *marginal_xz, inform_dist const *marginal_yz,
+    inform_dist const *marginal_z, double base, inform_estimator est);
+
+/**
+ * Estimate the multivariate mutual information between a collection of
+ * distributions, with each entropy computed by a given estimator.
+ *
+ * @param[in] joint     the joint distribution
+ * @param[in] marginals an array of marginal distributions
+ * @param[in] n         the number of marginals
+ * @param[in] base      the logarithmic base
+ * @param[in] est       the estimator
+ * @return the estimated multivariate mutual information
+ */
+EXPORT double inform_shannon_multi_mi_est(inform_dist const *joint,
+    inform_dist const **marginals, size_t n, double base, inform_estimator est);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,7 +3,10 @@
 // license that can be found in the LICENSE file.
 #pragma once
 
+#include <inform/config.h>
 #include <inform/error.h>
+#include <inform/shannon.h>
+#include <inform/utilities/view.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -28,6 +31,51 @@ EXPORT double inform_transfer_entropy(int const *src, int const *dst,
     int const *back, size_t l, size_t n, size_t m, int b, size_t k,
     inform_error *err);
 
+/**
+ * Estimate the transfer entropy from one time series to another, with the
+ * bias of the estimate corrected by the given estimator
+ *
+ * @param[in] src  the ensemble of the source node
+ * @param[in] dst  the ensemble of the target node
+ * @param[in] back the collection of background nodes
+ * @param[in] l    the number of background nodes
+ * @param[in] n    the number initial conditions
+ * @param[in] m    the number of time steps in each time series
+ * @param[in] b    the base or number of distinct states at each time step
+ * @param[in] k    the history length used to calculate the transfer entropy
+ * @param[in] est  the entropy estimator
+ * @param[out] err an error structure
+ * @return the transfer entropy of the ensemble
+ */
+EXPORT double inform_transfer_entropy_est(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k,
+    inform_estimator est, inform_error *err);
+
+/**
+ * Estimate the transfer entropy from one time series to another as does
+ * `inform_transfer_entropy_est`, within the limits of a configuration.
+ *
+ * The dense histograms have `b^(k+l+2) + 2b^(k+l+1) + b^(k+l)` cells. If they would exceed the configuration's memory budget, sparse
+ * histograms are used instead if the configuration allows, needing `40` bytes
+ * per observation, and `INFORM_EBUDGET` is reported otherwise.
+ *
+ * @param[in] src    the ensemble of the source node
+ * @param[in] dst    the ensemble of the target node
+ * @param[in] back   the collection of background nodes
+ * @param[in] l      the number of background nodes
+ * @param[in] n      the number initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base or number of distinct states at each time step
+ * @param[in] k      the history length used to calculate the transfer entropy
+ * @param[in] est    the entropy estimator
+ * @param[in] config the configuration (or `NULL` for the default)
+ * @param[out] err   an error structure
+ * @return the transfer entropy of the ensemble
+ */
+EXPORT double inform_transfer_entropy_ex(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k,
+    inform_estimator est, inform_config const *config, inform_error *err);
+
 /**
  * Compute the local transfer entropy from one time series to another
  *
@@ -47,6 +95,161 @@ EXPORT double *inform_local_transfer_entropy(int const *src, int const *dst,
     int const *back, size_t l, size_t n, size_t m, int b, size_t k, double *te,
     inform_error *err);
 
+/**
+ * Compute the transfer entropy from one time series to another using a
+ * delay embedding of both the source and the destination.
+ *
+ * The destination's future state at time `t` is conditioned on the `k`
+ * destination states `dst[t-1], dst[t-1-k_tau], ..., dst[t-1-(k-1)*k_tau]`,
+ * and the source contributes the `h` states `src[t-u], src[t-u-h_tau], ...,
+ * src[t-u-(h-1)*h_tau]`. Calling this function with `k_tau = h = h_tau = u = 1`
+ * is equivalent to calling `inform_transfer_entropy`.
+ *
+ * @param[in] src   the ensemble of the source node
+ * @param[in] dst   the ensemble of the destination node
+ * @param[in] back  the collection of background nodes
+ * @param[in] l     the number of background nodes
+ * @param[in] n     the number initial conditions
+ * @param[in] m     the number of time steps in each time series
+ * @param[in] b     the base or number of distinct states at each time step
+ * @param[in] k     the destination history length
+ * @param[in] k_tau the delay between destination history samples
+ * @param[in] h     the source history length
+ * @param[in] h_tau the delay between source history samples
+ * @param[in] u     the delay from the source to the destination
+ * @param[out] err  an error structure
+ * @return the transfer entropy of the ensemble
+ */
+EXPORT double inform_transfer_entropy_embed(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k,
+    size_t k_tau, size_t h, size_t h_tau, size_t u, inform_error *err);
+
+/**
+ * Compute the local transfer entropy from one time series to another using a
+ * delay embedding of both the source and the destination.
+ *
+ * The output contains `n * (m - t0)` values, where `t0` is the larger of
+ * `(k-1)*k_tau + 1` and `(h-1)*h_tau + u`.
+ *
+ * @param[in] src   the ensemble of the source node
+ * @param[in] dst   the ensemble of the destination node
+ * @param[in] back  the collection of background nodes
+ * @param[in] l     the number of background nodes
+ * @param[in] n     the number initial conditions
+ * @param[in] m     the number of time steps in each time series
+ * @param[in] b     the base or number of distinct states at each time step
+ * @param[in] k     the destination history length
+ * @param[in] k_tau the delay between destination history samples
+ * @param[in] h     the source history length
+ * @param[in] h_tau the delay between source history samples
+ * @param[in] u     the delay from the source to the destination
+ * @param[out] te   the transfer entropy
+ * @param[out] err  an error structure
+ * @return a pointer to the transfer entropy array
+ */
+EXPORT double *inform_local_transfer_entropy_embed(int const *src,
+    int const *dst, int const *back, size_t l, size_t n, size_t m, int b,
+    size_t k, size_t k_tau, size_t h, size_t h_tau, size_t u, double *te,
+    inform_error *err);
+
+/**
+ * Compute the transfer entropy from one time series to another, conditioned
+ * on any number of background processes, reading each in place through a
+ * strided view. Variable `v` of `back` is the `v`-th background process.
+ *
+ * @param[in] src  a view of the source time series
+ * @param[in] dst  a view of the destination time series
+ * @param[in] back a view of the background time series
+ * @param[in] l    the number of background time series
+ * @param[in] n    the number of initial conditions
+ * @param[in] m    the number of time steps in each initial condition
+ * @param[in] b    the base of the time series
+ * @param[in] k    the history length
+ * @param[out] err an error code
+ * @return the transfer entropy
+ */
+EXPORT double inform_transfer_entropy_view(inform_view src, inform_view dst,
+    inform_view back, size_t l, size_t n, size_t m, int b, size_t k,
+    inform_error *err);
+
+/**
+ * Compute the local transfer entropy from one time series to another,
+ * conditioned on any number of background processes, reading each in place
+ * through a strided view.
+ *
+ * @param[in] src  a view of the source time series
+ * @param[in] dst  a view of the destination time series
+ * @param[in] back a view of the background time series
+ * @param[in] l    the number of background time series
+ * @param[in] n    the number of initial conditions
+ * @param[in] m    the number of time steps in each initial condition
+ * @param[in] b    the base of the time series
+ * @param[in] k    the history length
+ * @param[out] te  the local transfer entropy
+ * @param[out] err an error code
+ * @return the local transfer entropy
+ */
+EXPORT double *inform_local_transfer_entropy_view(inform_view src,
+    inform_view dst, inform_view back, size_t l, size_t n, size_t m, int b,
+    size_t k, double *te, inform_error *err);
+
+/**
+ * Compute the transfer entropy from one time series to another at each of a
+ * collection of source-destination delays.
+ *
+ * The destination history and its histograms are constructed once and shared
+ * by every delay; only the source-dependent histograms are accumulated per
+ * delay, and the delays are evaluated in parallel. So that the results are
+ * comparable, every delay is evaluated over the same time steps, namely
+ * those `t` for which `t >= k` and `t >= u` for every delay `u`.
+ *
+ * @param[in] src   the ensemble of the source node
+ * @param[in] dst   the ensemble of the destination node
+ * @param[in] back  the collection of background nodes
+ * @param[in] l     the number of background nodes
+ * @param[in] n     the number initial conditions
+ * @param[in] m     the number of time steps in each time series
+ * @param[in] b     the base or number of distinct states at each time step
+ * @param[in] k     the history length used to calculate the transfer entropy
+ * @param[in] lags  the source-destination delays, each at least 1
+ * @param[in] nlags the number of delays
+ * @param[out] te   the transfer entropy at each delay (or NULL)
+ * @param[out] err  an error structure
+ * @return a pointer to the transfer entropy array
+ */
+EXPORT double *inform_transfer_entropy_lags(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k,
+    size_t const *lags, size_t nlags, double *te, inform_error *err);
+
+/**
+ * Compute the local transfer entropy from each of a collection of sources to
+ * a single destination, conditioned on any number of background processes.
+ *
+ * The `nsrcs` sources are laid out one after another, each an ensemble of
+ * `n` initial conditions of `m` time steps. The destination history and its
+ * histograms are constructed once and shared by every source; only the
+ * source-dependent histograms are accumulated per source, and the sources are
+ * evaluated in parallel. The local transfer entropy from source `i` is row
+ * `i` of the `nsrcs x n(m - k)` row-major matrix `te`, which is allocated if
+ * `te` is `NULL`. Each row is that given by `inform_local_transfer_entropy`.
+ *
+ * @param[in] srcs  the ensembles of the source nodes
+ * @param[in] dst   the ensemble of the destination node
+ * @param[in] back  the collection of background nodes
+ * @param[in] nsrcs the number of source nodes
+ * @param[in] l     the number of background nodes
+ * @param[in] n     the number initial conditions
+ * @param[in] m     the number of time steps in each time series
+ * @param[in] b     the base or number of distinct states at each time step
+ * @param[in] k     the history length used to calculate the transfer entropy
+ * @param[out] te   the local transfer entropy from each source (or NULL)
+ * @param[out] err  an error structure
+ * @return a pointer to the local transfer entropy matrix
+ */
+EXPORT double *inform_local_transfer_entropy_sources(int const *srcs,
+    int const *dst, int const *back, size_t nsrcs, size_t l, size_t n,
+    size_t m, int b, size_t k, double *te, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
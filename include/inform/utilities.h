@@ -8,8 +8,10 @@
 #include <inform/utilities/coalesce.h>
 #include <inform/utilities/encoding.h>
 #include <inform/utilities/partitions.h>
+#include <inform/utilities/quantiles.h>
 #include <inform/utilities/random.h>
 #include <inform/utilities/tpm.h>
+#include <inform/utilities/view.h>
 
 #ifndef MIN
 #define MIN(X,Y) ((X) < (Y)) ? (X) : (Y)
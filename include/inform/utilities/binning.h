@@ -36,6 +36,23 @@ EXPORT double inform_range(double const *series, size_t n, double *min,
 EXPORT double inform_bin(double const *series, size_t n, int b, int *binned,
     inform_error *err);
 
+/**
+ * Bin a continuously-valued timeseries, whose values are known to lie within
+ * `[min, max]`, into `b` uniform bins. Unlike `inform_bin`, the timeseries is
+ * not scanned for its range.
+ *
+ * @param[in] series  the timeseries
+ * @param[in] n       the length of the timeseries
+ * @param[in] min     the lower bound of the values in the timeseries
+ * @param[in] max     the upper bound of the values in the timeseries
+ * @param[in] b       the desired number of bins
+ * @param[out] binned the resulting binned timeseries
+ * @param[out] err    the error code
+ * @return the size of each bin
+ */
+EXPORT double inform_bin_range(double const *series, size_t n, double min,
+    double max, int b, int *binned, inform_error *err);
+
 /**
  * Bin a continuously-valued timeseries into bins of uniform size `step`.
  *
@@ -51,6 +68,8 @@ EXPORT int inform_bin_step(double const *series, size_t n, double step,
 
 /**
  * Bin a continuously-valued timeseries into bins with specified boundaries.
+ * Each value is placed in the bin of the first boundary that it is less than.
+ * Sorted boundaries are searched in logarithmic time.
  *
  * @param[in] series  the timeseries
  * @param[in] n       the length of the timeseries
@@ -22,6 +22,23 @@ extern "C"
 EXPORT int inform_coalesce(int const *series, size_t n, int *coal,
     inform_error *err);
 
+/**
+ * Coalesce `l` timeseries of length `n`, stored one after another, each
+ * independently of the others.
+ *
+ * If `b` is `NULL`, an array of `l` integers is allocated to store the bases.
+ *
+ * @param[in] series  the timeseries
+ * @param[in] l       the number of timeseries
+ * @param[in] n       the length of each timeseries
+ * @param[out] coal   the resulting coalesced timeseries
+ * @param[out] b      the number of unique states in each timeseries
+ * @param[out] err    the error code
+ * @return the number of unique states in each timeseries
+ */
+EXPORT int *inform_coalesce_columns(int const *series, size_t l, size_t n,
+    int *coal, int *b, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -35,6 +35,61 @@ EXPORT int32_t inform_encode(int const *state, size_t n, int b,
 EXPORT void inform_decode(int32_t encoding, int b, int *state, size_t n,
     inform_error *err);
 
+/**
+ * Encode a mixed-base array of integers into a single 64-bit integer. The
+ * first term is the most significant.
+ * @param[in] state the state to encode
+ * @param[in] n     the number of terms in `state`
+ * @param[in] b     the base of each term
+ * @param[out] err  the error code
+ * @return the encoded state (0 on error)
+ */
+EXPORT uint64_t inform_encode_mixed(int const *state, size_t n, int const *b,
+    inform_error *err);
+
+/**
+ * Decode a 64-bit integer into a mixed-base array of integers.
+ * @param[in] encoding the encoded state
+ * @param[in] b        the base of each term
+ * @param[out] state   the decoded state
+ * @param[in] n        the number of terms
+ * @param[out] err     the error code
+ */
+EXPORT void inform_decode_mixed(uint64_t encoding, int const *b, int *state,
+    size_t n, inform_error *err);
+
+/**
+ * Encode `l` time series of `N` samples each into a single time series. The
+ * time series are stored one after another in `series`, i.e. the `j`-th
+ * sample of the `i`-th time series is `series[j + N*i]`, and the first is the
+ * most significant. The product of the bases must not exceed `INT_MAX`.
+ * The function allocates the encoded series if `codes` is `NULL`.
+ * @param[in] series  the time series
+ * @param[in] l       the number of time series
+ * @param[in] N       the number of samples in each time series
+ * @param[in] b       the base of each time series
+ * @param[in,out] codes the encoded time series (or NULL)
+ * @param[out] err    the error code
+ * @return the encoded time series
+ */
+EXPORT int *inform_encode_series(int const *series, size_t l, size_t N,
+    int const *b, int *codes, inform_error *err);
+
+/**
+ * Encode `l` time series of `N` samples each into a single time series of
+ * 64-bit codes, as with `inform_encode_series`. The product of the bases must
+ * not exceed `UINT64_MAX`.
+ * @param[in] series  the time series
+ * @param[in] l       the number of time series
+ * @param[in] N       the number of samples in each time series
+ * @param[in] b       the base of each time series
+ * @param[in,out] codes the encoded time series (or NULL)
+ * @param[out] err    the error code
+ * @return the encoded time series
+ */
+EXPORT uint64_t *inform_encode_series64(int const *series, size_t l, size_t N,
+    int const *b, uint64_t *codes, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,6 +30,25 @@ EXPORT size_t *inform_first_partitioning(size_t size);
  */
 EXPORT size_t inform_next_partitioning(size_t *xs, size_t size);
 
+/**
+ * Compute the next partition in place, reporting which blocks changed
+ *
+ * The partitions are visited in the same order as `inform_next_partitioning`,
+ * in which consecutive partitions usually differ by only a variable or two.
+ * The blocks whose membership differs from the previous partition are
+ * written to `changed`, so that anything computed from a block, such as its
+ * encoded time series, need only be recomputed for those. A block numbered at
+ * least the returned number of partitions has become empty.
+ *
+ * @param[in,out] xs    the current partition
+ * @param[in] size      the number of elements
+ * @param[out] changed  the blocks which changed (room for `size` blocks)
+ * @param[out] nchanged the number of blocks which changed
+ * @return the number of partitions, or 0 if there are no more
+ */
+EXPORT size_t inform_next_partitioning_changes(size_t *xs, size_t size,
+    size_t *changed, size_t *nchanged);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,139 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/error.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * A streaming quantile sketch of a continuously-valued timeseries.
+ *
+ * The sketch is a hierarchy of compactors: level `h` holds values which each
+ * stand for `2^h` observations. Once the sketch is full, the lowest level
+ * over capacity is sorted and every other value is promoted to the next
+ * level. The sketch is exact until it has seen more than `k` observations;
+ * thereafter the rank error is roughly proportional to `1/k`, and the memory
+ * used grows only logarithmically with the number of observations.
+ */
+typedef struct inform_sketch
+{
+    /// the values held at each level
+    double **levels;
+    /// the number of values held at each level
+    size_t *sizes;
+    /// the number of values allocated at each level
+    size_t *allocated;
+    /// the number of levels
+    size_t height;
+    /// the capacity of the highest level
+    size_t k;
+    /// the number of values held in the sketch
+    size_t size;
+    /// the number of values the sketch holds before it is compacted
+    size_t capacity;
+    /// the number of observations added to the sketch
+    uint64_t count;
+    /// the state of the generator used to choose which values are promoted
+    uint64_t state;
+} inform_sketch;
+
+/**
+ * Allocate an empty quantile sketch with accuracy parameter `k`.
+ *
+ * @param[in] k    the capacity of the highest level, at least 8
+ * @param[out] err the error code
+ * @return the sketch, or `NULL` on error
+ */
+EXPORT inform_sketch *inform_sketch_alloc(size_t k, inform_error *err);
+
+/**
+ * Free a quantile sketch.
+ *
+ * @param[in] sketch the sketch
+ */
+EXPORT void inform_sketch_free(inform_sketch *sketch);
+
+/**
+ * Add the values of a continuously-valued timeseries to a sketch. A
+ * timeseries may be added in as many pieces as are convenient.
+ *
+ * @param[in,out] sketch the sketch
+ * @param[in] series     the timeseries
+ * @param[in] n          the length of the timeseries
+ * @param[out] err       the error code
+ */
+EXPORT void inform_sketch_add(inform_sketch *sketch, double const *series,
+    size_t n, inform_error *err);
+
+/**
+ * Estimate the boundaries of `b` equal-frequency bins from a sketch. The
+ * `j`-th boundary approximates the value of rank `ceil(j*n/b)` among the `n`
+ * observations.
+ *
+ * If `bounds` is `NULL`, an array of `b - 1` doubles is allocated.
+ *
+ * @param[in] sketch  the sketch
+ * @param[in] b       the desired number of bins
+ * @param[out] bounds the `b - 1` bin boundaries
+ * @param[out] err    the error code
+ * @return the bin boundaries
+ */
+EXPORT double *inform_sketch_bounds(inform_sketch const *sketch, int b,
+    double *bounds, inform_error *err);
+
+/**
+ * Compute the exact boundaries of `b` equal-frequency bins of a
+ * continuously-valued timeseries. The `j`-th boundary is the value of rank
+ * `ceil(j*n/b)`. The ranks are found by selection on a copy of the timeseries
+ * rather than by sorting it.
+ *
+ * If `bounds` is `NULL`, an array of `b - 1` doubles is allocated.
+ *
+ * @param[in] series  the timeseries
+ * @param[in] n       the length of the timeseries
+ * @param[in] b       the desired number of bins
+ * @param[out] bounds the `b - 1` bin boundaries
+ * @param[out] err    the error code
+ * @return the bin boundaries
+ */
+EXPORT double *inform_quantile_bounds(double const *series, size_t n, int b,
+    double *bounds, inform_error *err);
+
+/**
+ * Bin a continuously-valued timeseries into `b` bins of (as near as ties
+ * allow) equal frequency.
+ *
+ * @param[in] series  the timeseries
+ * @param[in] n       the length of the timeseries
+ * @param[in] b       the desired number of bins
+ * @param[out] binned the resulting binned timeseries
+ * @param[out] err    the error code
+ * @return the number of bins
+ */
+EXPORT int inform_bin_quantiles(double const *series, size_t n, int b,
+    int *binned, inform_error *err);
+
+/**
+ * Bin a continuously-valued timeseries into `b` bins of approximately equal
+ * frequency, estimating the boundaries with a sketch of accuracy `k`.
+ *
+ * @param[in] series  the timeseries
+ * @param[in] n       the length of the timeseries
+ * @param[in] b       the desired number of bins
+ * @param[in] k       the accuracy parameter of the sketch, at least 8
+ * @param[out] binned the resulting binned timeseries
+ * @param[out] err    the error code
+ * @return the number of bins
+ */
+EXPORT int inform_bin_quantiles_approx(double const *series, size_t n, int b,
+    size_t k, int *binned, inform_error *err);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,6 +4,8 @@
 #pragma once
 
 #include <inform/error.h>
+#include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -27,6 +29,120 @@ extern "C"
 EXPORT double *inform_tpm(int const *series, size_t n, size_t m, int b,
     double *tpm, inform_error *err);
 
+/**
+ * A transition probability matrix in compressed sparse row (CSR) form.
+ *
+ * Only the non-zero transition probabilities are stored. The entries of row
+ * `i` are `values[offsets[i]]` through `values[offsets[i+1] - 1]`, and the
+ * columns to which they belong are the corresponding elements of `indices`,
+ * in increasing order.
+ */
+typedef struct inform_sparse_tpm
+{
+    /// the number of rows, i.e. of current states
+    size_t rows;
+    /// the number of columns, i.e. of future states
+    size_t cols;
+    /// the number of non-zero entries
+    size_t nnz;
+    /// the `rows + 1` offsets of each row's entries
+    size_t *offsets;
+    /// the column of each entry
+    size_t *indices;
+    /// the transition probability of each entry
+    double *values;
+} inform_sparse_tpm;
+
+/**
+ * Allocate a sparse transition probability matrix with room for `nnz`
+ * entries. The offsets are zeroed, and the indices and values are left
+ * uninitialized.
+ *
+ * @param[in] rows the number of rows
+ * @param[in] cols the number of columns
+ * @param[in] nnz  the number of non-zero entries
+ * @param[out] err an error code
+ * @return the matrix, or `NULL` on error
+ */
+EXPORT inform_sparse_tpm *inform_sparse_tpm_alloc(size_t rows, size_t cols,
+    size_t nnz, inform_error *err);
+
+/**
+ * Free a sparse transition probability matrix.
+ *
+ * @param[in] tpm the matrix
+ */
+EXPORT void inform_sparse_tpm_free(inform_sparse_tpm *tpm);
+
+/**
+ * Compute a sparse transition probability matrix from a time series.
+ *
+ * Unlike `inform_tpm`, the memory used is proportional to the number of
+ * observed transitions rather than to `b * b`, so that systems with very
+ * many states can be analyzed. As with `inform_tpm`, `err` is set to
+ * `INFORM_ETPMROW` if some state is never followed by another, but the
+ * matrix is still returned.
+ *
+ * @param[in] series the timeseries
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps for each initial condition
+ * @param[in] b      the base of the time series
+ * @param[out] err   an error code
+ * @return the sparse transition probability matrix, or `NULL` on error
+ */
+EXPORT inform_sparse_tpm *inform_tpm_sparse(int const *series, size_t n,
+    size_t m, int b, inform_error *err);
+
+/**
+ * Compute the sparse transition probability matrix of the order-`k` Markov
+ * chain underlying a time series.
+ *
+ * The states of the chain are the histories of length `k`, each encoded as a
+ * base-`b` number with the oldest state most significant, so that there are
+ * `b^k` rows and columns. A history can only be followed by the `b` histories
+ * which shift in a new state, so each row holds at most `b` entries. The
+ * transitions are accumulated from rolling history codes, and the memory used
+ * is proportional to `b^k` plus the number of observed transitions rather than
+ * to `b^(k+1)`. Histories which are never observed have empty rows, in which
+ * case `err` is set to `INFORM_ETPMROW` but the matrix is still returned.
+ *
+ * When `k = 1` this is equivalent to `inform_tpm_sparse`. If `normalize` is
+ * false, the values are the raw transition counts rather than probabilities.
+ *
+ * @param[in] series    the timeseries
+ * @param[in] n         the number of initial conditions
+ * @param[in] m         the number of time steps for each initial condition
+ * @param[in] b         the base of the time series
+ * @param[in] k         the history length
+ * @param[in] normalize whether to normalize each row into probabilities
+ * @param[out] err      an error code
+ * @return the sparse transition matrix, or `NULL` on error
+ */
+EXPORT inform_sparse_tpm *inform_tpm_k(int const *series, size_t n, size_t m,
+    int b, size_t k, bool normalize, inform_error *err);
+
+/**
+ * Coarse-grain a sparse transition probability matrix by grouping its states.
+ *
+ * The coarse states are the `ngroups` groups, and state `i` belongs to group
+ * `groups[i]`. Each row of the coarse matrix is the average of the non-empty
+ * rows of the group's members, with the columns of each aggregated by group,
+ * i.e. the transition probabilities of the group under a uniform distribution
+ * over those of its members which are ever observed. The coarse matrix is
+ * derived directly from the fine one, so no time series need be black boxed
+ * and re-estimated. A group none of whose members have non-empty rows has an
+ * empty row, in which case `err` is set to `INFORM_ETPMROW` but the matrix is
+ * still returned.
+ *
+ * @param[in] tpm     the sparse transition probability matrix
+ * @param[in] groups  the group of each state
+ * @param[in] ngroups the number of groups
+ * @param[out] err    an error code
+ * @return the coarse-grained matrix, or `NULL` on error
+ */
+EXPORT inform_sparse_tpm *inform_tpm_coarse_grain(inform_sparse_tpm const *tpm,
+    size_t const *groups, size_t ngroups, inform_error *err);
+
 #ifdef __cplusplus
 }
 #endif
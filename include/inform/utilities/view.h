@@ -0,0 +1,65 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/export.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * A read-only, strided view of a collection of time series.
+ *
+ * The sample of variable `v`, initial condition `i` and time step `t` is
+ *
+ *     data[v * var_stride + i * init_stride + t * time_stride]
+ *
+ * so that data stored in any order, e.g. a column-major (time by node)
+ * matrix, can be analyzed in place without first being transposed into the
+ * contiguous layout the other functions expect. Strides are measured in
+ * elements and may be negative.
+ */
+typedef struct inform_view
+{
+    /// the first sample of the first initial condition of the first variable
+    int const *data;
+    /// the distance between successive time steps
+    ptrdiff_t time_stride;
+    /// the distance between successive initial conditions
+    ptrdiff_t init_stride;
+    /// the distance between successive variables
+    ptrdiff_t var_stride;
+} inform_view;
+
+/**
+ * Construct a view of time series in the contiguous layout used throughout
+ * the library: variables one after another, each with `n` initial conditions
+ * of `m` time steps.
+ *
+ * @param[in] series the time series
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps in each initial condition
+ * @return the view
+ */
+EXPORT inform_view inform_view_contiguous(int const *series, size_t n,
+    size_t m);
+
+/**
+ * Construct a view of time series with arbitrary strides.
+ *
+ * @param[in] data        the first sample
+ * @param[in] time_stride the distance between successive time steps
+ * @param[in] init_stride the distance between successive initial conditions
+ * @param[in] var_stride  the distance between successive variables
+ * @return the view
+ */
+EXPORT inform_view inform_view_strided(int const *data, ptrdiff_t time_stride,
+    ptrdiff_t init_stride, ptrdiff_t var_stride);
+
+#ifdef __cplusplus
+}
+#endif
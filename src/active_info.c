@@ -5,6 +5,10 @@
 #include <inform/shannon.h>
 #include <string.h>
 
+#include "encoder.h"
+#include "estimator.h"
+#include "histogram.h"
+
 static void accumulate_observations(int const* series, size_t n, size_t m,
     int b, size_t k, inform_dist *states, inform_dist *histories,
     inform_dist *futures)
@@ -67,7 +71,7 @@ static void accumulate_local_observations(int const* series, size_t n, size_t m,
 }
 
 static bool check_arguments(int const *series, size_t n, size_t m, int b,
-    size_t k, inform_error *err)
+    size_t k, inform_validation validation, inform_error *err)
 {
     if (series == NULL)
     {
@@ -93,7 +97,7 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b,
     {
         INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
     }
-    for (size_t i = 0; i < n * m; ++i)
+    for (size_t i = 0; validation == INFORM_VALIDATE_FULL && i < n * m; ++i)
     {
         if (series[i] < 0)
         {
@@ -107,13 +111,85 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b,
     return false;
 }
 
-double inform_active_info(int const *series, size_t n, size_t m, int b,
-    size_t k, inform_error *err)
+/*
+ * Compute the active information from sparse histograms, counting the runs of
+ * sorted history-future codes.
+ */
+static double sparse_active_info(int const *series, size_t n, size_t m,
+    int b, size_t k, inform_estimator est, inform_error *err)
+{
+    size_t const N = n * (m - k);
+
+    uint64_t *codes = malloc(2 * N * sizeof(uint64_t));
+    uint32_t *counts = calloc(2 * N + b, sizeof(uint32_t));
+    if (codes == NULL || counts == NULL)
+    {
+        free(counts);
+        free(codes);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    inform_histogram_histories(series, n, m, b, k, codes);
+    inform_dist futures = { counts + 2 * N, (size_t) b, N };
+    for (size_t i = 0; i < N; ++i)
+    {
+        futures.histogram[codes[i] % b]++;
+    }
+    inform_histogram_sort(codes, codes + N, N);
+    inform_dist const states = inform_histogram_runs(codes, N, 1, counts);
+    inform_dist const histories = inform_histogram_runs(codes, N, b,
+        counts + N);
+
+    double const ai = inform_shannon_mi_est(&states, &histories, &futures,
+        2.0, est);
+
+    free(counts);
+    free(codes);
+
+    return ai;
+}
+
+static double active_info(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_estimator est, inform_config const *config,
+    inform_error *err)
 {
-    if (check_arguments(series, n, m, b, k, err)) return NAN;
+    if (check_arguments(series, n, m, b, k, config->validation, err))
+    {
+        return NAN;
+    }
+    if (!inform_estimator_is_valid(est))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NAN);
+    }
 
     size_t const N = n * (m - k);
 
+    uint64_t cells = 1;
+    if (inform_encoder_extend(&cells, b, k + 1, INT_MAX))
+    {
+        cells += cells / b + b;
+    }
+    else
+    {
+        cells = 0;
+    }
+    uint64_t const sparse = 2 * N * sizeof(uint64_t)
+        + (2 * N + b) * sizeof(uint32_t);
+    bool dense;
+    if (inform_histogram_choose(config, cells, sparse, est, &dense, err))
+    {
+        return NAN;
+    }
+    else if (!dense)
+    {
+        uint64_t states = 1;
+        if (!inform_encoder_extend(&states, b, k + 1, UINT64_MAX))
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EENCODE, NAN);
+        }
+        return sparse_active_info(series, n, m, b, k, est, err);
+    }
+
     size_t const states_size = (size_t) (b * pow((double) b,(double) k));
     size_t const histories_size = states_size / b;
     size_t const futures_size = b;
@@ -131,6 +207,14 @@ double inform_active_info(int const *series, size_t n, size_t m, int b,
 
     accumulate_observations(series, n, m, b, k, &states, &histories, &futures);
 
+    if (est != INFORM_PLUGIN)
+    {
+        double const ai = inform_shannon_mi_est(&states, &histories, &futures,
+            2.0, est);
+        free(data);
+        return ai;
+    }
+
     double ai = 0.0;
     int state;
     double n_state, n_history, n_future;
@@ -163,10 +247,36 @@ double inform_active_info(int const *series, size_t n, size_t m, int b,
     return ai / N;
 }
 
+double inform_active_info(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_error *err)
+{
+    inform_config const config = inform_config_default();
+    return active_info(series, n, m, b, k, INFORM_PLUGIN, &config, err);
+}
+
+double inform_active_info_est(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_estimator est, inform_error *err)
+{
+    inform_config const config = inform_config_default();
+    return active_info(series, n, m, b, k, est, &config, err);
+}
+
+double inform_active_info_ex(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_estimator est, inform_config const *config,
+    inform_error *err)
+{
+    inform_config resolved;
+    if (inform_config_resolve(config, &resolved, err)) return NAN;
+    return active_info(series, n, m, b, k, est, &resolved, err);
+}
+
 double *inform_local_active_info(int const *series, size_t n, size_t m, int b,
     size_t k, double *ai, inform_error *err)
 {
-    if (check_arguments(series, n, m, b, k, err)) return NULL;
+    if (check_arguments(series, n, m, b, k, INFORM_VALIDATE_FULL, err))
+    {
+        return NULL;
+    }
 
     size_t const N = n * (m - k);
 
@@ -4,6 +4,8 @@
 #include <inform/block_entropy.h>
 #include <inform/shannon.h>
 
+#include "estimator.h"
+
 static void accumulate_observations(int const* series, size_t n, size_t m,
     int b, size_t k, inform_dist *states)
 {
@@ -95,10 +97,14 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b,
     return false;
 }
 
-double inform_block_entropy(int const *series, size_t n, size_t m, int b,
-    size_t k, inform_error *err)
+static double block_entropy(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_estimator est, inform_error *err)
 {
     if (check_arguments(series, n, m, b, k, err)) return NAN;
+    if (!inform_estimator_is_valid(est))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NAN);
+    }
 
     size_t const states_size = (size_t) pow((double) b, (double) k);
 
@@ -114,13 +120,25 @@ double inform_block_entropy(int const *series, size_t n, size_t m, int b,
 
     accumulate_observations(series, n, m, b, k, &states);
 
-    double be = inform_shannon_entropy(&states, 2.0);
+    double be = inform_shannon_entropy_est(&states, 2.0, est);
 
     free(data);
 
     return be;
 }
 
+double inform_block_entropy(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_error *err)
+{
+    return block_entropy(series, n, m, b, k, INFORM_PLUGIN, err);
+}
+
+double inform_block_entropy_est(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_estimator est, inform_error *err)
+{
+    return block_entropy(series, n, m, b, k, est, err);
+}
+
 double *inform_local_block_entropy(int const *series, size_t n, size_t m, int b,
     size_t k, double *be, inform_error *err)
 {
@@ -4,6 +4,8 @@
 #include <inform/conditional_entropy.h>
 #include <inform/shannon.h>
 
+#include "estimator.h"
+
 static bool check_arguments(int const *xs, int const *ys, size_t n, int bx,
     int by, inform_error *err)
 {
@@ -75,23 +77,39 @@ inline static void free_all(inform_dist **x, inform_dist **xy)
     inform_dist_free(*xy);
 }
 
-double inform_conditional_entropy(int const *xs, int const *ys, size_t n,
-    int bx, int by, inform_error *err)
+static double conditional_entropy(int const *xs, int const *ys, size_t n,
+    int bx, int by, inform_estimator est, inform_error *err)
 {
     if (check_arguments(xs, ys, n, bx, by, err)) return NAN;
+    if (!inform_estimator_is_valid(est))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NAN);
+    }
 
     inform_dist *x = NULL, *xy = NULL;
     if (allocate(bx, by, &x, &xy, err)) return NAN;
 
     accumulate(xs, ys, n, by, x, xy);
 
-    double ce = inform_shannon_ce(xy, x, 2.0);
+    double ce = inform_shannon_ce_est(xy, x, 2.0, est);
 
     free_all(&x, &xy);
 
     return ce;
 }
 
+double inform_conditional_entropy(int const *xs, int const *ys, size_t n,
+    int bx, int by, inform_error *err)
+{
+    return conditional_entropy(xs, ys, n, bx, by, INFORM_PLUGIN, err);
+}
+
+double inform_conditional_entropy_est(int const *xs, int const *ys, size_t n,
+    int bx, int by, inform_estimator est, inform_error *err)
+{
+    return conditional_entropy(xs, ys, n, bx, by, est, err);
+}
+
 double *inform_local_conditional_entropy(int const *xs, int const *ys,
     size_t n, int bx, int by, double *ce, inform_error *err)
 {
@@ -3,7 +3,11 @@
 // license that can be found in the LICENSE file.
 #include <inform/dist.h>
 #include <inform/effective_info.h>
+#include <inform/utilities/partitions.h>
 #include <math.h>
+#include <string.h>
+
+#include "parallel.h"
 
 static inline double sum_row(double const *row, size_t n)
 {
@@ -121,3 +125,760 @@ double inform_effective_info(double const *tpm, double const *inter, size_t n,
 
     return ei;
 }
+
+static int check_sparse_arguments(inform_sparse_tpm const *tpm,
+    double const *inter, inform_error *err)
+{
+    if (tpm == NULL || tpm->offsets == NULL || tpm->indices == NULL ||
+        tpm->values == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETPM, 1);
+    }
+    else if (tpm->rows == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, 1);
+    }
+    else if (tpm->rows != tpm->cols || tpm->offsets[0] != 0 ||
+        tpm->offsets[tpm->rows] != tpm->nnz)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETPM, 1);
+    }
+
+    for (size_t i = 0; i < tpm->rows; ++i)
+    {
+        size_t const lo = tpm->offsets[i], hi = tpm->offsets[i + 1];
+        if (hi < lo || tpm->nnz < hi)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ETPM, 1);
+        }
+        double sum = 0.0;
+        for (size_t j = lo; j < hi; ++j)
+        {
+            if (tpm->cols <= tpm->indices[j] ||
+                (j != lo && tpm->indices[j] <= tpm->indices[j - 1]) ||
+                tpm->values[j] < 0.0)
+            {
+                INFORM_ERROR_RETURN(err, INFORM_ETPM, 1);
+            }
+            sum += tpm->values[j];
+        }
+        // a state which is never observed has an empty row, which is only
+        // acceptable if the intervention never places the system in it
+        bool const unreachable = (lo == hi) && (inter == NULL || inter[i] == 0);
+        if (!unreachable && fabs(sum - 1.0) > 1e-6)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ETPM, 1);
+        }
+    }
+
+    if (inter != NULL)
+    {
+        double const sum = sum_row(inter, tpm->rows);
+        if (isnan(sum))
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EDIST, 1);
+        }
+        if (fabs(sum - 1.0) > 1e-6)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EDIST, 1);
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * The rows of a sparse TPM are split into one contiguous span per thread once
+ * it has SPARSE_EI_GRAIN entries. Each span accumulates its contribution to
+ * the effect distribution in a private buffer, and the buffers are summed in
+ * span order so that the result does not depend on the scheduling.
+ */
+#define SPARSE_EI_GRAIN (1 << 16)
+
+typedef struct sparse_ei
+{
+    inform_sparse_tpm const *tpm;
+    double const *id;
+    double const *ed;
+    double *partial_ed;
+    double *partial_ei;
+    size_t spans;
+} sparse_ei;
+
+inline static void span_of(sparse_ei const *job, size_t span, size_t *lo,
+    size_t *hi)
+{
+    size_t const rows = job->tpm->rows;
+    *lo = (rows * span) / job->spans;
+    *hi = (rows * (span + 1)) / job->spans;
+}
+
+static void sparse_effect(size_t span, void *context)
+{
+    sparse_ei const *job = context;
+    inform_sparse_tpm const *tpm = job->tpm;
+    double *ed = job->partial_ed + span * tpm->cols;
+    size_t lo, hi;
+    span_of(job, span, &lo, &hi);
+    for (size_t i = lo; i < hi; ++i)
+    {
+        double const p = job->id[i];
+        for (size_t j = tpm->offsets[i]; j < tpm->offsets[i + 1]; ++j)
+        {
+            ed[tpm->indices[j]] += p * tpm->values[j];
+        }
+    }
+}
+
+static void sparse_divergence(size_t span, void *context)
+{
+    sparse_ei const *job = context;
+    inform_sparse_tpm const *tpm = job->tpm;
+    size_t lo, hi;
+    span_of(job, span, &lo, &hi);
+    double ei = 0.0;
+    for (size_t i = lo; i < hi; ++i)
+    {
+        double kld = 0.0;
+        for (size_t j = tpm->offsets[i]; j < tpm->offsets[i + 1]; ++j)
+        {
+            double const p = tpm->values[j];
+            if (p != 0)
+            {
+                kld += p * log2(p / job->ed[tpm->indices[j]]);
+            }
+        }
+        ei += job->id[i] * kld;
+    }
+    job->partial_ei[span] = ei;
+}
+
+double inform_effective_info_sparse(inform_sparse_tpm const *tpm,
+    double const *inter, inform_error *err)
+{
+    if (check_sparse_arguments(tpm, inter, err))
+    {
+        return NAN;
+    }
+
+    size_t const n = tpm->rows;
+    bool const parallel = (tpm->nnz >= SPARSE_EI_GRAIN);
+    size_t spans = parallel ? inform_parallel_threads() : 1;
+    spans = (spans < n) ? spans : n;
+
+    // the uniform intervention, and a partial effect distribution per span
+    // followed by a partial effective information per span
+    double *data = calloc((inter == NULL ? n : 0) + spans * (n + 1),
+        sizeof(double));
+    if (data == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    double const *id = inter;
+    double *partial_ed = data;
+    if (inter == NULL)
+    {
+        size_t occupied = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            occupied += (tpm->offsets[i + 1] != tpm->offsets[i]);
+        }
+        if (occupied == 0)
+        {
+            free(data);
+            INFORM_ERROR_RETURN(err, INFORM_ETPM, NAN);
+        }
+        double const k = 1.0 / occupied;
+        for (size_t i = 0; i < n; ++i)
+        {
+            data[i] = (tpm->offsets[i + 1] != tpm->offsets[i]) ? k : 0.0;
+        }
+        id = data;
+        partial_ed += n;
+    }
+    double *partial_ei = partial_ed + spans * n;
+
+    sparse_ei job = { tpm, id, partial_ed, partial_ed, partial_ei, spans };
+    if (spans > 1)
+    {
+        inform_parallel_for(spans, sparse_effect, &job);
+        for (size_t s = 1; s < spans; ++s)
+        {
+            double const *ed = partial_ed + s * n;
+            for (size_t j = 0; j < n; ++j) partial_ed[j] += ed[j];
+        }
+        inform_parallel_for(spans, sparse_divergence, &job);
+    }
+    else
+    {
+        sparse_effect(0, &job);
+        sparse_divergence(0, &job);
+    }
+
+    double ei = 0.0;
+    for (size_t s = 0; s < spans; ++s)
+    {
+        ei += partial_ei[s];
+    }
+
+    free(data);
+
+    return ei;
+}
+
+/*
+ * Effective information is the entropy of the effect distribution less the
+ * intervention-weighted entropies of the rows of the TPM,
+ *
+ *     EI(A, p) = H(p A) - sum_i p_i H(A_i),
+ *
+ * so for a batch of interventions the row entropies are computed once, and
+ * the effect distributions form the matrix product of the interventions with
+ * the TPM. The product is computed in tiles of EI_BATCH interventions by
+ * EI_INNER rows by EI_COLS columns of the TPM, one tile of interventions per
+ * task, so that each block of the TPM is reused from cache by every
+ * intervention in the tile.
+ */
+#define EI_BATCH 16
+#define EI_INNER 64
+#define EI_COLS 256
+#define EI_GRAIN (1 << 16)
+
+typedef struct ei_batch
+{
+    double const *tpm;
+    double const *inters;
+    double const *row_entropy;
+    size_t n, k;
+    double *ei;
+} ei_batch;
+
+static void effective_info_tile(size_t tile, void *context)
+{
+    ei_batch const *job = context;
+    size_t const n = job->n;
+    size_t const j0 = tile * EI_BATCH;
+    size_t const j1 = (j0 + EI_BATCH < job->k) ? j0 + EI_BATCH : job->k;
+
+    double *ed = calloc((j1 - j0) * n, sizeof(double));
+    if (ed == NULL)
+    {
+        for (size_t j = j0; j < j1; ++j) job->ei[j] = NAN;
+        return;
+    }
+
+    for (size_t l0 = 0; l0 < n; l0 += EI_COLS)
+    {
+        size_t const l1 = (l0 + EI_COLS < n) ? l0 + EI_COLS : n;
+        for (size_t i0 = 0; i0 < n; i0 += EI_INNER)
+        {
+            size_t const i1 = (i0 + EI_INNER < n) ? i0 + EI_INNER : n;
+            for (size_t j = j0; j < j1; ++j)
+            {
+                double const *id = job->inters + j * n;
+                double *e = ed + (j - j0) * n;
+                for (size_t i = i0; i < i1; ++i)
+                {
+                    double const p = id[i];
+                    if (p == 0.0) continue;
+                    double const *row = job->tpm + i * n;
+                    for (size_t l = l0; l < l1; ++l)
+                    {
+                        e[l] += p * row[l];
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t j = j0; j < j1; ++j)
+    {
+        double const *id = job->inters + j * n;
+        double const *e = ed + (j - j0) * n;
+        double ei = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            ei -= id[i] * job->row_entropy[i];
+            if (e[i] > 0.0)
+            {
+                ei -= e[i] * log2(e[i]);
+            }
+        }
+        job->ei[j] = ei;
+    }
+
+    free(ed);
+}
+
+double *inform_effective_info_batch(double const *tpm, double const *inters,
+    size_t n, size_t k, double *ei, inform_error *err)
+{
+    if (check_arguments(tpm, NULL, n, err))
+    {
+        return NULL;
+    }
+    else if (inters == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EDIST, NULL);
+    }
+    else if (k == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, NULL);
+    }
+    for (size_t j = 0; j < k; ++j)
+    {
+        double const sum = sum_row(inters + j * n, n);
+        if (isnan(sum) || fabs(sum - 1.0) > 1e-6)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EDIST, NULL);
+        }
+    }
+
+    bool const allocate_ei = (ei == NULL);
+    if (allocate_ei)
+    {
+        ei = malloc(k * sizeof(double));
+        if (ei == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    double *row_entropy = malloc(n * sizeof(double));
+    if (row_entropy == NULL)
+    {
+        if (allocate_ei) free(ei);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        double const *row = tpm + i * n;
+        double h = 0.0;
+        for (size_t l = 0; l < n; ++l)
+        {
+            if (row[l] > 0.0)
+            {
+                h -= row[l] * log2(row[l]);
+            }
+        }
+        row_entropy[i] = h;
+    }
+
+    ei_batch job = { tpm, inters, row_entropy, n, k, ei };
+    size_t const tiles = (k + EI_BATCH - 1) / EI_BATCH;
+    if (tiles > 1 && k * n * n >= EI_GRAIN)
+    {
+        inform_parallel_for(tiles, effective_info_tile, &job);
+    }
+    else
+    {
+        for (size_t t = 0; t < tiles; ++t) effective_info_tile(t, &job);
+    }
+
+    free(row_entropy);
+
+    for (size_t j = 0; j < k; ++j)
+    {
+        if (isnan(ei[j]))
+        {
+            if (allocate_ei) free(ei);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    return ei;
+}
+
+/*
+ * The search for causal emergence considers each partition of the micro
+ * variables, and coarse-grains each block of the partition into a single
+ * macro variable whose state is the sum of the states of its members, so
+ * that a block with bases `b_v` has `1 + sum_v (b_v - 1)` states. Since the
+ * sum is linear, the macro state of a micro state is
+ *
+ *     sum_v x_v w_v,
+ *
+ * where `w_v` is the place value of the block to which variable `v` belongs,
+ * and can be computed for every micro state by an odometer over the micro
+ * digits without decoding each state.
+ *
+ * Each candidate is evaluated directly from the micro TPM: the micro states
+ * are bucketed by macro state, and each macro row is accumulated from its
+ * members into a dense scratch row, touching only the non-zero entries. The
+ * effective information under a uniform intervention over the `K` occupied
+ * macro states is then
+ *
+ *     EI = H(ED) - (1/K) sum_I H(A_I),
+ *
+ * and it cannot exceed `log2(K)`, nor therefore `log2(M)` where `M` is the
+ * number of macro states. A candidate whose bound does not exceed the best
+ * effective information found so far is pruned, first by `M` before any work
+ * is done, and then by `K`.
+ *
+ * Partitions are generated in batches of CE_BATCH, and the candidates of a
+ * batch are evaluated CE_CHUNK at a time by separate tasks, pruning against
+ * the best effective information of the previous batches. The batch is then
+ * scanned in order, so that the result does not depend on the scheduling.
+ */
+#define CE_BATCH 4096
+#define CE_CHUNK 64
+#define CE_TOLERANCE 1e-12
+
+typedef struct ce_search
+{
+    inform_sparse_tpm const *tpm;
+    size_t l;
+    int const *b;
+    size_t const *parts;
+    size_t const *nparts;
+    size_t count;
+    double best;
+    double *ei;
+} ce_search;
+
+typedef struct ce_scratch
+{
+    size_t *weights;
+    size_t *radices;
+    int *digits;
+    size_t *map;
+    size_t *starts;
+    size_t *members;
+    size_t *touched;
+    double *acc;
+    double *ed;
+} ce_scratch;
+
+static void ce_scratch_free(ce_scratch *scratch)
+{
+    free(scratch->weights);
+    free(scratch->digits);
+    free(scratch->map);
+    free(scratch->starts);
+    free(scratch->touched);
+    free(scratch->acc);
+}
+
+static bool ce_scratch_alloc(ce_scratch *scratch, size_t l, size_t n)
+{
+    scratch->weights = malloc(2 * l * sizeof(size_t));
+    scratch->digits = malloc(l * sizeof(int));
+    scratch->map = malloc(n * sizeof(size_t));
+    scratch->starts = malloc((2 * n + 2) * sizeof(size_t));
+    scratch->touched = malloc(n * sizeof(size_t));
+    scratch->acc = calloc(2 * n, sizeof(double));
+    if (scratch->weights == NULL || scratch->digits == NULL ||
+        scratch->map == NULL || scratch->starts == NULL ||
+        scratch->touched == NULL || scratch->acc == NULL)
+    {
+        ce_scratch_free(scratch);
+        return false;
+    }
+    scratch->radices = scratch->weights + l;
+    scratch->members = scratch->starts + n + 1;
+    scratch->ed = scratch->acc + n;
+    return true;
+}
+
+/*
+ * Compute the effective information of the macro TPM induced by a partition
+ * of the micro variables, or -INFINITY if it cannot exceed `best`.
+ */
+static double macro_effective_info(ce_search const *search,
+    ce_scratch *scratch, size_t const *parts, size_t nparts, double best)
+{
+    inform_sparse_tpm const *tpm = search->tpm;
+    size_t const l = search->l, n = tpm->rows;
+    int const *b = search->b;
+
+    // the number of states of each block, and its place value
+    size_t *radices = scratch->radices;
+    for (size_t j = 0; j < nparts; ++j) radices[j] = 1;
+    for (size_t v = 0; v < l; ++v) radices[parts[v]] += b[v] - 1;
+    size_t m = 1;
+    for (size_t j = nparts; j > 0; --j)
+    {
+        size_t const r = radices[j - 1];
+        radices[j - 1] = m;
+        m *= r;
+    }
+    if (log2(m) <= best + CE_TOLERANCE)
+    {
+        return -INFINITY;
+    }
+
+    // map each micro state to its macro state, and bucket the micro states
+    // with non-empty rows by macro state
+    size_t *weights = scratch->weights, *map = scratch->map;
+    size_t *starts = scratch->starts, *members = scratch->members;
+    int *digits = scratch->digits;
+    for (size_t v = 0; v < l; ++v)
+    {
+        weights[v] = radices[parts[v]];
+        digits[v] = 0;
+    }
+    memset(starts, 0, (m + 1) * sizeof(size_t));
+    size_t macro = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        map[i] = macro;
+        starts[macro + 1] += (tpm->offsets[i] != tpm->offsets[i + 1]);
+        for (size_t v = l; v > 0; --v)
+        {
+            if (++digits[v - 1] < b[v - 1])
+            {
+                macro += weights[v - 1];
+                break;
+            }
+            digits[v - 1] = 0;
+            macro -= (size_t) (b[v - 1] - 1) * weights[v - 1];
+        }
+    }
+    size_t occupied = 0;
+    for (size_t I = 0; I < m; ++I)
+    {
+        occupied += (starts[I + 1] != 0);
+        starts[I + 1] += starts[I];
+    }
+    if (log2(occupied) <= best + CE_TOLERANCE)
+    {
+        return -INFINITY;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (tpm->offsets[i] != tpm->offsets[i + 1])
+        {
+            members[starts[map[i]]++] = i;
+        }
+    }
+
+    // accumulate each macro row, its entropy and its contribution to the
+    // effect distribution
+    double *acc = scratch->acc, *ed = scratch->ed;
+    size_t *touched = scratch->touched;
+    double row_entropy = 0.0;
+    size_t lo = 0;
+    for (size_t I = 0; I < m; ++I)
+    {
+        size_t const hi = starts[I];
+        if (hi == lo)
+        {
+            continue;
+        }
+        size_t ntouched = 0;
+        for (size_t k = lo; k < hi; ++k)
+        {
+            size_t const i = members[k];
+            for (size_t j = tpm->offsets[i]; j < tpm->offsets[i + 1]; ++j)
+            {
+                if (tpm->values[j] == 0.0) continue;
+                size_t const c = map[tpm->indices[j]];
+                if (acc[c] == 0.0)
+                {
+                    touched[ntouched++] = c;
+                }
+                acc[c] += tpm->values[j];
+            }
+        }
+        double const weight = 1.0 / (hi - lo);
+        for (size_t k = 0; k < ntouched; ++k)
+        {
+            double const p = acc[touched[k]] * weight;
+            row_entropy -= p * log2(p);
+            ed[touched[k]] += p;
+            acc[touched[k]] = 0.0;
+        }
+        lo = hi;
+    }
+
+    double const weight = 1.0 / occupied;
+    double ei = -row_entropy * weight;
+    for (size_t I = 0; I < m; ++I)
+    {
+        if (ed[I] > 0.0)
+        {
+            double const p = ed[I] * weight;
+            ei -= p * log2(p);
+            ed[I] = 0.0;
+        }
+    }
+    return ei;
+}
+
+static void causal_emergence_chunk(size_t chunk, void *context)
+{
+    ce_search const *search = context;
+    size_t const lo = chunk * CE_CHUNK;
+    size_t const hi = (lo + CE_CHUNK < search->count) ?
+        lo + CE_CHUNK : search->count;
+
+    ce_scratch scratch;
+    if (!ce_scratch_alloc(&scratch, search->l, search->tpm->rows))
+    {
+        for (size_t c = lo; c < hi; ++c) search->ei[c] = NAN;
+        return;
+    }
+    for (size_t c = lo; c < hi; ++c)
+    {
+        search->ei[c] = macro_effective_info(search, &scratch,
+            search->parts + c * search->l, search->nparts[c], search->best);
+    }
+    ce_scratch_free(&scratch);
+}
+
+/*
+ * Write the macro state of each micro state under a partition, using `work`
+ * for the `l` place values of the blocks and the `l` micro digits.
+ */
+static void macro_groups(size_t l, int const *b, size_t const *parts,
+    size_t n, size_t *work, size_t *groups)
+{
+    size_t *radices = work, *digits = work + l;
+    size_t nparts = 0;
+    for (size_t v = 0; v < l; ++v)
+    {
+        nparts = (parts[v] + 1 > nparts) ? parts[v] + 1 : nparts;
+        digits[v] = 0;
+    }
+    for (size_t j = 0; j < nparts; ++j) radices[j] = 1;
+    for (size_t v = 0; v < l; ++v) radices[parts[v]] += b[v] - 1;
+    size_t m = 1;
+    for (size_t j = nparts; j > 0; --j)
+    {
+        size_t const r = radices[j - 1];
+        radices[j - 1] = m;
+        m *= r;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t macro = 0;
+        for (size_t v = 0; v < l; ++v)
+        {
+            macro += digits[v] * radices[parts[v]];
+        }
+        groups[i] = macro;
+        for (size_t v = l; v > 0 && ++digits[v - 1] == (size_t) b[v - 1]; --v)
+        {
+            digits[v - 1] = 0;
+        }
+    }
+}
+
+double inform_causal_emergence(inform_sparse_tpm const *tpm, size_t l,
+    int const *b, size_t *parts, size_t *groups, inform_error *err)
+{
+    if (check_sparse_arguments(tpm, NULL, err))
+    {
+        return NAN;
+    }
+    else if (l == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, NAN);
+    }
+    else if (b == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, NAN);
+    }
+    size_t n = 1;
+    for (size_t v = 0; v < l; ++v)
+    {
+        if (b[v] < 2)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EBASE, NAN);
+        }
+        else if (tpm->rows / b[v] < n)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ETPM, NAN);
+        }
+        n *= b[v];
+    }
+    if (n != tpm->rows || tpm->nnz == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETPM, NAN);
+    }
+
+    size_t *batch = malloc(CE_BATCH * (l + 1) * sizeof(size_t));
+    size_t *best_parts = malloc(3 * l * sizeof(size_t));
+    double *ei = malloc(CE_BATCH * sizeof(double));
+    ce_scratch scratch;
+    bool const allocated = ce_scratch_alloc(&scratch, l, n);
+    if (batch == NULL || best_parts == NULL || ei == NULL || !allocated)
+    {
+        free(batch);
+        free(best_parts);
+        free(ei);
+        if (allocated) ce_scratch_free(&scratch);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    // the finest partition leaves the micro system unchanged
+    for (size_t v = 0; v < l; ++v) best_parts[v] = v;
+    ce_search micro_search = { tpm, l, b, best_parts, NULL, 1, -INFINITY,
+        NULL };
+    double const micro = macro_effective_info(&micro_search, &scratch,
+        best_parts, l, -INFINITY);
+    ce_scratch_free(&scratch);
+
+    size_t *nparts = batch + CE_BATCH * l;
+    size_t *current = inform_first_partitioning(l);
+    size_t size = 1;
+    double best = micro;
+    bool failed = (current == NULL);
+    while (!failed && size != 0)
+    {
+        size_t count = 0;
+        for (; count < CE_BATCH && size != 0; ++count)
+        {
+            memcpy(batch + count * l, current, l * sizeof(size_t));
+            nparts[count] = size;
+            size = inform_next_partitioning(current, l);
+        }
+
+        ce_search search = { tpm, l, b, batch, nparts, count, best, ei };
+        size_t const chunks = (count + CE_CHUNK - 1) / CE_CHUNK;
+        if (chunks > 1)
+        {
+            inform_parallel_for(chunks, causal_emergence_chunk, &search);
+        }
+        else
+        {
+            causal_emergence_chunk(0, &search);
+        }
+
+        for (size_t c = 0; c < count; ++c)
+        {
+            if (isnan(ei[c]))
+            {
+                failed = true;
+                break;
+            }
+            else if (ei[c] > best + CE_TOLERANCE)
+            {
+                best = ei[c];
+                memcpy(best_parts, batch + c * l, l * sizeof(size_t));
+            }
+        }
+    }
+    free(current);
+    free(batch);
+    free(ei);
+
+    if (failed)
+    {
+        free(best_parts);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    if (parts != NULL)
+    {
+        memcpy(parts, best_parts, l * sizeof(size_t));
+    }
+    if (groups != NULL)
+    {
+        macro_groups(l, b, best_parts, n, best_parts + l, groups);
+    }
+    free(best_parts);
+
+    return best - micro;
+}
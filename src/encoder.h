@@ -0,0 +1,156 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * The number of samples encoded at a time by `inform_encoder_columns`. Each
+ * block of codes stays in cache while every variable is folded into it.
+ */
+#define INFORM_ENCODER_BLOCK 2048
+
+/*
+ * Multiply `*support` by `b^k`, failing if the result would exceed `limit`.
+ */
+static inline bool inform_encoder_extend(uint64_t *support, int b, size_t k,
+    uint64_t limit)
+{
+    for (size_t i = 0; i < k; ++i)
+    {
+        if (*support > limit / (uint64_t) b)
+        {
+            return false;
+        }
+        *support *= (uint64_t) b;
+    }
+    return true;
+}
+
+/*
+ * Compute the size of the joint support of `l` variables with bases `b`,
+ * failing if it would exceed `limit`.
+ */
+static inline bool inform_encoder_support(int const *b, size_t l,
+    uint64_t limit, uint64_t *support)
+{
+    *support = 1;
+    for (size_t i = 0; i < l; ++i)
+    {
+        if (!inform_encoder_extend(support, b[i], 1, limit))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Fold a column of base-`b` states into the less significant end of a column
+ * of codes, `codes[i] = codes[i] * b + column[i]`.
+ */
+static inline void inform_encoder_fold(int *restrict codes,
+    int const *restrict column, int b, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        codes[i] = codes[i] * b + column[i];
+    }
+}
+
+/*
+ * Fold a column of base-`b` states, `stride` elements apart, into a column of
+ * codes.
+ */
+static inline void inform_encoder_fold_strided(int *restrict codes,
+    int const *restrict column, ptrdiff_t stride, int b, size_t n)
+{
+    if (stride == 1)
+    {
+        inform_encoder_fold(codes, column, b, n);
+        return;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        codes[i] = codes[i] * b + column[(ptrdiff_t) i * stride];
+    }
+}
+
+/*
+ * Fold a column of base-`b` states into a column of 64-bit codes.
+ */
+static inline void inform_encoder_fold64(uint64_t *restrict codes,
+    int const *restrict column, int b, size_t n)
+{
+    uint64_t const base = (uint64_t) b;
+    for (size_t i = 0; i < n; ++i)
+    {
+        codes[i] = codes[i] * base + (uint64_t) column[i];
+    }
+}
+
+/*
+ * Encode `l` variables of `n` samples each, stored one after another in
+ * `series`, into `n` codes. The first variable is the most significant. If
+ * `vars` is not `NULL`, the variables `vars[0], ..., vars[l-1]` of `series`
+ * are encoded instead, and `b` is indexed by the variable number.
+ */
+static inline void inform_encoder_columns(int const *series, size_t l,
+    size_t n, int const *b, size_t const *vars, int *codes)
+{
+    for (size_t j = 0; j < n; j += INFORM_ENCODER_BLOCK)
+    {
+        size_t const w = (n - j < INFORM_ENCODER_BLOCK) ? n - j : INFORM_ENCODER_BLOCK;
+        memset(codes + j, 0, w * sizeof(int));
+        for (size_t i = 0; i < l; ++i)
+        {
+            size_t const v = (vars == NULL) ? i : vars[i];
+            inform_encoder_fold(codes + j, series + n * v + j, b[v], w);
+        }
+    }
+}
+
+/*
+ * Encode `l` variables of `n` samples each into `n` 64-bit codes.
+ */
+static inline void inform_encoder_columns64(int const *series, size_t l,
+    size_t n, int const *b, size_t const *vars, uint64_t *codes)
+{
+    for (size_t j = 0; j < n; j += INFORM_ENCODER_BLOCK)
+    {
+        size_t const w = (n - j < INFORM_ENCODER_BLOCK) ? n - j : INFORM_ENCODER_BLOCK;
+        memset(codes + j, 0, w * sizeof(uint64_t));
+        for (size_t i = 0; i < l; ++i)
+        {
+            size_t const v = (vars == NULL) ? i : vars[i];
+            inform_encoder_fold64(codes + j, series + n * v + j, b[v], w);
+        }
+    }
+}
+
+/*
+ * Encode `l` variables of `n` samples each into `n` codes, where sample `j` of
+ * variable `i` is `data[i * var_stride + j * time_stride]`.
+ */
+static inline void inform_encoder_columns_strided(int const *data,
+    ptrdiff_t time_stride, ptrdiff_t var_stride, size_t l, size_t n,
+    int const *b, int *codes)
+{
+    for (size_t j = 0; j < n; j += INFORM_ENCODER_BLOCK)
+    {
+        size_t const w = (n - j < INFORM_ENCODER_BLOCK) ? n - j : INFORM_ENCODER_BLOCK;
+        memset(codes + j, 0, w * sizeof(int));
+        for (size_t i = 0; i < l; ++i)
+        {
+            int const *column = data + (ptrdiff_t) i * var_stride
+                + (ptrdiff_t) j * time_stride;
+            inform_encoder_fold_strided(codes + j, column, time_stride, b[i], w);
+        }
+    }
+}
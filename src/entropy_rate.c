@@ -4,6 +4,10 @@
 #include <inform/entropy_rate.h>
 #include <inform/shannon.h>
 
+#include "encoder.h"
+#include "estimator.h"
+#include "histogram.h"
+
 static void accumulate_observations(int const* series, size_t n, size_t m,
     int b, size_t k, inform_dist *states, inform_dist *histories)
 {
@@ -62,7 +66,8 @@ static void accumulate_local_observations(int const* series, size_t n, size_t m,
     }
 }
 
-static bool check_arguments(int const *series, size_t n, size_t m, int b, size_t k, inform_error *err)
+static bool check_arguments(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_validation validation, inform_error *err)
 {
     if (series == NULL)
     {
@@ -88,7 +93,7 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b, size_t
     {
         INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
     }
-    for (size_t i = 0; i < n * m; ++i)
+    for (size_t i = 0; validation == INFORM_VALIDATE_FULL && i < n * m; ++i)
     {
         if (series[i] < 0)
         {
@@ -102,13 +107,78 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b, size_t
     return false;
 }
 
-double inform_entropy_rate(int const *series, size_t n, size_t m, int b,
-    size_t k, inform_error *err)
+/*
+ * Compute the entropy rate from sparse histograms, counting the runs of sorted
+ * history-future codes.
+ */
+static double sparse_entropy_rate(int const *series, size_t n, size_t m,
+    int b, size_t k, inform_estimator est, inform_error *err)
+{
+    size_t const N = n * (m - k);
+
+    uint64_t *codes = malloc(2 * N * sizeof(uint64_t));
+    uint32_t *counts = malloc(2 * N * sizeof(uint32_t));
+    if (codes == NULL || counts == NULL)
+    {
+        free(counts);
+        free(codes);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    inform_histogram_histories(series, n, m, b, k, codes);
+    inform_histogram_sort(codes, codes + N, N);
+    inform_dist const states = inform_histogram_runs(codes, N, 1, counts);
+    inform_dist const histories = inform_histogram_runs(codes, N, b,
+        counts + N);
+
+    double const er = inform_shannon_ce_est(&states, &histories, 2.0, est);
+
+    free(counts);
+    free(codes);
+
+    return er;
+}
+
+static double entropy_rate(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_estimator est, inform_config const *config,
+    inform_error *err)
 {
-    if (check_arguments(series, n, m, b, k, err)) return NAN;
+    if (check_arguments(series, n, m, b, k, config->validation, err))
+    {
+        return NAN;
+    }
+    if (!inform_estimator_is_valid(est))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NAN);
+    }
 
     size_t const N = n * (m - k);
 
+    uint64_t cells = 1;
+    if (inform_encoder_extend(&cells, b, k + 1, INT_MAX))
+    {
+        cells += cells / b;
+    }
+    else
+    {
+        cells = 0;
+    }
+    uint64_t const sparse = 2 * N * (sizeof(uint64_t) + sizeof(uint32_t));
+    bool dense;
+    if (inform_histogram_choose(config, cells, sparse, est, &dense, err))
+    {
+        return NAN;
+    }
+    else if (!dense)
+    {
+        uint64_t states = 1;
+        if (!inform_encoder_extend(&states, b, k + 1, UINT64_MAX))
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EENCODE, NAN);
+        }
+        return sparse_entropy_rate(series, n, m, b, k, est, err);
+    }
+
     size_t const states_size = (size_t) (b * pow((double) b, (double) k));
     size_t const histories_size = states_size / b;
     size_t const total_size = states_size + histories_size;
@@ -124,17 +194,43 @@ double inform_entropy_rate(int const *series, size_t n, size_t m, int b,
 
     accumulate_observations(series, n, m, b, k, &states, &histories);
 
-    double er = inform_shannon_ce(&states, &histories, 2.0);
+    double er = inform_shannon_ce_est(&states, &histories, 2.0, est);
 
     free(data);
 
     return er;
 }
 
+double inform_entropy_rate(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_error *err)
+{
+    inform_config const config = inform_config_default();
+    return entropy_rate(series, n, m, b, k, INFORM_PLUGIN, &config, err);
+}
+
+double inform_entropy_rate_est(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_estimator est, inform_error *err)
+{
+    inform_config const config = inform_config_default();
+    return entropy_rate(series, n, m, b, k, est, &config, err);
+}
+
+double inform_entropy_rate_ex(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_estimator est, inform_config const *config,
+    inform_error *err)
+{
+    inform_config resolved;
+    if (inform_config_resolve(config, &resolved, err)) return NAN;
+    return entropy_rate(series, n, m, b, k, est, &resolved, err);
+}
+
 double *inform_local_entropy_rate(int const *series, size_t n, size_t m, int b,
     size_t k, double *er, inform_error *err)
 {
-    if (check_arguments(series, n, m, b, k, err)) return NULL;
+    if (check_arguments(series, n, m, b, k, INFORM_VALIDATE_FULL, err))
+    {
+        return NULL;
+    }
 
     size_t const N = n * (m - k);
 
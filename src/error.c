@@ -42,6 +42,7 @@ char const *inform_strerror(inform_error const *err)
         case INFORM_ETPMROW:      return "all zero row in TPM";
         case INFORM_ESIZE:        return "invalid size";
         case INFORM_EPARTS:       return "invalid partitioning";
+        case INFORM_EBUDGET:      return "memory budget exceeded";
         default:                  return "unrecognized error";
     }
 }
@@ -0,0 +1,18 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/shannon.h>
+#include <stdbool.h>
+
+/**
+ * Determine whether an estimator is one which the library recognizes.
+ *
+ * @param[in] est the estimator
+ * @return true if the estimator is valid
+ */
+inline static bool inform_estimator_is_valid(inform_estimator est)
+{
+    return (unsigned) est <= INFORM_NSB;
+}
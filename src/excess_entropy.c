@@ -11,6 +11,12 @@ double inform_excess_entropy(int const *series, size_t n, size_t m, int b,
     return inform_predictive_info(series, n, m, b, k, k, err);
 }
 
+double inform_excess_entropy_est(int const *series, size_t n, size_t m, int b,
+    size_t k, inform_estimator est, inform_error *err)
+{
+    return inform_predictive_info_est(series, n, m, b, k, k, est, err);
+}
+
 double *inform_local_excess_entropy(int const *series, size_t n, size_t m,
     int b, size_t k, double *ee, inform_error *err)
 {
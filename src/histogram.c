@@ -0,0 +1,139 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "histogram.h"
+#include <string.h>
+
+inform_config inform_config_default(void)
+{
+    return (inform_config) {
+        .pool = NULL,
+        .threads = 0,
+        .memory = 0,
+        .histogram = INFORM_HISTOGRAM_AUTO,
+        .validation = INFORM_VALIDATE_FULL,
+    };
+}
+
+bool inform_config_resolve(inform_config const *config,
+    inform_config *resolved, inform_error *err)
+{
+    *resolved = (config == NULL) ? inform_config_default() : *config;
+    /* the validation level decides whether the states are bounds checked */
+    if ((unsigned) resolved->histogram > INFORM_HISTOGRAM_SPARSE ||
+        (unsigned) resolved->validation > INFORM_VALIDATE_ARGS)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    return false;
+}
+
+bool inform_histogram_choose(inform_config const *config, uint64_t cells,
+    uint64_t sparse, inform_estimator est, bool *dense, inform_error *err)
+{
+    uint64_t const budget = config->memory;
+    bool const dense_fits = cells != 0
+        && (budget == 0 || cells <= budget / sizeof(uint32_t));
+    bool const sparse_fits = budget == 0 || sparse <= budget;
+
+    if (config->histogram != INFORM_HISTOGRAM_SPARSE && dense_fits)
+    {
+        *dense = true;
+        return false;
+    }
+    else if (config->histogram == INFORM_HISTOGRAM_DENSE || est == INFORM_NSB)
+    {
+        /* the NSB estimator depends on the size of the state space */
+        if (config->histogram == INFORM_HISTOGRAM_SPARSE)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+        }
+        INFORM_ERROR_RETURN(err, (cells == 0) ? INFORM_EENCODE : INFORM_EBUDGET,
+            true);
+    }
+    else if (!sparse_fits)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBUDGET, true);
+    }
+    *dense = false;
+    return false;
+}
+
+/*
+ * A least-significant-digit radix sort on 11-bit digits. Only as many passes
+ * are made as there are digits in the largest code.
+ */
+void inform_histogram_sort(uint64_t *codes, uint64_t *scratch, size_t n)
+{
+    uint64_t largest = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        largest = (codes[i] > largest) ? codes[i] : largest;
+    }
+
+    size_t count[1 << 11];
+    uint64_t *src = codes, *dst = scratch;
+    for (unsigned shift = 0; shift < 64 && (largest >> shift) != 0; shift += 11)
+    {
+        memset(count, 0, sizeof(count));
+        for (size_t i = 0; i < n; ++i)
+        {
+            count[(src[i] >> shift) & 0x7ff]++;
+        }
+        size_t offset = 0;
+        for (size_t d = 0; d < (1 << 11); ++d)
+        {
+            size_t const c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            dst[count[(src[i] >> shift) & 0x7ff]++] = src[i];
+        }
+        uint64_t *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    if (src != codes)
+    {
+        memcpy(codes, src, n * sizeof(uint64_t));
+    }
+}
+
+inform_dist inform_histogram_runs(uint64_t const *codes, size_t n,
+    uint64_t divisor, uint32_t *counts)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < n;)
+    {
+        uint64_t const value = codes[i] / divisor;
+        size_t j = i + 1;
+        while (j < n && codes[j] / divisor == value) ++j;
+        counts[size++] = (uint32_t) (j - i);
+        i = j;
+    }
+    return (inform_dist) { counts, size, n };
+}
+
+void inform_histogram_histories(int const *series, size_t n, size_t m, int b,
+    size_t k, uint64_t *codes)
+{
+    uint64_t q = 1;
+    for (size_t j = 0; j < k; ++j) q *= (uint64_t) b;
+
+    for (size_t i = 0; i < n; ++i, series += m)
+    {
+        uint64_t history = 0;
+        for (size_t j = 0; j < k; ++j)
+        {
+            history = history * b + series[j];
+        }
+        for (size_t j = k; j < m; ++j)
+        {
+            uint64_t const state = history * b + series[j];
+            *codes++ = state;
+            history = state - series[j - k] * q;
+        }
+    }
+}
@@ -0,0 +1,87 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/config.h>
+#include <inform/dist.h>
+#include <inform/error.h>
+#include <inform/shannon.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Resolve a possibly `NULL` configuration to the one it stands for, and
+ * check that its histogram kind and validation level are known.
+ *
+ * @param[in] config    the configuration (or `NULL`)
+ * @param[out] resolved the configuration
+ * @param[out] err      `INFORM_EARG` if the configuration is invalid
+ * @return `true` on error
+ */
+bool inform_config_resolve(inform_config const *config,
+    inform_config *resolved, inform_error *err);
+
+/**
+ * Choose between dense and sparse histograms for an estimator.
+ *
+ * Dense histograms are chosen if the configuration allows them, they can be
+ * indexed, and their `cells` 32-bit counts fit in the memory budget; `cells`
+ * is zero if the dense histograms cannot be indexed by an `int`. Otherwise,
+ * sparse histograms needing `sparse` bytes are chosen if the configuration
+ * allows them, they fit in the budget, and the estimator does not depend on
+ * the size of the state space, as the NSB estimator does.
+ *
+ * @param[in] config the configuration
+ * @param[in] cells  the number of dense histogram cells, or 0
+ * @param[in] sparse the number of bytes needed by sparse histograms
+ * @param[in] est    the entropy estimator
+ * @param[out] dense whether to use dense histograms
+ * @param[out] err   `INFORM_EBUDGET` if neither fits in the budget,
+ *                   `INFORM_EENCODE` if the states cannot be indexed densely
+ *                   and sparse histograms are not an option
+ * @return `true` on error
+ */
+bool inform_histogram_choose(inform_config const *config, uint64_t cells,
+    uint64_t sparse, inform_estimator est, bool *dense, inform_error *err);
+
+/**
+ * Sort `n` codes in place, using `scratch` for `n` more.
+ *
+ * @param[in,out] codes   the codes
+ * @param[in] scratch     space for `n` codes
+ * @param[in] n           the number of codes
+ */
+void inform_histogram_sort(uint64_t *codes, uint64_t *scratch, size_t n);
+
+/**
+ * Count the observations of each distinct value of `codes[i] / divisor` for
+ * sorted codes, so that equal values are adjacent, into a histogram of only
+ * the observed values. The histogram's storage, `counts`, must have room for
+ * `n` counts.
+ *
+ * @param[in] codes   the sorted codes
+ * @param[in] n       the number of codes
+ * @param[in] divisor the divisor of each code
+ * @param[in] counts  the storage for the histogram
+ * @return the histogram
+ */
+inform_dist inform_histogram_runs(uint64_t const *codes, size_t n,
+    uint64_t divisor, uint32_t *counts);
+
+/**
+ * Encode each of the `n * (m - k)` observations of a length-`k` history and
+ * the following state in `n` base-`b` time series of `m` time steps as a
+ * 64-bit code, the oldest state most significant, so that the history of the
+ * code `x` is `x / b` and the following state `x % b`. The number of states,
+ * `b^(k+1)`, must be representable.
+ *
+ * @param[in] series the time series
+ * @param[in] n      the number of initial conditions
+ * @param[in] m      the number of time steps in each time series
+ * @param[in] b      the base of the time series
+ * @param[in] k      the history length
+ * @param[out] codes the codes
+ */
+void inform_histogram_histories(int const *series, size_t n, size_t m, int b,
+    size_t k, uint64_t *codes);
@@ -3,47 +3,225 @@
 // license that can be found in the LICENSE file.
 #include <inform/dist.h>
 #include <inform/information_flow.h>
-#include <inform/mutual_info.h>
-#include <inform/utilities/black_boxing.h>
 #include <math.h>
+#include <string.h>
 
+#include "encoder.h"
+#include "parallel.h"
+
+/*
+ * The histograms of the source, destination and background states, and the
+ * distinct joint states in the order in which they were first observed.
+ */
+typedef struct flow_hist
+{
+    uint32_t *data;
+    inform_dist joint, as, bs, s;
+    int *occupied;
+    size_t noccupied;
+} flow_hist;
+
+static void flow_hist_free(flow_hist *hist)
+{
+    free(hist->data);
+    free(hist->occupied);
+}
+
+/*
+ * Allocate the histograms for `l_src` source, `l_dst` destination and
+ * `l_back` background variables, with room to list `max_states` distinct
+ * joint states.
+ */
+static bool flow_hist_alloc(flow_hist *hist, size_t l_src, size_t l_dst,
+    size_t l_back, int b, size_t max_states, inform_error *err)
+{
+    uint64_t support = 1;
+    if (!inform_encoder_extend(&support, b, l_src + l_dst + l_back, INT_MAX))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, false);
+    }
+
+    size_t const a_size = pow((double) b, (double) l_src);
+    size_t const b_size = pow((double) b, (double) l_dst);
+    size_t const s_size = pow((double) b, (double) l_back);
+
+    size_t const joint_size = a_size * b_size * s_size;
+    size_t const as_size = a_size * s_size;
+    size_t const bs_size = b_size * s_size;
+
+    size_t const total_size = joint_size + as_size + bs_size + s_size;
+
+    max_states = (max_states < joint_size) ? max_states : joint_size;
+    hist->data = calloc(total_size, sizeof(uint32_t));
+    hist->occupied = malloc(max_states * sizeof(int));
+    if (hist->data == NULL || hist->occupied == NULL)
+    {
+        flow_hist_free(hist);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, false);
+    }
+
+    uint32_t *data = hist->data;
+    hist->joint = (inform_dist){ data, joint_size, 0 };
+    hist->as    = (inform_dist){ data + joint_size, as_size, 0 };
+    hist->bs    = (inform_dist){ data + joint_size + as_size, bs_size, 0 };
+    hist->s     = (inform_dist){ data + joint_size + as_size + bs_size, s_size, 0 };
+    hist->noccupied = 0;
+    return true;
+}
+
+/*
+ * Accumulate `N` observations into the histograms, listing the joint states
+ * which are observed for the first time.
+ */
 static void accumulate_observations(int const *src, int const *dst,
     int const *back, size_t l_src, size_t l_dst, size_t l_back,
-    size_t n, size_t m, int b, inform_dist *joint, inform_dist *as,
-    inform_dist *bs, inform_dist *s)
+    size_t N, int b, int *codes, flow_hist *hist)
+{
+    int *a_codes = codes, *b_codes = codes + N, *s_codes = codes + 2 * N;
+    memset(codes, 0, 3 * N * sizeof(int));
+    for (size_t k = 0; k < l_src; ++k)
+    {
+        inform_encoder_fold(a_codes, src + k * N, b, N);
+    }
+    for (size_t k = 0; k < l_dst; ++k)
+    {
+        inform_encoder_fold(b_codes, dst + k * N, b, N);
+    }
+    for (size_t k = 0; k < l_back; ++k)
+    {
+        inform_encoder_fold(s_codes, back + k * N, b, N);
+    }
+
+    int const qs = hist->s.size, qbs = hist->bs.size;
+    for (size_t i = 0; i < N; ++i)
+    {
+        int as_state = a_codes[i] * qs + s_codes[i];
+        int bs_state = b_codes[i] * qs + s_codes[i];
+        int joint_state = a_codes[i] * qbs + bs_state;
+
+        if (hist->joint.histogram[joint_state]++ == 0)
+        {
+            hist->occupied[hist->noccupied++] = joint_state;
+        }
+        hist->as.histogram[as_state]++;
+        hist->bs.histogram[bs_state]++;
+        hist->s.histogram[s_codes[i]]++;
+    }
+    hist->joint.counts += N;
+}
+
+/*
+ * The flow is summed over the occupied joint states only, grouped by the
+ * state of the background. Once there are FLOW_GRAIN of them, the grouped
+ * states are split into one contiguous span per thread, so that each thread
+ * reduces over a range of background states, and the partial sums are added
+ * in span order.
+ */
+#define FLOW_GRAIN (1 << 16)
+
+typedef struct flow_sum
+{
+    flow_hist const *hist;
+    int const *states;
+    size_t spans;
+    double *partial;
+} flow_sum;
+
+static void flow_span(size_t span, void *context)
+{
+    flow_sum const *job = context;
+    flow_hist const *hist = job->hist;
+    size_t const lo = (hist->noccupied * span) / job->spans;
+    size_t const hi = (hist->noccupied * (span + 1)) / job->spans;
+    int const qs = hist->s.size, qbs = hist->bs.size;
+    double flow = 0.0;
+    for (size_t i = lo; i < hi; ++i)
+    {
+        int const joint_state = job->states[i];
+        int const s_state = joint_state % qs;
+        int const bs_state = joint_state % qbs;
+        int const as_state = (joint_state / qbs) * qs + s_state;
+
+        double const njoint = hist->joint.histogram[joint_state];
+        double const ns = hist->s.histogram[s_state];
+        double const nas = hist->as.histogram[as_state];
+        double const nbs = hist->bs.histogram[bs_state];
+        flow += njoint * log2((njoint * ns) / (nas * nbs));
+    }
+    job->partial[span] = flow;
+}
+
+/*
+ * Compute the information flow from the accumulated histograms.
+ */
+static double flow_total(flow_hist const *hist, inform_error *err)
+{
+    size_t const s_size = hist->s.size, nstates = hist->noccupied;
+    size_t const spans = (nstates >= FLOW_GRAIN) ? inform_parallel_threads() : 1;
+    int *states = malloc(nstates * sizeof(int));
+    size_t *offsets = calloc(s_size + 1, sizeof(size_t));
+    double *partial = malloc(spans * sizeof(double));
+    if (states == NULL || offsets == NULL || partial == NULL)
+    {
+        free(states);
+        free(offsets);
+        free(partial);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    // group the occupied joint states by background state
+    int const *occupied = hist->occupied;
+    for (size_t i = 0; i < nstates; ++i)
+    {
+        offsets[occupied[i] % s_size + 1]++;
+    }
+    for (size_t k = 0; k < s_size; ++k)
+    {
+        offsets[k + 1] += offsets[k];
+    }
+    for (size_t i = 0; i < nstates; ++i)
+    {
+        states[offsets[occupied[i] % s_size]++] = occupied[i];
+    }
+    free(offsets);
+
+    flow_sum job = { hist, states, spans, partial };
+    if (spans > 1)
+    {
+        inform_parallel_for(spans, flow_span, &job);
+    }
+    else
+    {
+        flow_span(0, &job);
+    }
+
+    double flow = 0.0;
+    for (size_t k = 0; k < spans; ++k)
+    {
+        flow += partial[k];
+    }
+
+    free(states);
+    free(partial);
+
+    return flow / hist->joint.counts;
+}
+
+static bool check_states(int const *series, size_t n, int b,
+    inform_error *err)
 {
-    int const qs = s->size, qbs = bs->size;
     for (size_t i = 0; i < n; ++i)
     {
-        for (size_t j = 0; j < m; ++j)
+        if (b <= series[i])
         {
-            int a_state = 0, b_state = 0, s_state = 0;
-            for (size_t k = 0; k < l_src; ++k)
-            {
-                a_state *= b;
-                a_state += src[j + i * m + k * n * m];
-            }
-            for (size_t k = 0; k < l_dst; ++k)
-            {
-                b_state *= b;
-                b_state += dst[j + i * m + k * n * m];
-            }
-            for (size_t k = 0; k < l_back; ++k)
-            {
-                s_state *= b;
-                s_state += back[j + i * m + k * n * m];
-            }
-
-            int as_state = a_state * qs + s_state;
-            int bs_state = b_state * qs + s_state;
-            int joint_state = a_state * qbs + bs_state;
-
-            joint->histogram[joint_state]++;
-            as->histogram[as_state]++;
-            bs->histogram[bs_state]++;
-            s->histogram[s_state]++;
+            INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
+        }
+        else if (series[i] < 0)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
         }
     }
+    return false;
 }
 
 static bool check_arguments(int const *src, int const *dst, int const *back,
@@ -74,167 +252,208 @@ static bool check_arguments(int const *src, int const *dst, int const *back,
     {
         INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
     }
-    for (size_t i = 0; i < l_src * n * m; ++i)
+    return check_states(src, l_src * n * m, b, err) ||
+        check_states(dst, l_dst * n * m, b, err) ||
+        (back != NULL && check_states(back, l_back * n * m, b, err));
+}
+
+double inform_information_flow(int const *src, int const *dst, int const *back,
+    size_t l_src, size_t l_dst, size_t l_back, size_t n, size_t m, int b,
+    inform_error *err)
+{
+    if (check_arguments(src, dst, back, l_src, l_dst, l_back, n, m, b, err))
+    {
+        return NAN;
+    }
+
+    if (back == NULL)
     {
-        if (b <= src[i])
-        {
-            INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
-        }
-        else if (src[i] < 0)
-        {
-            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
-        }
+        l_back = 0;
     }
-    for (size_t i = 0; i < l_dst * n * m; ++i)
+
+    size_t const N = n * m;
+
+    flow_hist hist;
+    if (!flow_hist_alloc(&hist, l_src, l_dst, l_back, b, N, err))
     {
-        if (b <= dst[i])
-        {
-            INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
-        }
-        else if (dst[i] < 0)
-        {
-            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
-        }
+        return NAN;
     }
-    if (back != NULL)
+    int *codes = malloc(3 * N * sizeof(int));
+    if (codes == NULL)
     {
-        for (size_t i = 0; i < l_back * n * m; ++i)
-        {
-            if (b <= back[i])
-            {
-                INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
-            }
-            else if (back[i] < 0)
-            {
-                INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
-            }
-        }
+        flow_hist_free(&hist);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
     }
-    return false;
+
+    accumulate_observations(src, dst, back, l_src, l_dst, l_back, N, b,
+        codes, &hist);
+    free(codes);
+
+    double const flow = flow_total(&hist, err);
+
+    flow_hist_free(&hist);
+
+    return flow;
 }
 
-static double mutual_info(int const *src, int const *dst, size_t l_src,
-    size_t l_dst, size_t n, size_t m, int b, inform_error *err)
+/*
+ * Samples are requested from the generator in batches of FLOW_BATCH. While
+ * one batch is checked and accumulated, the generator fills the other, the
+ * two running as separate tasks of `inform_parallel_for`.
+ */
+#define FLOW_BATCH (1 << 14)
+
+typedef struct flow_pipeline
 {
-    size_t const N = n * m;
+    inform_flow_generator generate;
+    void *context;
+    size_t l_src, l_dst, l_back;
+    int b;
+    int *buffers[2];
+    size_t produced[2];
+    size_t next;
+    int *codes;
+    flow_hist *hist;
+    inform_error generate_err, accumulate_err;
+} flow_pipeline;
 
-    int *data = malloc((2 * N + l_src + l_dst) * sizeof(int));
-    if (data == NULL)
+static void generate_batch(flow_pipeline *pipe, size_t k)
+{
+    size_t const l = pipe->l_src + pipe->l_dst + pipe->l_back;
+    int *src = pipe->buffers[k];
+    int *dst = src + pipe->l_src * FLOW_BATCH;
+    int *back = (pipe->l_back != 0) ? dst + pipe->l_dst * FLOW_BATCH : NULL;
+    size_t const produced = pipe->generate(src, dst, back, FLOW_BATCH,
+        pipe->context);
+    pipe->produced[k] = (produced <= FLOW_BATCH) ? produced : 0;
+    if (produced > FLOW_BATCH)
     {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+        pipe->generate_err = INFORM_EARG;
     }
-
-    int b_src = 1;
-    for (size_t i = 0; i < l_src; ++i)
+    else if (produced < FLOW_BATCH)
     {
-        b_src *= b;
-        data[2 * N + i] = b;
+        // compact the variables so that each has `produced` samples
+        for (size_t v = 1; v < l; ++v)
+        {
+            memmove(src + v * produced, src + v * FLOW_BATCH,
+                produced * sizeof(int));
+        }
     }
+}
 
-    int b_dst = 1;
-    for (size_t i = 0; i < l_dst; ++i)
+static void accumulate_batch(flow_pipeline *pipe, size_t k)
+{
+    size_t const N = pipe->produced[k];
+    int const *src = pipe->buffers[k];
+    int const *dst = src + pipe->l_src * N;
+    int const *back = dst + pipe->l_dst * N;
+    size_t const l = pipe->l_src + pipe->l_dst + pipe->l_back;
+    // the histograms count in 32 bits, so no count can wrap if the total
+    // does not exceed UINT32_MAX
+    if (N > UINT32_MAX - pipe->hist->joint.counts)
     {
-        b_dst *= b;
-        data[2 * N + l_src + i] = b;
+        pipe->accumulate_err = INFORM_ESIZE;
+        return;
     }
-
-    inform_black_box(src, l_src, n, m, data + 2 * N, NULL, NULL, data, err);
-    if (inform_failed(err))
+    if (check_states(src, l * N, pipe->b, &pipe->accumulate_err))
     {
-        return NAN;
+        return;
     }
+    accumulate_observations(src, dst, back, pipe->l_src, pipe->l_dst,
+        pipe->l_back, N, pipe->b, pipe->codes, pipe->hist);
+}
 
-    inform_black_box(dst, l_dst, n, m, data + 2 * N + l_src, NULL, NULL, data + N, err);
-    if (inform_failed(err))
+static void pipeline_step(size_t task, void *context)
+{
+    flow_pipeline *pipe = context;
+    if (task == 0)
     {
-        return NAN;
+        generate_batch(pipe, pipe->next);
+    }
+    else
+    {
+        accumulate_batch(pipe, 1 - pipe->next);
     }
-
-    double mi = inform_mutual_info(data, 2, N, (int[2]){ b_src, b_dst }, err);
-
-    free(data);
-
-    return mi;
 }
 
-double inform_information_flow(int const *src, int const *dst, int const *back,
-    size_t l_src, size_t l_dst, size_t l_back, size_t n, size_t m, int b,
+double inform_information_flow_generated(inform_flow_generator generate,
+    void *context, size_t l_src, size_t l_dst, size_t l_back, int b,
     inform_error *err)
 {
-    if (check_arguments(src, dst, back, l_src, l_dst, l_back, n, m, b, err))
+    if (generate == NULL)
     {
-        return NAN;
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NAN);
     }
-
-    if (back == NULL || l_back == 0)
+    else if (l_src == 0 || l_dst == 0)
     {
-        return mutual_info(src, dst, l_src, l_dst, n, m, b, err);
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, NAN);
+    }
+    else if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, NAN);
     }
 
-    size_t const N = n * m;
-
-    size_t const a_size = pow((double) b, (double) l_src);
-    size_t const b_size = pow((double) b, (double) l_dst);
-    size_t const s_size = pow((double) b, (double) l_back);
-
-    size_t const joint_size = a_size * b_size * s_size;
-    size_t const as_size = a_size * s_size;
-    size_t const bs_size = b_size * s_size;
-
-    size_t const total_size = joint_size + as_size + bs_size + s_size;
-
-    uint32_t *data = calloc(total_size, sizeof(uint32_t));
-    if (data == NULL)
+    flow_hist hist;
+    if (!flow_hist_alloc(&hist, l_src, l_dst, l_back, b, SIZE_MAX, err))
     {
+        return NAN;
+    }
+    size_t const l = l_src + l_dst + l_back;
+    int *buffers = malloc(2 * l * FLOW_BATCH * sizeof(int));
+    int *codes = malloc(3 * FLOW_BATCH * sizeof(int));
+    if (buffers == NULL || codes == NULL)
+    {
+        free(buffers);
+        free(codes);
+        flow_hist_free(&hist);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
     }
 
-    inform_dist joint = { data, joint_size, N };
-    inform_dist as    = { data + joint_size, as_size, N };
-    inform_dist bs    = { data + joint_size + as_size, bs_size, N };
-    inform_dist s     = { data + joint_size + as_size + bs_size, s_size, N };
-
-    accumulate_observations(src, dst, back, l_src, l_dst, l_back, n, m, b,
-        &joint, &as, &bs, &s);
-
-    double flow = 0.0;
-    int bs_state, as_state, joint_state;
-    double ns, nbs, nas, njoint;
-    for (int s_state = 0; s_state < (int) s_size; ++s_state)
+    flow_pipeline pipe = {
+        generate, context, l_src, l_dst, l_back, b,
+        { buffers, buffers + l * FLOW_BATCH }, { 0, 0 }, 0, codes, &hist,
+        INFORM_SUCCESS, INFORM_SUCCESS
+    };
+    generate_batch(&pipe, 0);
+    pipe.next = 1;
+    while (pipe.generate_err == INFORM_SUCCESS &&
+        pipe.accumulate_err == INFORM_SUCCESS &&
+        pipe.produced[1 - pipe.next] != 0)
     {
-        ns = s.histogram[s_state];
-        if (ns == 0)
+        // the generator is not asked for more once it has run dry
+        bool const more = (pipe.produced[1 - pipe.next] == FLOW_BATCH);
+        if (more)
         {
-            continue;
+            inform_parallel_for(2, pipeline_step, &pipe);
         }
-        for (int b_state = 0; b_state < (int) b_size; ++b_state)
+        else
         {
-            bs_state = b_state * s_size + s_state;
-            nbs = bs.histogram[bs_state];
-            if (nbs == 0)
-            {
-                continue;
-            }
-            for (int a_state = 0; a_state < (int) a_size; ++a_state)
-            {
-                as_state = a_state * s_size + s_state;
-                nas = as.histogram[as_state];
-                if (nas == 0)
-                {
-                    continue;
-                }
-                joint_state = a_state * bs_size + bs_state;
-                njoint = joint.histogram[joint_state];
-                if (njoint == 0)
-                {
-                    continue;
-                }
-                flow += njoint * log2((njoint * ns) / (nas * nbs));
-            }
+            pipe.produced[pipe.next] = 0;
+            accumulate_batch(&pipe, 1 - pipe.next);
         }
+        pipe.next = 1 - pipe.next;
     }
+    free(buffers);
+    free(codes);
 
-    free(data);
+    double flow = NAN;
+    if (pipe.accumulate_err != INFORM_SUCCESS)
+    {
+        INFORM_ERROR(err, pipe.accumulate_err);
+    }
+    else if (pipe.generate_err != INFORM_SUCCESS)
+    {
+        INFORM_ERROR(err, pipe.generate_err);
+    }
+    else if (hist.joint.counts == 0)
+    {
+        INFORM_ERROR(err, INFORM_ESHORTSERIES);
+    }
+    else
+    {
+        flow = flow_total(&hist, err);
+    }
+    flow_hist_free(&hist);
 
-    return flow / N;
+    return flow;
 }
@@ -6,6 +6,8 @@
 #include <inform/utilities.h>
 #include <math.h>
 
+#include "encoder.h"
+
 static bool check_arguments(int const *series, size_t l, inform_error *err)
 {
     if (series == NULL)
@@ -21,6 +23,65 @@ static bool check_arguments(int const *series, size_t l, inform_error *err)
     return false;
 }
 
+/*
+ * The local integration of a partition is
+ *
+ *     log2 p(x_1, ..., x_l) - sum_B log2 p(x_B),
+ *
+ * and the joint term is the same for every partition. Walking the partitions
+ * with `inform_next_partitioning_changes`, the encoding of each block and the
+ * local log-probabilities of its states are kept from one partition to the
+ * next, as is their sum over the blocks. Only the blocks which changed are
+ * re-encoded and re-counted, and their old log-probabilities are replaced in
+ * the running sum, so the cost of each partition grows with the number of
+ * variables which moved rather than with `l`.
+ */
+typedef struct integration_walk
+{
+    int const *series;
+    size_t l, n;
+    int const *b;
+    size_t *members;
+    int *codes;
+    size_t *counts;
+} integration_walk;
+
+/*
+ * Compute the local log-probability of each of `n` encoded states.
+ */
+static void local_logp(integration_walk const *walk, int const *codes,
+    double *logp)
+{
+    size_t const n = walk->n;
+    double const logn = log2((double) n);
+    for (size_t t = 0; t < n; ++t) walk->counts[codes[t]]++;
+    for (size_t t = 0; t < n; ++t)
+    {
+        logp[t] = log2((double) walk->counts[codes[t]]) - logn;
+    }
+    for (size_t t = 0; t < n; ++t) walk->counts[codes[t]] = 0;
+}
+
+/*
+ * Encode block `j` of a partitioning and compute the local log-probability of
+ * its state at each time step.
+ */
+static void block_logp(integration_walk const *walk, size_t const *parts,
+    size_t j, double *logp)
+{
+    size_t k = 0;
+    for (size_t i = 0; i < walk->l; ++i)
+    {
+        if (parts[i] == j)
+        {
+            walk->members[k++] = i;
+        }
+    }
+    inform_encoder_columns(walk->series, k, walk->n, walk->b, walk->members,
+        walk->codes);
+    local_logp(walk, walk->codes, logp);
+}
+
 double *inform_integration_evidence(int const *series, size_t l, size_t n,
     int const *b, double *evidence, inform_error *err)
 {
@@ -28,21 +89,50 @@ double *inform_integration_evidence(int const *series, size_t l, size_t n,
     {
         return NULL;
     }
+    int *joint = inform_black_box(series, l, 1, n, b, NULL, NULL, NULL, err);
+    if (joint == NULL)
+    {
+        return NULL;
+    }
+    uint64_t support = 1;
+    inform_encoder_support(b, l, INT_MAX, &support);
+
     int allocate = (evidence == NULL);
     if (allocate)
     {
         evidence = malloc(2 * n * sizeof(double));
         if (evidence == NULL)
         {
+            free(joint);
             INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
         }
     }
-    double *lmi = malloc(n * sizeof(double));
-    if (lmi == NULL)
+    size_t *parts = inform_first_partitioning(l);
+    size_t *members = malloc(2 * l * sizeof(size_t));
+    size_t *counts = calloc(support, sizeof(size_t));
+    double *logp = malloc((l + 2) * n * sizeof(double));
+    if (parts == NULL || members == NULL || counts == NULL || logp == NULL)
     {
+        free(joint);
+        free(parts);
+        free(members);
+        free(counts);
+        free(logp);
         if (allocate) free(evidence);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
+    size_t *changed = members + l;
+    double *joint_logp = logp + l * n;
+    double *sum = joint_logp + n;
+
+    // the coarsest partitioning has the joint as its only block, and is not
+    // itself compared; thereafter the joint codes are no longer needed, and
+    // their buffer holds the codes of each block as it is encoded
+    integration_walk walk = { series, l, n, b, members, joint, counts };
+    local_logp(&walk, joint, joint_logp);
+    memcpy(logp, joint_logp, n * sizeof(double));
+    memcpy(sum, joint_logp, n * sizeof(double));
+
     double *minimum = evidence;
     double *maximum = minimum + n;
     for (size_t i = 0; i < n; ++i)
@@ -51,33 +141,43 @@ double *inform_integration_evidence(int const *series, size_t l, size_t n,
         maximum[i] = -INFINITY;
     }
 
-    size_t *parts = inform_first_partitioning(l);
-    size_t nparts = 1;
-    while ((nparts = inform_next_partitioning(parts, l)))
+    size_t nparts = 1, nchanged = 0;
+    while (true)
     {
-        inform_integration_evidence_part(series, l, n, b, parts, nparts, lmi, err);
-        if (inform_failed(err))
+        size_t const previous = nparts;
+        nparts = inform_next_partitioning_changes(parts, l, changed, &nchanged);
+        if (nparts == 0)
         {
             break;
         }
-        for (size_t i = 0; i < n; ++i)
+        for (size_t c = 0; c < nchanged; ++c)
         {
-            minimum[i] = MIN(minimum[i], lmi[i]);
-            maximum[i] = MAX(maximum[i], lmi[i]);
+            size_t const j = changed[c];
+            double *block = logp + j * n;
+            if (j < previous)
+            {
+                for (size_t t = 0; t < n; ++t) sum[t] -= block[t];
+            }
+            if (j < nparts)
+            {
+                block_logp(&walk, parts, j, block);
+                for (size_t t = 0; t < n; ++t) sum[t] += block[t];
+            }
         }
-    }
-    free(parts);
-    free(lmi);
-    
-    if (inform_failed(err))
-    {
-        if (allocate)
+        for (size_t i = 0; i < n; ++i)
         {
-            free(evidence);
+            double const lmi = joint_logp[i] - sum[i];
+            minimum[i] = MIN(minimum[i], lmi);
+            maximum[i] = MAX(maximum[i], lmi);
         }
-        return NULL;
     }
 
+    free(joint);
+    free(parts);
+    free(members);
+    free(counts);
+    free(logp);
+
     return evidence;
 }
 
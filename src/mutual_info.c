@@ -4,10 +4,20 @@
 #include <inform/mutual_info.h>
 #include <inform/shannon.h>
 
-static bool check_arguments(int const *series, size_t l, size_t n, int const *b,
-    inform_error *err)
+#include "encoder.h"
+#include "estimator.h"
+#include "histogram.h"
+#include "parallel.h"
+#include "view.h"
+
+/*
+ * Validate the time series without regard to the size of their joint support,
+ * which matters only when all of the series are encoded together.
+ */
+static bool check_series(inform_view const *series, size_t l, size_t n,
+    int const *b, inform_validation validation, inform_error *err)
 {
-    if (series == NULL)
+    if (series->data == NULL)
     {
         INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
     }
@@ -25,13 +35,19 @@ static bool check_arguments(int const *series, size_t l, size_t n, int const *b,
         {
             INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
         }
+        else if (validation != INFORM_VALIDATE_FULL)
+        {
+            continue;
+        }
+        int const *x = inform_view_row(series, i, 0);
         for (size_t j = 0; j < n; ++j)
         {
-            if (series[j + n * i] < 0)
+            int const state = x[(ptrdiff_t) j * series->time_stride];
+            if (state < 0)
             {
                 INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
             }
-            else if (b[i] <= series[j + n * i])
+            else if (b[i] <= state)
             {
                 INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
             }
@@ -40,94 +56,115 @@ static bool check_arguments(int const *series, size_t l, size_t n, int const *b,
     return false;
 }
 
-inline static bool allocate(int const *b, size_t l, inform_dist **joint,
-    inform_dist **marginals, inform_error *err)
+static bool check_arguments(inform_view const *series, size_t l, size_t n,
+    int const *b, inform_error *err)
 {
-    size_t joint_support = 1;
+    if (check_series(series, l, n, b, INFORM_VALIDATE_FULL, err)) return true;
+    uint64_t support;
+    if (!inform_encoder_support(b, l, INT_MAX, &support))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
+    }
+    return false;
+}
+
+/*
+ * Allocate the joint and marginal histograms, and the array of pointers to the
+ * marginals, in a single block which must be freed by the caller.
+ */
+inline static void *allocate(int const *b, size_t l, inform_dist *joint,
+    inform_dist ***marginals, inform_error *err)
+{
+    size_t joint_support = 1, marginal_support = 0;
     for (size_t i = 0; i < l; ++i)
     {
         joint_support *= b[i];
-        if ((marginals[i] = inform_dist_alloc(b[i])) == NULL)
-        {
-            for (size_t j = 0; j < i; ++j)
-            {
-                inform_dist_free(marginals[j]);
-            }
-            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
-        }
+        marginal_support += b[i];
     }
-    if ((*joint = inform_dist_alloc(joint_support)) == NULL)
+
+    size_t const header = l * (sizeof(inform_dist) + sizeof(inform_dist*));
+    char *block = calloc(1, header
+        + (joint_support + marginal_support) * sizeof(uint32_t));
+    if (block == NULL)
     {
-        for (size_t i = 0; i < l; ++i)
-        {
-            inform_dist_free(marginals[i]);
-        }
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
 
-    return false;
+    inform_dist *dists = (inform_dist*) block;
+    inform_dist **pointers = (inform_dist**) (dists + l);
+    uint32_t *histogram = (uint32_t*) (pointers + l);
+
+    *joint = (inform_dist){ histogram, joint_support, 0 };
+    histogram += joint_support;
+    for (size_t i = 0; i < l; ++i)
+    {
+        dists[i] = (inform_dist){ histogram, (size_t) b[i], 0 };
+        pointers[i] = dists + i;
+        histogram += b[i];
+    }
+    *marginals = pointers;
+
+    return block;
 }
 
-inline static void accumulate(int const *series, size_t l, size_t n,
-    int const *b, inform_dist *joint, inform_dist **marginals)
+inline static void accumulate(inform_view const *series, size_t l, size_t n,
+    int const *b, int *codes, inform_dist *joint, inform_dist **marginals)
 {
+    ptrdiff_t const stride = series->time_stride;
     joint->counts = n;
     for (size_t i = 0; i < l; ++i)
     {
+        int const *x = inform_view_row(series, i, 0);
         marginals[i]->counts = n;
-    }
-
-    for (size_t i = 0; i < n; ++i)
-    {
-        size_t joint_event = 0;
-        for (size_t j = 0; j < l; ++j)
+        for (size_t j = 0; j < n; ++j)
         {
-            joint_event = joint_event * b[j] + series[i + n * j];
-            marginals[j]->histogram[series[i + n * j]]++;
+            marginals[i]->histogram[x[(ptrdiff_t) j * stride]]++;
         }
-        joint->histogram[joint_event]++;
     }
-}
 
-inline static void free_all(inform_dist **joint, inform_dist **marginals,
-    size_t l)
-{
-    inform_dist_free(*joint);
-    for (size_t i = 0; i < l; ++i)
+    inform_encoder_columns_strided(series->data, stride, series->var_stride,
+        l, n, b, codes);
+    for (size_t i = 0; i < n; ++i)
     {
-        inform_dist_free(marginals[i]);
+        joint->histogram[codes[i]]++;
     }
-    free(marginals);
 }
 
-double inform_mutual_info(int const *series, size_t l, size_t n, int const *b,
-    inform_error *err)
+static double mutual_info(inform_view const *series, size_t l, size_t n,
+    int const *b, inform_estimator est, inform_error *err)
 {
     if (check_arguments(series, l, n, b, err)) return NAN;
+    if (!inform_estimator_is_valid(est))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NAN);
+    }
 
-    inform_dist **marginals = malloc(l * sizeof(inform_dist*));
-    if (marginals == NULL)
+    int *codes = malloc(n * sizeof(int));
+    if (codes == NULL)
     {
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
     }
-    inform_dist *joint = NULL;
-    if (allocate(b, l, &joint, marginals, err))
+    inform_dist joint, **marginals;
+    void *block = allocate(b, l, &joint, &marginals, err);
+    if (block == NULL)
     {
-        free(marginals);
+        free(codes);
         return NAN;
     }
 
-    accumulate(series, l, n, b, joint, marginals);
+    accumulate(series, l, n, b, codes, &joint, marginals);
 
-    double mi = inform_shannon_multi_mi(joint, (inform_dist const **)marginals, l, 2.0);
+    double mi = inform_shannon_multi_mi_est(&joint,
+        (inform_dist const **)marginals, l, 2.0, est);
 
-    free_all(&joint, marginals, l);
+    free(block);
+    free(codes);
 
     return mi;
 }
 
-double *inform_local_mutual_info(int const *series, size_t l, size_t n,
-    int const *b, double *mi, inform_error *err)
+static double *local_mutual_info(inform_view const *series, size_t l,
+    size_t n, int const *b, double *mi, inform_error *err)
 {
     if (check_arguments(series, l, n, b, err)) return NULL;
 
@@ -141,41 +178,331 @@ double *inform_local_mutual_info(int const *series, size_t l, size_t n,
         }
     }
 
-    inform_dist **marginals = malloc(l * sizeof(inform_dist*));
-    if (marginals == NULL)
+    int *codes = malloc(n * sizeof(int));
+    if (codes == NULL)
     {
+        if (allocate_mi) free(mi);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
-    inform_dist *joint = NULL;
-    if (allocate(b, l, &joint, marginals, err))
+    inform_dist joint, **marginals;
+    void *block = allocate(b, l, &joint, &marginals, err);
+    if (block == NULL)
     {
         if (allocate_mi) free(mi);
-        free(marginals);
+        free(codes);
         return NULL;
     }
 
-    accumulate(series, l, n, b, joint, marginals);
+    accumulate(series, l, n, b, codes, &joint, marginals);
 
     double norm = 1;
     for (size_t i = 0; i < l; ++i) norm *= marginals[i]->counts;
-    norm /= joint->counts;
+    norm /= joint.counts;
 
     double j, m;
     for (size_t i = 0; i < n; ++i)
     {
         m = 1;
-        size_t joint_event = 0;
         for (size_t j = 0; j < l; ++j)
         {
-            int marginal_event = series[i + n * j];
-            m *= marginals[j]->histogram[marginal_event];
-            joint_event = joint_event * b[j] + marginal_event;
+            int const *x = inform_view_row(series, j, 0);
+            m *= marginals[j]->histogram[x[(ptrdiff_t) i * series->time_stride]];
         }
-        j = joint->histogram[joint_event];
+        j = joint.histogram[codes[i]];
         mi[i] = log2((j * norm) / m);
     }
 
-    free_all(&joint, marginals, l);
+    free(block);
+    free(codes);
+
+    return mi;
+}
+
+/*
+ * Pairwise mutual information is computed over square tiles of at most
+ * MI_TILE variables on a side, one tile per task. The tile is shrunk until
+ * the joint histograms of all of its pairs fit in MI_TILE_SUPPORT counts, so
+ * that they stay in cache while the tile's series are streamed through in
+ * blocks of MI_BLOCK time steps.
+ */
+#define MI_TILE 16
+#define MI_TILE_SUPPORT (1 << 16)
+#define MI_BLOCK 4096
+
+typedef struct mi_matrix
+{
+    inform_view const *series;
+    size_t l, n;
+    int const *b;
+    double const *entropy;
+    size_t width;
+    size_t const *tiles;
+    double *mi;
+} mi_matrix;
+
+static size_t tile_width(int const *b, size_t l)
+{
+    size_t bmax = 0;
+    for (size_t i = 0; i < l; ++i)
+    {
+        if ((size_t) b[i] > bmax) bmax = b[i];
+    }
+    size_t width = MI_TILE;
+    while (width > 1 && width * width * bmax * bmax > MI_TILE_SUPPORT)
+    {
+        --width;
+    }
+    return width;
+}
+
+static void mi_tile(size_t task, void *context)
+{
+    mi_matrix const *m = context;
+    inform_view const *series = m->series;
+    ptrdiff_t const stride = series->time_stride;
+    size_t const l = m->l, n = m->n;
+    int const *b = m->b;
+
+    size_t const i0 = m->tiles[2 * task] * m->width;
+    size_t const j0 = m->tiles[2 * task + 1] * m->width;
+    size_t const i1 = (i0 + m->width < l) ? i0 + m->width : l;
+    size_t const j1 = (j0 + m->width < l) ? j0 + m->width : l;
+
+    size_t offset[MI_TILE * MI_TILE], support = 0;
+    for (size_t i = i0; i < i1; ++i)
+    {
+        for (size_t j = (j0 > i) ? j0 : i + 1; j < j1; ++j)
+        {
+            offset[(i - i0) * MI_TILE + (j - j0)] = support;
+            support += (size_t) b[i] * b[j];
+        }
+    }
+
+    uint32_t *histogram = calloc(support, sizeof(uint32_t));
+    if (histogram == NULL)
+    {
+        for (size_t i = i0; i < i1; ++i)
+        {
+            for (size_t j = (j0 > i) ? j0 : i + 1; j < j1; ++j)
+            {
+                m->mi[i * l + j] = m->mi[j * l + i] = NAN;
+            }
+        }
+        return;
+    }
+
+    for (size_t t0 = 0; t0 < n; t0 += MI_BLOCK)
+    {
+        size_t const w = (n - t0 < MI_BLOCK) ? n - t0 : MI_BLOCK;
+        for (size_t i = i0; i < i1; ++i)
+        {
+            int const *x = inform_view_row(series, i, 0) + (ptrdiff_t) t0 * stride;
+            for (size_t j = (j0 > i) ? j0 : i + 1; j < j1; ++j)
+            {
+                int const *y = inform_view_row(series, j, 0) + (ptrdiff_t) t0 * stride;
+                uint32_t *h = histogram + offset[(i - i0) * MI_TILE + (j - j0)];
+                int const bj = b[j];
+                for (size_t t = 0; t < w; ++t)
+                {
+                    ptrdiff_t const k = (ptrdiff_t) t * stride;
+                    h[x[k] * bj + y[k]]++;
+                }
+            }
+        }
+    }
+
+    for (size_t i = i0; i < i1; ++i)
+    {
+        for (size_t j = (j0 > i) ? j0 : i + 1; j < j1; ++j)
+        {
+            inform_dist const joint = {
+                histogram + offset[(i - i0) * MI_TILE + (j - j0)],
+                (size_t) b[i] * b[j],
+                n
+            };
+            double const mi = m->entropy[i] + m->entropy[j]
+                - inform_shannon_entropy(&joint, 2.0);
+            m->mi[i * l + j] = m->mi[j * l + i] = mi;
+        }
+    }
+
+    free(histogram);
+}
+
+static double *mutual_info_matrix(inform_view const *series, size_t l,
+    size_t n, int const *b, double *mi, inform_config const *config,
+    inform_error *err)
+{
+    if (check_series(series, l, n, b, config->validation, err)) return NULL;
+    if (config->histogram != INFORM_HISTOGRAM_AUTO
+        && config->histogram != INFORM_HISTOGRAM_DENSE)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+
+    int first = 0, second = 0;
+    for (size_t i = 0; i < l; ++i)
+    {
+        if (b[i] > first)
+        {
+            second = first;
+            first = b[i];
+        }
+        else if (b[i] > second)
+        {
+            second = b[i];
+        }
+    }
+    if ((uint64_t) first * second > INT_MAX)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NULL);
+    }
+
+    size_t const width = tile_width(b, l);
+    size_t const ntiles = (l + width - 1) / width;
+    size_t const ntasks = ntiles * (ntiles + 1) / 2;
+
+    size_t marginal_support = 0;
+    for (size_t i = 0; i < l; ++i) marginal_support += b[i];
+
+    size_t const block_size = l * sizeof(double)
+        + 2 * ntasks * sizeof(size_t) + marginal_support * sizeof(uint32_t);
+
+    /*
+     * Each running tile holds at most MI_TILE_SUPPORT counts, unless the tile
+     * is a single pair with a larger joint support. Run only as many tiles
+     * at once as fit in the memory budget.
+     */
+    uint64_t const pair_support = (uint64_t) first * second;
+    uint64_t const tile_size = sizeof(uint32_t)
+        * ((pair_support > MI_TILE_SUPPORT) ? pair_support : MI_TILE_SUPPORT);
+    size_t threads = config->threads;
+    if (config->memory != 0)
+    {
+        if (config->memory < block_size + tile_size)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EBUDGET, NULL);
+        }
+        size_t const fit = (config->memory - block_size) / tile_size;
+        if (threads == 0 || fit < threads) threads = fit;
+    }
+
+    bool allocate_mi = (mi == NULL);
+    if (allocate_mi)
+    {
+        mi = malloc(l * l * sizeof(double));
+        if (mi == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    char *block = calloc(1, block_size);
+    if (block == NULL)
+    {
+        if (allocate_mi) free(mi);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    double *entropy = (double*) block;
+    size_t *tiles = (size_t*) (entropy + l);
+    uint32_t *histogram = (uint32_t*) (tiles + 2 * ntasks);
+
+    for (size_t i = 0; i < l; ++i)
+    {
+        int const *x = inform_view_row(series, i, 0);
+        for (size_t t = 0; t < n; ++t)
+        {
+            histogram[x[(ptrdiff_t) t * series->time_stride]]++;
+        }
+        inform_dist const marginal = { histogram, (size_t) b[i], n };
+        entropy[i] = inform_shannon_entropy(&marginal, 2.0);
+        mi[i * l + i] = entropy[i];
+        histogram += b[i];
+    }
+
+    for (size_t I = 0, k = 0; I < ntiles; ++I)
+    {
+        for (size_t J = I; J < ntiles; ++J, ++k)
+        {
+            tiles[2 * k] = I;
+            tiles[2 * k + 1] = J;
+        }
+    }
+
+    mi_matrix context = { series, l, n, b, entropy, width, tiles, mi };
+    inform_parallel_for_pool(config->pool, threads, ntasks, mi_tile,
+        &context);
+
+    free(block);
+
+    for (size_t i = 0; i < l; ++i)
+    {
+        for (size_t j = i + 1; j < l; ++j)
+        {
+            if (isnan(mi[i * l + j]))
+            {
+                if (allocate_mi) free(mi);
+                INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+            }
+        }
+    }
 
     return mi;
-}
\ No newline at end of file
+}
+
+double inform_mutual_info(int const *series, size_t l, size_t n, int const *b,
+    inform_error *err)
+{
+    inform_view const view = inform_view_contiguous(series, 1, n);
+    return mutual_info(&view, l, n, b, INFORM_PLUGIN, err);
+}
+
+double inform_mutual_info_est(int const *series, size_t l, size_t n,
+    int const *b, inform_estimator est, inform_error *err)
+{
+    inform_view const view = inform_view_contiguous(series, 1, n);
+    return mutual_info(&view, l, n, b, est, err);
+}
+
+double *inform_local_mutual_info(int const *series, size_t l, size_t n,
+    int const *b, double *mi, inform_error *err)
+{
+    inform_view const view = inform_view_contiguous(series, 1, n);
+    return local_mutual_info(&view, l, n, b, mi, err);
+}
+
+double inform_mutual_info_view(inform_view series, size_t l, size_t n,
+    int const *b, inform_error *err)
+{
+    return mutual_info(&series, l, n, b, INFORM_PLUGIN, err);
+}
+
+double *inform_local_mutual_info_view(inform_view series, size_t l, size_t n,
+    int const *b, double *mi, inform_error *err)
+{
+    return local_mutual_info(&series, l, n, b, mi, err);
+}
+
+double *inform_mutual_info_matrix(int const *series, size_t l, size_t n,
+    int const *b, double *mi, inform_error *err)
+{
+    inform_view const view = inform_view_contiguous(series, 1, n);
+    inform_config const config = inform_config_default();
+    return mutual_info_matrix(&view, l, n, b, mi, &config, err);
+}
+
+double *inform_mutual_info_matrix_ex(int const *series, size_t l, size_t n,
+    int const *b, double *mi, inform_config const *config, inform_error *err)
+{
+    inform_view const view = inform_view_contiguous(series, 1, n);
+    inform_config resolved;
+    if (inform_config_resolve(config, &resolved, err)) return NULL;
+    return mutual_info_matrix(&view, l, n, b, mi, &resolved, err);
+}
+
+double *inform_mutual_info_matrix_view(inform_view series, size_t l, size_t n,
+    int const *b, double *mi, inform_error *err)
+{
+    inform_config const config = inform_config_default();
+    return mutual_info_matrix(&series, l, n, b, mi, &config, err);
+}
@@ -0,0 +1,451 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include "parallel.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef INFORM_HAVE_PTHREADS
+#include <pthread.h>
+#include <unistd.h>
+
+/*
+ * The indices [begin, end) of a job which one participant has yet to run.
+ * The owner takes indices from the front, and participants which have run
+ * out of indices steal the back half.
+ */
+typedef struct parallel_range
+{
+    pthread_mutex_t lock;
+    size_t begin, end;
+} parallel_range;
+
+/*
+ * A call to inform_parallel_for, open to the pool's threads from its
+ * submission until its caller has run out of indices. Each participant owns
+ * one of the `width` ranges; the caller owns the first. The caller waits for
+ * the `active` helpers before returning.
+ */
+typedef struct parallel_job
+{
+    struct parallel_job *next;
+    inform_task task;
+    void *context;
+    parallel_range *ranges;
+    size_t width, joined, active;
+    pthread_cond_t done;
+} parallel_job;
+
+struct inform_pool
+{
+    pthread_mutex_t lock;
+    pthread_cond_t wake, idle;
+    parallel_job *jobs;
+    size_t size;
+    pthread_t *workers;
+    size_t nworkers;
+    inform_pool_submit submit;
+    void *host;
+    size_t pending;
+    bool shutdown;
+};
+
+/* whether the current thread is running tasks for a pool */
+static _Thread_local bool in_task = false;
+
+static pthread_once_t builtin_once = PTHREAD_ONCE_INIT;
+static inform_pool *builtin = NULL;
+static inform_pool *shared = NULL;
+
+static size_t processors(void)
+{
+    long const nprocs = sysconf(_SC_NPROCESSORS_ONLN);
+    return (nprocs > 1) ? (size_t) nprocs : 1;
+}
+
+static bool steal(parallel_job *job, size_t thief)
+{
+    for (size_t k = 1; k < job->width; ++k)
+    {
+        parallel_range *victim = job->ranges + (thief + k) % job->width;
+        pthread_mutex_lock(&victim->lock);
+        size_t const taken = (victim->end - victim->begin + 1) / 2;
+        size_t const end = victim->end;
+        victim->end -= taken;
+        pthread_mutex_unlock(&victim->lock);
+        if (taken != 0)
+        {
+            parallel_range *own = job->ranges + thief;
+            pthread_mutex_lock(&own->lock);
+            own->begin = end - taken;
+            own->end = end;
+            pthread_mutex_unlock(&own->lock);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void participate(parallel_job *job, size_t slot)
+{
+    parallel_range *own = job->ranges + slot;
+    while (true)
+    {
+        size_t i = SIZE_MAX;
+        pthread_mutex_lock(&own->lock);
+        if (own->begin < own->end)
+        {
+            i = own->begin++;
+        }
+        pthread_mutex_unlock(&own->lock);
+        if (i != SIZE_MAX)
+        {
+            job->task(i, job->context);
+        }
+        else if (!steal(job, slot))
+        {
+            return;
+        }
+    }
+}
+
+/*
+ * Join the oldest open job with a range to spare. The pool must be locked.
+ */
+static parallel_job *join(inform_pool *pool, size_t *slot)
+{
+    for (parallel_job *job = pool->jobs; job != NULL; job = job->next)
+    {
+        if (job->joined < job->width)
+        {
+            *slot = job->joined++;
+            job->active++;
+            return job;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Leave a job, waking its caller if this was the last helper. The pool must
+ * be locked.
+ */
+static void leave(parallel_job *job)
+{
+    if (--job->active == 0)
+    {
+        pthread_cond_signal(&job->done);
+    }
+}
+
+static void *pool_worker(void *arg)
+{
+    inform_pool *pool = arg;
+    in_task = true;
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->shutdown)
+    {
+        size_t slot;
+        parallel_job *job = join(pool, &slot);
+        if (job == NULL)
+        {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&pool->lock);
+        participate(job, slot);
+        pthread_mutex_lock(&pool->lock);
+        leave(job);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+/*
+ * Run on a thread of the host's pool. By the time it runs, the job which
+ * prompted its submission may be long gone, in which case it joins another
+ * or simply returns.
+ */
+static void pool_helper(void *arg)
+{
+    inform_pool *pool = arg;
+    bool const nested = in_task;
+    pthread_mutex_lock(&pool->lock);
+    size_t slot;
+    parallel_job *job = join(pool, &slot);
+    if (job != NULL)
+    {
+        pthread_mutex_unlock(&pool->lock);
+        in_task = true;
+        participate(job, slot);
+        in_task = nested;
+        pthread_mutex_lock(&pool->lock);
+        leave(job);
+    }
+    if (--pool->pending == 0)
+    {
+        pthread_cond_broadcast(&pool->idle);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static inform_pool *pool_alloc(size_t nthreads, inform_pool_submit submit,
+    void *host, inform_error *err)
+{
+    inform_pool *pool = calloc(1, sizeof(inform_pool));
+    if (pool == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    pool->size = (nthreads == 0) ? processors() : nthreads;
+    pool->submit = submit;
+    pool->host = host;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+
+    if (submit == NULL && pool->size > 1)
+    {
+        pool->workers = malloc((pool->size - 1) * sizeof(pthread_t));
+        while (pool->workers != NULL && pool->nworkers < pool->size - 1)
+        {
+            if (pthread_create(pool->workers + pool->nworkers, NULL,
+                pool_worker, pool) != 0)
+            {
+                break;
+            }
+            pool->nworkers++;
+        }
+        if (pool->nworkers < pool->size - 1)
+        {
+            inform_pool_free(pool);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+    return pool;
+}
+
+static void builtin_alloc(void)
+{
+    builtin = pool_alloc(0, NULL, NULL, NULL);
+}
+
+static inform_pool *default_pool(void)
+{
+    if (shared != NULL)
+    {
+        return shared;
+    }
+    pthread_once(&builtin_once, builtin_alloc);
+    return builtin;
+}
+
+inform_pool *inform_pool_alloc(size_t nthreads, inform_error *err)
+{
+    return pool_alloc(nthreads, NULL, NULL, err);
+}
+
+inform_pool *inform_pool_alloc_shared(size_t nthreads,
+    inform_pool_submit submit, void *host, inform_error *err)
+{
+    if (submit == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+    return pool_alloc(nthreads, submit, host, err);
+}
+
+void inform_pool_free(inform_pool *pool)
+{
+    if (pool == NULL)
+    {
+        return;
+    }
+    if (shared == pool)
+    {
+        shared = NULL;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->wake);
+    while (pool->pending != 0)
+    {
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = 0; i < pool->nworkers; ++i)
+    {
+        pthread_join(pool->workers[i], NULL);
+    }
+    free(pool->workers);
+    pthread_cond_destroy(&pool->idle);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+size_t inform_pool_size(inform_pool const *pool)
+{
+    if (pool == NULL)
+    {
+        pool = default_pool();
+    }
+    return (pool == NULL) ? 1 : pool->size;
+}
+
+void inform_pool_set_default(inform_pool *pool)
+{
+    shared = pool;
+}
+
+size_t inform_parallel_threads(void)
+{
+    return in_task ? 1 : inform_pool_size(NULL);
+}
+
+void inform_parallel_for(size_t n, inform_task task, void *context)
+{
+    inform_parallel_for_pool(NULL, 0, n, task, context);
+}
+
+void inform_parallel_for_pool(inform_pool *pool, size_t nthreads, size_t n,
+    inform_task task, void *context)
+{
+    pool = (pool == NULL) ? default_pool() : pool;
+    size_t width = (pool == NULL || in_task) ? 1 : pool->size;
+    width = (nthreads != 0 && nthreads < width) ? nthreads : width;
+    width = (n < width) ? n : width;
+
+    parallel_range *ranges = NULL;
+    if (width > 1)
+    {
+        ranges = malloc(width * sizeof(parallel_range));
+    }
+    if (ranges == NULL)
+    {
+        for (size_t i = 0; i < n; ++i) task(i, context);
+        return;
+    }
+
+    size_t const share = n / width, extra = n % width;
+    for (size_t k = 0, begin = 0; k < width; ++k)
+    {
+        pthread_mutex_init(&ranges[k].lock, NULL);
+        ranges[k].begin = begin;
+        ranges[k].end = begin += share + (k < extra);
+    }
+    parallel_job job = {
+        .next = NULL, .task = task, .context = context, .ranges = ranges,
+        .width = width, .joined = 1, .active = 0
+    };
+    pthread_cond_init(&job.done, NULL);
+
+    pthread_mutex_lock(&pool->lock);
+    parallel_job **tail = &pool->jobs;
+    while (*tail != NULL) tail = &(*tail)->next;
+    *tail = &job;
+    if (pool->submit != NULL)
+    {
+        pool->pending += width - 1;
+    }
+    else
+    {
+        pthread_cond_broadcast(&pool->wake);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (pool->submit != NULL)
+    {
+        for (size_t k = 1; k < width; ++k)
+        {
+            pool->submit(pool_helper, pool, pool->host);
+        }
+    }
+
+    in_task = true;
+    participate(&job, 0);
+    in_task = false;
+
+    /* close the job to latecomers, and wait for the helpers still in it */
+    pthread_mutex_lock(&pool->lock);
+    tail = &pool->jobs;
+    while (*tail != &job) tail = &(*tail)->next;
+    *tail = job.next;
+    while (job.active != 0)
+    {
+        pthread_cond_wait(&job.done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_cond_destroy(&job.done);
+    for (size_t k = 0; k < width; ++k)
+    {
+        pthread_mutex_destroy(&ranges[k].lock);
+    }
+    free(ranges);
+}
+
+#else
+
+struct inform_pool
+{
+    size_t size;
+};
+
+inform_pool *inform_pool_alloc(size_t nthreads, inform_error *err)
+{
+    inform_pool *pool = malloc(sizeof(inform_pool));
+    if (pool == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    pool->size = 1;
+    return pool;
+}
+
+inform_pool *inform_pool_alloc_shared(size_t nthreads,
+    inform_pool_submit submit, void *host, inform_error *err)
+{
+    (void) host;
+    if (submit == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+    return inform_pool_alloc(nthreads, err);
+}
+
+void inform_pool_free(inform_pool *pool)
+{
+    free(pool);
+}
+
+size_t inform_pool_size(inform_pool const *pool)
+{
+    (void) pool;
+    return 1;
+}
+
+void inform_pool_set_default(inform_pool *pool)
+{
+    (void) pool;
+}
+
+size_t inform_parallel_threads(void)
+{
+    return 1;
+}
+
+void inform_parallel_for(size_t n, inform_task task, void *context)
+{
+    for (size_t i = 0; i < n; ++i) task(i, context);
+}
+
+void inform_parallel_for_pool(inform_pool *pool, size_t nthreads, size_t n,
+    inform_task task, void *context)
+{
+    (void) pool;
+    (void) nthreads;
+    inform_parallel_for(n, task, context);
+}
+
+#endif
@@ -0,0 +1,49 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/pool.h>
+#include <stdlib.h>
+
+/**
+ * A unit of work to be executed by `inform_parallel_for`. The first argument
+ * is the index of the task and the second is the context passed to
+ * `inform_parallel_for`.
+ */
+typedef void (*inform_task)(size_t i, void *context);
+
+/**
+ * Determine the number of threads available for parallel work.
+ *
+ * @return the number of threads in the default pool, or 1 if threading is
+ *         unsupported or the caller is itself running a task
+ */
+size_t inform_parallel_threads(void);
+
+/**
+ * Execute `task(i, context)` for each `i` in `[0, n)`, distributing the tasks
+ * across the threads of the default pool. The calling thread participates in
+ * the work, and the function returns once every task has completed. Tasks are
+ * run in no particular order, so they must only write to disjoint memory. If
+ * called from within a task, the tasks are run serially.
+ *
+ * @param[in] n       the number of tasks
+ * @param[in] task    the function to call for each task
+ * @param[in] context an opaque pointer passed to each task
+ */
+void inform_parallel_for(size_t n, inform_task task, void *context);
+
+/**
+ * Execute `task(i, context)` for each `i` in `[0, n)` as does
+ * `inform_parallel_for`, but on the given pool, and on at most `nthreads` of
+ * its threads, including the calling thread.
+ *
+ * @param[in] pool     the pool (or `NULL` for the default)
+ * @param[in] nthreads the greatest number of threads to use (or 0 for all)
+ * @param[in] n        the number of tasks
+ * @param[in] task     the function to call for each task
+ * @param[in] context  an opaque pointer passed to each task
+ */
+void inform_parallel_for_pool(inform_pool *pool, size_t nthreads, size_t n,
+    inform_task task, void *context);
@@ -5,11 +5,17 @@
 #include <inform/pid.h>
 #include <inform/dist.h>
 #include <inform/utilities.h>
-#include <inform/utilities/black_boxing.h>
 #include <inform/utilities/encoding.h>
 #include <string.h>
 #include <math.h>
 
+#include "encoder.h"
+#include "parallel.h"
+
+#ifdef INFORM_HAVE_PTHREADS
+#include <pthread.h>
+#endif
+
 #define FAILED(ERR) ((ERR) && *(ERR) != INFORM_SUCCESS)
 
 #define MAKE_PUSH(NAME, TYPE) \
@@ -428,90 +434,251 @@ static inform_pid_lattice *hasse(size_t n, inform_error *err)
     return lattice;
 }
 
-static size_t **subsets(size_t n, inform_error *err)
+/*
+ * The shape of the redundancy lattice of some number of sources, without the
+ * values of any particular decomposition. The nodes are in the topological
+ * order of `hasse`. The name of node `i` is `names[name_offsets[i]]` through
+ * `names[name_offsets[i+1] - 1]`, the subsets of the antichain encoded as
+ * bitmasks of the sources; the indices of the nodes which cover it, and which
+ * it covers, are stored likewise in `above` and `below`. Everything is held
+ * in the single block at `name_offsets`.
+ */
+typedef struct pid_shape
 {
-    if (n < 1)
+    size_t size;
+    size_t *name_offsets, *names;
+    size_t *above_offsets, *above;
+    size_t *below_offsets, *below;
+} pid_shape;
+
+typedef struct node_index
+{
+    inform_pid_source const *node;
+    size_t index;
+} node_index;
+
+static int compare_nodes(void const *a, void const *b)
+{
+    uintptr_t const x = (uintptr_t) ((node_index const *) a)->node;
+    uintptr_t const y = (uintptr_t) ((node_index const *) b)->node;
+    return (x > y) - (x < y);
+}
+
+static size_t node_lookup(node_index const *index, size_t n,
+        inform_pid_source const *node)
+{
+    node_index const key = { node, 0 };
+    node_index const *found = bsearch(&key, index, n, sizeof(node_index),
+        compare_nodes);
+    return found->index;
+}
+
+/*
+ * Flatten a lattice constructed by `hasse`, replacing each pointer to a node
+ * by that node's index.
+ */
+static pid_shape *flatten(inform_pid_lattice const *lattice,
+        inform_error *err)
+{
+    size_t const n = lattice->size;
+    size_t names = 0, edges = 0;
+    for (size_t i = 0; i < n; ++i)
     {
-        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+        names += lattice->sources[i]->size;
+        edges += lattice->sources[i]->n_above;
     }
-    size_t m = 1 << n;
-    size_t **ss = gvector_alloc(m - 1, m - 1, sizeof(size_t*));
-    memset(ss, 0, sizeof(size_t*)*gvector_len(ss));
-    if (!ss)
+
+    pid_shape *shape = malloc(sizeof(pid_shape));
+    node_index *index = malloc(n * sizeof(node_index));
+    size_t *data = malloc((3 * (n + 1) + names + 2 * edges) * sizeof(size_t));
+    if (!shape || !index || !data)
     {
+        free(data);
+        free(index);
+        free(shape);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
-    for (size_t i = 1; i < m; ++i)
+
+    shape->size = n;
+    shape->name_offsets  = data;
+    shape->above_offsets = shape->name_offsets + n + 1;
+    shape->below_offsets = shape->above_offsets + n + 1;
+    shape->names         = shape->below_offsets + n + 1;
+    shape->above         = shape->names + names;
+    shape->below         = shape->above + edges;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        index[i] = (node_index){ lattice->sources[i], i };
+    }
+    qsort(index, n, sizeof(node_index), compare_nodes);
+
+    shape->name_offsets[0] = shape->above_offsets[0] = shape->below_offsets[0] = 0;
+    for (size_t i = 0; i < n; ++i)
     {
-        size_t *s = gvector_alloc(n, 0, sizeof(size_t));
-        if (!s)
+        inform_pid_source const *src = lattice->sources[i];
+
+        size_t *name = shape->names + shape->name_offsets[i];
+        memcpy(name, src->name, src->size * sizeof(size_t));
+        shape->name_offsets[i + 1] = shape->name_offsets[i] + src->size;
+
+        size_t *above = shape->above + shape->above_offsets[i];
+        for (size_t j = 0; j < src->n_above; ++j)
         {
-            for (size_t j = 0; j < gvector_len(ss); ++j)
-            {
-                gvector_free(ss[j]);
-            }
-            gvector_free(ss);
-            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+            above[j] = node_lookup(index, n, src->above[j]);
         }
-        for (size_t j = 0; j < n; ++j)
+        shape->above_offsets[i + 1] = shape->above_offsets[i] + src->n_above;
+
+        size_t *below = shape->below + shape->below_offsets[i];
+        for (size_t j = 0; j < src->n_below; ++j)
         {
-            if ((i & (1 << j)) != 0)
-            {
-                size_t *t = push_value(s,j);
-                if (!t)
-                {
-                    gvector_free(s);
-                    for (size_t k = 0; k < gvector_len(ss); ++k)
-                    {
-                        gvector_free(ss[k]);
-                    }
-                    gvector_free(ss);
-                    INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-                }
-                s = t;
-            }
+            below[j] = node_lookup(index, n, src->below[j]);
         }
-        size_t *t = gvector_shrink(s);
-        if (!t)
+        shape->below_offsets[i + 1] = shape->below_offsets[i] + src->n_below;
+    }
+
+    free(index);
+    return shape;
+}
+
+/*
+ * The lattice of each number of sources is constructed at most once per
+ * process, on first use, and shared by every later decomposition. Since the
+ * subsets of sources are bitmasks, there can be no more sources than bits in
+ * a `size_t`.
+ */
+#define PID_MAX_SOURCES (8 * sizeof(size_t))
+
+static pid_shape *shape_cache[PID_MAX_SOURCES];
+
+#ifdef INFORM_HAVE_PTHREADS
+static pthread_mutex_t shape_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static pid_shape const *shape(size_t n, inform_error *err)
+{
+    if (n < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, NULL);
+    }
+    else if (n >= PID_MAX_SOURCES)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+
+#ifdef INFORM_HAVE_PTHREADS
+    pthread_mutex_lock(&shape_lock);
+#endif
+    if (shape_cache[n] == NULL)
+    {
+        inform_pid_lattice *lattice = hasse(n, err);
+        if (lattice != NULL)
         {
-            gvector_free(s);
-            for (size_t j = 0; j < gvector_len(ss); ++j)
-            {
-                gvector_free(ss[j]);
-            }
-            gvector_free(ss);
-            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+            shape_cache[n] = flatten(lattice, err);
         }
-        s = t;
-        ss[i-1] = s;
+        inform_pid_lattice_free(lattice);
     }
-    return ss;
+    pid_shape const *result = shape_cache[n];
+#ifdef INFORM_HAVE_PTHREADS
+    pthread_mutex_unlock(&shape_lock);
+#endif
+
+    return result;
 }
 
-static double *specific_info(int const *stimulus, int const *responses,
-        size_t l, size_t n, int bs, int const *br, size_t const *source,
-        inform_dist const *s_dist, inform_error *err)
+/*
+ * Construct a lattice of `inform_pid_source` nodes with the given shape.
+ */
+static inform_pid_lattice *unflatten(pid_shape const *shape,
+        inform_error *err)
 {
-    size_t const u = gvector_len(source);
+    size_t const n = shape->size;
+    inform_pid_lattice *lattice = inform_pid_lattice_alloc(err);
+    if (FAILED(err))
+    {
+        return NULL;
+    }
 
-    int *box = gvector_alloc((u + 1) * n, (u + 1) * n, sizeof(int));
-    if (box == NULL)
+    lattice->sources = gvector_alloc(n, n, sizeof(inform_pid_source*));
+    if (!lattice->sources)
     {
+        inform_pid_lattice_free(lattice);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
-    for (size_t i = 0; i < u; ++i)
+    memset(lattice->sources, 0, n * sizeof(inform_pid_source*));
+
+    for (size_t i = 0; i < n; ++i)
     {
-        memcpy(box + i*n, responses + source[i]*n, n*sizeof(int));
+        inform_pid_source *src = calloc(1, sizeof(inform_pid_source));
+        lattice->sources[i] = src;
+        if (!src)
+        {
+            inform_pid_lattice_free(lattice);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+        src->size = shape->name_offsets[i + 1] - shape->name_offsets[i];
+        src->n_above = shape->above_offsets[i + 1] - shape->above_offsets[i];
+        src->n_below = shape->below_offsets[i + 1] - shape->below_offsets[i];
+        src->name = gvector_alloc(src->size, src->size, sizeof(size_t));
+        src->above = gvector_alloc(src->n_above, src->n_above,
+            sizeof(inform_pid_source*));
+        src->below = gvector_alloc(src->n_below, src->n_below,
+            sizeof(inform_pid_source*));
+        if (!src->name || !src->above || !src->below)
+        {
+            inform_pid_lattice_free(lattice);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+        memcpy(src->name, shape->names + shape->name_offsets[i],
+            src->size * sizeof(size_t));
     }
-    inform_black_box(box, u, 1, n, br, NULL, NULL, box + u*n, err);
-    if (inform_failed(err))
+
+    for (size_t i = 0; i < n; ++i)
     {
-        gvector_free(box);
-        return NULL;
+        inform_pid_source *src = lattice->sources[i];
+        size_t const *above = shape->above + shape->above_offsets[i];
+        for (size_t j = 0; j < src->n_above; ++j)
+        {
+            src->above[j] = lattice->sources[above[j]];
+        }
+        size_t const *below = shape->below + shape->below_offsets[i];
+        for (size_t j = 0; j < src->n_below; ++j)
+        {
+            src->below[j] = lattice->sources[below[j]];
+        }
+    }
+
+    lattice->bottom = lattice->sources[0];
+    lattice->top = lattice->sources[n - 1];
+    lattice->size = n;
+
+    return lattice;
+}
+
+/*
+ * Compute the specific information about each stimulus of the `u` responses
+ * `source`, writing it to the `bs` elements of `si`.
+ */
+static bool specific_info(int const *stimulus, int const *responses,
+        size_t n, int bs, int const *br, size_t const *source, size_t u,
+        inform_dist const *s_dist, double *si, inform_error *err)
+{
+    uint64_t support;
+    int bases[PID_MAX_SOURCES];
+    for (size_t i = 0; i < u; ++i) bases[i] = br[source[i]];
+    if (!inform_encoder_support(bases, u, INT_MAX / bs, &support))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
+    }
+    int const b = (int) support;
+
+    int *box = gvector_alloc(n, n, sizeof(int));
+    if (box == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
     }
-    responses = box + u*n;
-    int b = 1;
-    for (size_t i = 0; i < u; ++i) b *= br[source[i]];
+    inform_encoder_columns(responses, u, n, br, source, box);
+    responses = box;
 
     size_t const j_size = bs * b;
     size_t const r_size = b;
@@ -521,7 +688,7 @@ static double *specific_info(int const *stimulus, int const *responses,
     if (data == NULL)
     {
         gvector_free(box);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
     }
     for (size_t i = 0; i < total_size; ++i) data[i] = 0;
 
@@ -533,14 +700,6 @@ static double *specific_info(int const *stimulus, int const *responses,
         j_dist.histogram[stimulus[i] + bs * responses[i]]++;
     }
 
-    double *si = gvector_alloc(bs, bs, sizeof(double));
-    if (si == NULL)
-    {
-        gvector_free(data);
-        gvector_free(box);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-    }
-
     int joint;
     double n_stimulus, n_response, n_joint;
     for (int s = 0; s < bs; ++s)
@@ -571,33 +730,723 @@ static double *specific_info(int const *stimulus, int const *responses,
 
     gvector_free(data);
     gvector_free(box);
-    return si;
+    return false;
 }
 
-static void cleanup(size_t **subsets, inform_dist *s_dist, double **info)
+/*
+ * Compute the `(2^l - 1) x bs` matrix of the specific information of each
+ * subset of the `l` responses `vars` about each stimulus. Row `x - 1` is the
+ * subset with bitmask `x`, i.e. of those `vars[k]` for which bit `k` of `x`
+ * is set, as in the names of the lattice's nodes.
+ */
+static bool specific_info_matrix(int const *stimulus, int const *responses,
+        size_t n, int bs, int const *br, size_t const *vars, size_t l,
+        inform_dist const *s_dist, double *si, inform_error *err)
 {
-    if (subsets)
+    size_t source[PID_MAX_SOURCES];
+    for (size_t x = 1; x < ((size_t) 1 << l); ++x)
     {
-        for (size_t i = 0; i < gvector_len(subsets); ++i)
+        size_t u = 0;
+        for (size_t k = 0; k < l; ++k)
         {
-            gvector_free(subsets[i]);
+            if (x & ((size_t) 1 << k))
+            {
+                source[u++] = vars[k];
+            }
+        }
+        if (specific_info(stimulus, responses, n, bs, br, source, u, s_dist,
+            si + (x - 1) * bs, err))
+        {
+            return true;
         }
-        gvector_free(subsets);
     }
+    return false;
+}
+
+/*
+ * Evaluate the redundancy (`imin`) and partial information (`pi`) of each
+ * node of a lattice, given the `(2^l - 1) x bs` matrix `si` of the specific
+ * information of each subset of responses about each stimulus. The minimum
+ * specific information of each node's subsets is kept as a row of `mins`,
+ * which has room for one more row as scratch, so that each node's partial
+ * information is a maximum over the rows of the nodes below it.
+ */
+static void evaluate(pid_shape const *shape, double const *si,
+        inform_dist const *s_dist, size_t bs, double *mins, double *imin,
+        double *pi)
+{
+    uint32_t const *p = s_dist->histogram;
+    double const counts = (double) s_dist->counts;
 
-    if (s_dist)
+    for (size_t i = 0; i < shape->size; ++i)
     {
-        inform_dist_free(s_dist);
+        double *x = mins + i * bs;
+        size_t const *name = shape->names + shape->name_offsets[i];
+        size_t const size = shape->name_offsets[i + 1] - shape->name_offsets[i];
+        memcpy(x, si + (name[0] - 1) * bs, bs * sizeof(double));
+        for (size_t k = 1; k < size; ++k)
+        {
+            double const *y = si + (name[k] - 1) * bs;
+            for (size_t s = 0; s < bs; ++s)
+            {
+                x[s] = MIN(x[s], y[s]);
+            }
+        }
+        double total = 0.0;
+        for (size_t s = 0; s < bs; ++s)
+        {
+            total += p[s] * x[s];
+        }
+        imin[i] = total / counts;
+    }
+
+    double *u = mins + shape->size * bs;
+    for (size_t i = 0; i < shape->size; ++i)
+    {
+        for (size_t s = 0; s < bs; ++s)
+        {
+            u[s] = -INFINITY;
+        }
+        for (size_t j = shape->below_offsets[i]; j < shape->below_offsets[i + 1]; ++j)
+        {
+            double const *x = mins + shape->below[j] * bs;
+            for (size_t s = 0; s < bs; ++s)
+            {
+                u[s] = MAX(u[s], x[s]);
+            }
+        }
+        double total = 0.0;
+        for (size_t s = 0; s < bs; ++s)
+        {
+            total += p[s] * (isinf(u[s]) ? 0.0 : u[s]);
+        }
+        pi[i] = imin[i] - total / counts;
+    }
+}
+
+/*
+ * The responses over which a decomposition is computed: the `l` responses
+ * `vars` of `responses`, with the stimulus and its distribution.
+ */
+typedef struct pid_data
+{
+    int const *stimulus, *responses;
+    size_t n;
+    int bs;
+    int const *br;
+    size_t const *vars;
+    size_t l;
+    inform_dist const *s_dist;
+} pid_data;
+
+/*
+ * A redundancy measure, computing the information about the stimulus shared
+ * by each of the `size` subsets of responses in the antichain `name`, each a
+ * bitmask over the decomposition's responses as in the names of the nodes.
+ */
+typedef bool (*pid_redundancy)(pid_data const *data, size_t const *name,
+        size_t size, double *red, inform_error *err);
+
+/*
+ * The convergence tolerance and iteration limit of the iterative fits of the
+ * CCS and BROJA measures.
+ */
+#define PID_TOLERANCE 1e-12
+#define PID_MAX_ITERATIONS 100000
+
+/*
+ * Tabulate the joint distribution of the stimulus and the `size` subsets of
+ * responses in `name`, each black-boxed into a single variable. The table has
+ * `size + 1` dimensions, the stimulus first, with the extent of each written
+ * to `dims`, and the first dimension varies fastest. Since every dimension
+ * has an extent of at least two and there are at most `INT_MAX` cells, there
+ * are fewer than `PID_MAX_SOURCES` dimensions.
+ */
+static double *joint_table(pid_data const *data, size_t const *name,
+        size_t size, size_t *dims, size_t *cells, inform_error *err)
+{
+    int bases[PID_MAX_SOURCES];
+    size_t source[PID_MAX_SOURCES];
+
+    uint64_t total = (uint64_t) data->bs;
+    dims[0] = (size_t) data->bs;
+    for (size_t i = 0; i < size; ++i)
+    {
+        size_t u = 0;
+        for (size_t k = 0; k < data->l; ++k)
+        {
+            if (name[i] & ((size_t) 1 << k))
+            {
+                bases[u++] = data->br[data->vars[k]];
+            }
+        }
+        uint64_t support;
+        if (!inform_encoder_support(bases, u, INT_MAX / total, &support))
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EENCODE, NULL);
+        }
+        dims[i + 1] = (size_t) support;
+        total *= support;
+    }
+    *cells = (size_t) total;
+
+    double *table = calloc(*cells, sizeof(double));
+    int *codes = malloc(2 * data->n * sizeof(int));
+    if (table == NULL || codes == NULL)
+    {
+        free(codes);
+        free(table);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    int *joint = codes, *box = codes + data->n;
+
+    memcpy(joint, data->stimulus, data->n * sizeof(int));
+    int stride = data->bs;
+    for (size_t i = 0; i < size; ++i)
+    {
+        size_t u = 0;
+        for (size_t k = 0; k < data->l; ++k)
+        {
+            if (name[i] & ((size_t) 1 << k))
+            {
+                source[u++] = data->vars[k];
+            }
+        }
+        inform_encoder_columns(data->responses, u, data->n, data->br, source,
+            box);
+        for (size_t t = 0; t < data->n; ++t)
+        {
+            joint[t] += stride * box[t];
+        }
+        stride *= (int) dims[i + 1];
+    }
+    for (size_t t = 0; t < data->n; ++t)
+    {
+        table[joint[t]] += 1.0;
+    }
+    for (size_t c = 0; c < *cells; ++c)
+    {
+        table[c] /= (double) data->n;
+    }
+
+    free(codes);
+    return table;
+}
+
+/*
+ * Advance the `index` of a cell of a table with `k` dimensions to that of the
+ * next cell.
+ */
+static void next_cell(size_t *index, size_t const *dims, size_t k)
+{
+    for (size_t d = 0; d < k && ++index[d] == dims[d]; ++d)
+    {
+        index[d] = 0;
+    }
+}
+
+/*
+ * The cell of the marginal over the dimensions in the bitmask `keep` to
+ * which the cell with the given `index` belongs.
+ */
+static size_t project(size_t const *index, size_t const *dims, size_t k,
+        size_t keep)
+{
+    size_t cell = 0, stride = 1;
+    for (size_t d = 0; d < k; ++d)
+    {
+        if (keep & ((size_t) 1 << d))
+        {
+            cell += index[d] * stride;
+            stride *= dims[d];
+        }
+    }
+    return cell;
+}
+
+static size_t marginal_size(size_t const *dims, size_t k, size_t keep)
+{
+    size_t size = 1;
+    for (size_t d = 0; d < k; ++d)
+    {
+        if (keep & ((size_t) 1 << d))
+        {
+            size *= dims[d];
+        }
+    }
+    return size;
+}
+
+/*
+ * Sum a table with `k` dimensions onto the dimensions in the bitmask `keep`.
+ */
+static void marginalize(double const *table, size_t const *dims, size_t k,
+        size_t cells, size_t keep, double *marginal)
+{
+    memset(marginal, 0, marginal_size(dims, k, keep) * sizeof(double));
+    size_t index[PID_MAX_SOURCES] = {0};
+    for (size_t c = 0; c < cells; ++c, next_cell(index, dims, k))
+    {
+        marginal[project(index, dims, k, keep)] += table[c];
+    }
+}
+
+/*
+ * The mutual information between the first dimension of a table, the
+ * stimulus, and the rest.
+ */
+static double table_mutual_info(double const *table, size_t const *dims,
+        size_t k, size_t cells, double *scratch)
+{
+    size_t const rest = (((size_t) 1 << k) - 1) & ~(size_t) 1;
+    double *ps = scratch, *pr = scratch + dims[0];
+    marginalize(table, dims, k, cells, 1, ps);
+    marginalize(table, dims, k, cells, rest, pr);
+
+    double mi = 0.0;
+    for (size_t c = 0; c < cells; ++c)
+    {
+        if (table[c] > 0)
+        {
+            double const p = ps[c % dims[0]] * pr[c / dims[0]];
+            mi += table[c] * log2(table[c] / p);
+        }
+    }
+    return mi;
+}
+
+static int sign(double x)
+{
+    return (x > 0) - (x < 0);
+}
+
+/*
+ * Whether a bitmask has an odd number of bits set.
+ */
+static bool odd_parity(size_t x)
+{
+    bool odd = false;
+    for (; x != 0; x &= x - 1) odd = !odd;
+    return odd;
+}
+
+/*
+ * The redundancy of Ince (2017), the common change in surprisal. The joint
+ * distribution is replaced by the maximum entropy distribution `q` which
+ * preserves the joint distribution of the stimulus with each source and that
+ * of the sources, fit by iterative proportional scaling. The local
+ * co-information of each joint state is then counted as redundant if it has
+ * the same sign as the local mutual information of the stimulus with each
+ * source and with all of them.
+ */
+static bool ccs_redundancy(pid_data const *data, size_t const *name,
+        size_t size, double *red, inform_error *err)
+{
+    size_t dims[PID_MAX_SOURCES], cells;
+    double *p = joint_table(data, name, size, dims, &cells, err);
+    if (p == NULL)
+    {
+        return true;
+    }
+    size_t const k = size + 1;
+    size_t const masks = (size_t) 1 << k;
+    size_t const sources = (masks - 1) & ~(size_t) 1;
+
+    /* room for the marginal of `q` over every subset of the dimensions */
+    size_t *offsets = malloc((masks + 1) * sizeof(size_t));
+    if (offsets == NULL)
+    {
+        free(p);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+    offsets[0] = 0;
+    for (size_t keep = 0; keep < masks; ++keep)
+    {
+        offsets[keep + 1] = offsets[keep] + marginal_size(dims, k, keep);
+    }
+    double *q = malloc((cells + offsets[masks]) * sizeof(double));
+    if (q == NULL)
+    {
+        free(offsets);
+        free(p);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+    double *marginals = q + cells;
+
+    if (size == 1)
+    {
+        *red = table_mutual_info(p, dims, k, cells, marginals);
+        free(q);
+        free(offsets);
+        free(p);
+        return false;
+    }
+
+    /*
+     * The target marginals of `p` are kept in the slots of `marginals`
+     * reserved for them, and those of `q` are computed in the slot of the
+     * full table, which is as large as any other.
+     */
+    double *scratch = marginals + offsets[masks - 1];
+    for (size_t i = 1; i < k; ++i)
+    {
+        size_t const keep = 1 | ((size_t) 1 << i);
+        marginalize(p, dims, k, cells, keep, marginals + offsets[keep]);
+    }
+    marginalize(p, dims, k, cells, sources, marginals + offsets[sources]);
+
+    for (size_t c = 0; c < cells; ++c)
+    {
+        q[c] = 1.0 / (double) cells;
+    }
+    for (size_t it = 0; it < PID_MAX_ITERATIONS; ++it)
+    {
+        double delta = 0.0;
+        for (size_t i = 1; i <= k; ++i)
+        {
+            size_t const keep = (i < k) ? 1 | ((size_t) 1 << i) : sources;
+            double const *target = marginals + offsets[keep];
+            marginalize(q, dims, k, cells, keep, scratch);
+            for (size_t j = 0; j < offsets[keep + 1] - offsets[keep]; ++j)
+            {
+                delta = MAX(delta, fabs(scratch[j] - target[j]));
+            }
+            size_t index[PID_MAX_SOURCES] = {0};
+            for (size_t c = 0; c < cells; ++c, next_cell(index, dims, k))
+            {
+                size_t const j = project(index, dims, k, keep);
+                q[c] = (scratch[j] > 0) ? q[c] * target[j] / scratch[j] : 0.0;
+            }
+        }
+        if (delta < PID_TOLERANCE)
+        {
+            break;
+        }
+    }
+
+    for (size_t keep = 1; keep < masks; ++keep)
+    {
+        marginalize(q, dims, k, cells, keep, marginals + offsets[keep]);
+    }
+
+    double total = 0.0;
+    size_t index[PID_MAX_SOURCES] = {0};
+    for (size_t c = 0; c < cells; ++c, next_cell(index, dims, k))
+    {
+        if (q[c] <= 0)
+        {
+            continue;
+        }
+        double const qs = marginals[offsets[1] + index[0]];
+        double coinfo = 0.0, joint = 0.0;
+        for (size_t t = 2; t < masks; t += 2)
+        {
+            double const qst = marginals[offsets[t | 1]
+                + project(index, dims, k, t | 1)];
+            double const qt = marginals[offsets[t] + project(index, dims, k, t)];
+            double const local = log2(qst / (qs * qt));
+            coinfo += odd_parity(t) ? local : -local;
+            if (t == sources)
+            {
+                joint = local;
+            }
+        }
+        bool shared = (sign(joint) == sign(coinfo));
+        for (size_t i = 1; i < k && shared; ++i)
+        {
+            size_t const t = (size_t) 1 << i;
+            double const qst = marginals[offsets[t | 1]
+                + project(index, dims, k, t | 1)];
+            double const qt = marginals[offsets[t] + index[i]];
+            shared = (sign(log2(qst / (qs * qt))) == sign(coinfo));
+        }
+        if (shared)
+        {
+            total += q[c] * coinfo;
+        }
+    }
+    *red = total;
+
+    free(q);
+    free(offsets);
+    free(p);
+    return false;
+}
+
+/*
+ * Rescale the `n1 x n2` row-major matrix `q = r(a,b) x(a) y(b)` towards the
+ * given row and column sums by one sweep of Sinkhorn's algorithm, updating
+ * the scalings `x` and `y`. The columns sum to `cols` after the sweep, and
+ * the greatest deviation of the rows from `rows` is returned.
+ */
+static double sinkhorn(double const *r, size_t n1, size_t n2,
+        double const *rows, double const *cols, double *x, double *y,
+        double *q)
+{
+    for (size_t a = 0; a < n1; ++a)
+    {
+        double sum = 0.0;
+        for (size_t b = 0; b < n2; ++b) sum += r[a * n2 + b] * y[b];
+        x[a] = (sum > 0) ? rows[a] / sum : 0.0;
+    }
+    for (size_t b = 0; b < n2; ++b)
+    {
+        double sum = 0.0;
+        for (size_t a = 0; a < n1; ++a) sum += r[a * n2 + b] * x[a];
+        y[b] = (sum > 0) ? cols[b] / sum : 0.0;
+    }
+    double delta = 0.0;
+    for (size_t a = 0; a < n1; ++a)
+    {
+        double sum = 0.0;
+        for (size_t b = 0; b < n2; ++b)
+        {
+            q[a * n2 + b] = r[a * n2 + b] * x[a] * y[b];
+            sum += q[a * n2 + b];
+        }
+        delta = MAX(delta, fabs(sum - rows[a]));
+    }
+    return delta;
+}
+
+/*
+ * The redundancy of Bertschinger et al. (2014), for a pair of sources. The
+ * shared information is the co-information maximized over the distributions
+ * `q` which preserve the joint distribution of the stimulus with each source,
+ * i.e. the sum of the mutual information of the stimulus with each source
+ * less the least mutual information with the pair under any such `q`.
+ *
+ * That minimum is found by the alternating minimization of Csiszar and
+ * Tusnady, as I(S;A) = min_r D(q || p(s) r(a)): given `r`, the best `q` for
+ * each stimulus is `r` scaled to the stimulus' joint distributions with the
+ * sources, and given `q`, the best `r` is the marginal of `q`. The scalings
+ * change little from one step to the next, so rather than fitting them anew,
+ * each step carries them over and refines them by a single Sinkhorn sweep.
+ */
+static bool broja_redundancy(pid_data const *data, size_t const *name,
+        size_t size, double *red, inform_error *err)
+{
+    size_t dims[PID_MAX_SOURCES], cells;
+    double *p = joint_table(data, name, size, dims, &cells, err);
+    if (p == NULL)
+    {
+        return true;
+    }
+    size_t const bs = dims[0];
+    size_t const nr = cells / bs;
+
+    if (size == 1)
+    {
+        double *scratch = malloc((bs + nr) * sizeof(double));
+        if (scratch == NULL)
+        {
+            free(p);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+        }
+        *red = table_mutual_info(p, dims, 2, cells, scratch);
+        free(scratch);
+        free(p);
+        return false;
+    }
+
+    size_t const n1 = dims[1], n2 = dims[2];
+    double *q = malloc((cells + 2 * bs * (n1 + n2) + nr + n1 + n2 + bs)
+        * sizeof(double));
+    if (q == NULL)
+    {
+        free(p);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+    double *targets = q + cells, *scalings = targets + bs * (n1 + n2);
+    double *r = scalings + bs * (n1 + n2), *p1 = r + nr, *p2 = p1 + n1;
+    double *ps = p2 + n2;
+
+    /*
+     * Keep the conditional distribution of each source given each stimulus,
+     * the second's after the first's, in `targets`, and compute the mutual
+     * information of the stimulus with each source.
+     */
+    marginalize(p, dims, 3, cells, 1, ps);
+    marginalize(p, dims, 3, cells, 2, p1);
+    marginalize(p, dims, 3, cells, 4, p2);
+    double i1 = 0.0, i2 = 0.0;
+    for (size_t s = 0; s < bs; ++s)
+    {
+        double *t1 = targets + s * (n1 + n2), *t2 = t1 + n1;
+        memset(t1, 0, (n1 + n2) * sizeof(double));
+        if (ps[s] == 0)
+        {
+            continue;
+        }
+        for (size_t a = 0; a < n1; ++a)
+        {
+            for (size_t b = 0; b < n2; ++b)
+            {
+                double const x = p[s + bs * (a + n1 * b)] / ps[s];
+                t1[a] += x;
+                t2[b] += x;
+            }
+        }
+        for (size_t a = 0; a < n1; ++a)
+        {
+            if (t1[a] > 0) i1 += ps[s] * t1[a] * log2(t1[a] / p1[a]);
+        }
+        for (size_t b = 0; b < n2; ++b)
+        {
+            if (t2[b] > 0) i2 += ps[s] * t2[b] * log2(t2[b] / p2[b]);
+        }
+    }
+
+    /* `q` is stored by stimulus, each slice an `n1 x n2` row-major matrix */
+    for (size_t x = 0; x < nr; ++x)
+    {
+        r[x] = 1.0 / (double) nr;
+    }
+    for (size_t x = 0; x < bs * (n1 + n2); ++x)
+    {
+        scalings[x] = 1.0;
+    }
+    memset(q, 0, cells * sizeof(double));
+
+    double previous = INFINITY, current = 0.0;
+    for (size_t it = 0; it < PID_MAX_ITERATIONS; ++it)
+    {
+        double delta = 0.0;
+        for (size_t s = 0; s < bs; ++s)
+        {
+            if (ps[s] > 0)
+            {
+                double const *t1 = targets + s * (n1 + n2);
+                double *x = scalings + s * (n1 + n2);
+                double const d = sinkhorn(r, n1, n2, t1, t1 + n1, x, x + n1,
+                    q + s * nr);
+                delta = MAX(delta, d);
+            }
+        }
+        memset(r, 0, nr * sizeof(double));
+        for (size_t s = 0; s < bs; ++s)
+        {
+            for (size_t x = 0; x < nr; ++x) r[x] += ps[s] * q[s * nr + x];
+        }
+
+        current = 0.0;
+        for (size_t s = 0; s < bs; ++s)
+        {
+            for (size_t x = 0; x < nr; ++x)
+            {
+                double const y = q[s * nr + x];
+                if (y > 0) current += ps[s] * y * log2(y / r[x]);
+            }
+        }
+        if (delta < PID_TOLERANCE && fabs(previous - current) < PID_TOLERANCE)
+        {
+            break;
+        }
+        previous = current;
+    }
+    *red = i1 + i2 - current;
+
+    free(q);
+    free(p);
+    return false;
+}
+
+/*
+ * The redundancy measure of each `inform_pid_measure`. The Williams-Beer
+ * measure is evaluated by `evaluate` from the specific information of every
+ * subset of the responses at once, rather than node by node.
+ */
+static pid_redundancy const redundancies[] =
+{
+    [INFORM_PID_IMIN] = NULL,
+    [INFORM_PID_CCS] = ccs_redundancy,
+    [INFORM_PID_BROJA] = broja_redundancy,
+};
+
+/*
+ * Compute the partial information of each node of a lattice from its
+ * redundancy by Moebius inversion, subtracting from each node the partial
+ * information of every node strictly below it. The nodes are in topological
+ * order, so every node below another precedes it. `marks` and `stack` each
+ * have room for one element per node.
+ */
+static void invert(pid_shape const *shape, double const *red, size_t *marks,
+        size_t *stack, double *pi)
+{
+    memset(marks, 0, shape->size * sizeof(size_t));
+    for (size_t i = 0; i < shape->size; ++i)
+    {
+        pi[i] = red[i];
+        size_t top = 0;
+        stack[top++] = i;
+        while (top != 0)
+        {
+            size_t const j = stack[--top];
+            for (size_t e = shape->below_offsets[j]; e < shape->below_offsets[j + 1]; ++e)
+            {
+                size_t const below = shape->below[e];
+                if (marks[below] != i + 1)
+                {
+                    marks[below] = i + 1;
+                    pi[i] -= pi[below];
+                    stack[top++] = below;
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Decompose the information about the stimulus provided by the responses over
+ * a lattice of the given shape, writing the redundancy and partial
+ * information of each node to `red` and `pi`.
+ */
+static bool decompose(pid_data const *data, inform_pid_measure measure,
+        pid_shape const *shape, double *red, double *pi, inform_error *err)
+{
+    size_t const bs = (size_t) data->bs;
+    size_t const size = shape->size;
+
+    if (measure == INFORM_PID_IMIN)
+    {
+        size_t const m = ((size_t) 1 << data->l) - 1;
+        double *si = malloc((m + size + 1) * bs * sizeof(double));
+        if (si == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+        }
+        double *mins = si + m * bs;
+        bool const failed = specific_info_matrix(data->stimulus,
+            data->responses, data->n, data->bs, data->br, data->vars, data->l,
+            data->s_dist, si, err);
+        if (!failed)
+        {
+            evaluate(shape, si, data->s_dist, bs, mins, red, pi);
+        }
+        free(si);
+        return failed;
     }
 
-    if (info)
+    pid_redundancy const redundancy = redundancies[measure];
+    for (size_t i = 0; i < size; ++i)
     {
-        for (size_t i = 0; i < gvector_len(info); ++i)
+        size_t const *name = shape->names + shape->name_offsets[i];
+        size_t const n = shape->name_offsets[i + 1] - shape->name_offsets[i];
+        if (redundancy(data, name, n, red + i, err))
         {
-            gvector_free(info[i]);
+            return true;
         }
-        gvector_free(info);
     }
+
+    size_t *marks = malloc(2 * size * sizeof(size_t));
+    if (marks == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+    invert(shape, red, marks, marks + size, pi);
+    free(marks);
+
+    return false;
 }
 
 static bool check_arguments( int const *stimulus, int const *responses, size_t l, size_t n,
@@ -634,6 +1483,50 @@ static bool check_arguments( int const *stimulus, int const *responses, size_t l
     return false;
 }
 
+/*
+ * Check that a measure is known and defined for decompositions of `l`
+ * responses.
+ */
+static bool check_measure(inform_pid_measure measure, size_t l,
+        inform_error *err)
+{
+    if ((unsigned) measure > INFORM_PID_BROJA)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    else if (measure == INFORM_PID_BROJA && l != 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    return false;
+}
+
+/*
+ * Decompose the information provided by the first `l` responses, allocating
+ * the stimulus distribution.
+ */
+static bool decompose_all(int const *stimulus, int const *responses, size_t l,
+        size_t n, int bs, int const *br, inform_pid_measure measure,
+        pid_shape const *shape, double *red, double *pi, inform_error *err)
+{
+    inform_dist *s_dist = inform_dist_alloc(bs);
+    if (s_dist == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+    inform_dist_accumulate(s_dist, stimulus, n);
+
+    size_t vars[PID_MAX_SOURCES];
+    for (size_t i = 0; i < l; ++i) vars[i] = i;
+
+    pid_data const data = { stimulus, responses, n, bs, br, vars, l, s_dist };
+    bool const failed = decompose(&data, measure, shape, red, pi, err);
+
+    inform_dist_free(s_dist);
+
+    return failed;
+}
+
 inform_pid_lattice *inform_pid(int const *stimulus, int const *responses,
         size_t l, size_t n, int bs, int const *br, inform_error *err)
 {
@@ -641,87 +1534,239 @@ inform_pid_lattice *inform_pid(int const *stimulus, int const *responses,
     {
         return NULL;
     }
-    size_t **ss = subsets(l, err);
+
+    pid_shape const *lattice_shape = shape(l, err);
+    if (lattice_shape == NULL)
+    {
+        return NULL;
+    }
+
+    double *values = malloc(2 * lattice_shape->size * sizeof(double));
+    if (values == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    double *imin = values, *pi = values + lattice_shape->size;
+    if (decompose_all(stimulus, responses, l, n, bs, br, INFORM_PID_IMIN,
+        lattice_shape, imin, pi, err))
+    {
+        free(values);
+        return NULL;
+    }
+
+    inform_pid_lattice *lattice = unflatten(lattice_shape, err);
     if (FAILED(err))
     {
+        free(values);
         return NULL;
     }
+    for (size_t i = 0; i < lattice->size; ++i)
+    {
+        lattice->sources[i]->imin = imin[i];
+        lattice->sources[i]->pi = pi[i];
+    }
 
-    size_t const m = gvector_len(ss);
+    free(values);
 
-    inform_dist *s_dist = inform_dist_infer(stimulus, n);
-    if (s_dist == NULL)
+    return lattice;
+}
+
+inform_pid_flat_lattice *inform_pid_flat(int const *stimulus,
+        int const *responses, size_t l, size_t n, int bs, int const *br,
+        inform_error *err)
+{
+    return inform_pid_flat_measure(stimulus, responses, l, n, bs, br,
+        INFORM_PID_IMIN, err);
+}
+
+inform_pid_flat_lattice *inform_pid_flat_measure(int const *stimulus,
+        int const *responses, size_t l, size_t n, int bs, int const *br,
+        inform_pid_measure measure, inform_error *err)
+{
+    if (check_arguments(stimulus, responses, l, n, bs, br, err))
     {
-        cleanup(ss, NULL, NULL);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        return NULL;
+    }
+    else if (check_measure(measure, l, err))
+    {
+        return NULL;
+    }
+
+    pid_shape const *lattice_shape = shape(l, err);
+    if (lattice_shape == NULL)
+    {
+        return NULL;
     }
 
-    double **si = gvector_alloc(m, m, sizeof(double*));
-    if (si == NULL)
+    size_t const size = lattice_shape->size;
+    inform_pid_flat_lattice *lattice = malloc(sizeof(inform_pid_flat_lattice)
+        + 2 * size * sizeof(double));
+    if (lattice == NULL)
     {
-        cleanup(ss, s_dist, si);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
-    for (size_t i = 0; i < m; ++i) si[i] = NULL;
-    for (size_t i = 0; i < m; ++i)
+    lattice->size = size;
+    lattice->name_offsets = lattice_shape->name_offsets;
+    lattice->names = lattice_shape->names;
+    lattice->above_offsets = lattice_shape->above_offsets;
+    lattice->above = lattice_shape->above;
+    lattice->below_offsets = lattice_shape->below_offsets;
+    lattice->below = lattice_shape->below;
+    lattice->imin = (double*) (lattice + 1);
+    lattice->pi = lattice->imin + size;
+
+    if (decompose_all(stimulus, responses, l, n, bs, br, measure,
+        lattice_shape, lattice->imin, lattice->pi, err))
     {
-        si[i] = specific_info(stimulus, responses, l, n, bs, br, ss[i], s_dist, err);
-        if (FAILED(err))
-        {
-            cleanup(ss, s_dist, si);
-            return NULL;
-        }
+        free(lattice);
+        return NULL;
     }
 
-    inform_pid_lattice *lattice = hasse(l, err);
-    if (FAILED(err))
+    return lattice;
+}
+
+void inform_pid_flat_lattice_free(inform_pid_flat_lattice *lattice)
+{
+    free(lattice);
+}
+
+size_t inform_pid_lattice_size(size_t l, inform_error *err)
+{
+    pid_shape const *lattice_shape = shape(l, err);
+    return (lattice_shape == NULL) ? 0 : lattice_shape->size;
+}
+
+/*
+ * The shared state of a batch of decompositions. The stimulus distribution
+ * and the lattice are shared by every tuple, and the partial information of
+ * tuple `i` is written to row `i` of `pi`, and any error to `errors[i]`.
+ */
+typedef struct pid_batch
+{
+    int const *stimulus, *responses;
+    size_t n;
+    int bs;
+    int const *br;
+    size_t const *tuples;
+    size_t l;
+    inform_dist const *s_dist;
+    inform_pid_measure measure;
+    pid_shape const *shape;
+    double *pi;
+    inform_error *errors;
+} pid_batch;
+
+static void batch_tuple(size_t i, void *context)
+{
+    pid_batch const *batch = context;
+    size_t const size = batch->shape->size;
+
+    double *red = malloc(size * sizeof(double));
+    if (red == NULL)
+    {
+        batch->errors[i] = INFORM_ENOMEM;
+        return;
+    }
+
+    pid_data const data = { batch->stimulus, batch->responses, batch->n,
+        batch->bs, batch->br, batch->tuples + i * batch->l, batch->l,
+        batch->s_dist };
+    decompose(&data, batch->measure, batch->shape, red, batch->pi + i * size,
+        batch->errors + i);
+
+    free(red);
+}
+
+double *inform_pid_batch(int const *stimulus, int const *responses,
+        size_t nresponses, size_t n, int bs, int const *br,
+        size_t const *tuples, size_t l, size_t ntuples, double *pi,
+        inform_error *err)
+{
+    return inform_pid_batch_measure(stimulus, responses, nresponses, n, bs,
+        br, tuples, l, ntuples, INFORM_PID_IMIN, pi, err);
+}
+
+double *inform_pid_batch_measure(int const *stimulus, int const *responses,
+        size_t nresponses, size_t n, int bs, int const *br,
+        size_t const *tuples, size_t l, size_t ntuples,
+        inform_pid_measure measure, double *pi, inform_error *err)
+{
+    if (check_arguments(stimulus, responses, nresponses, n, bs, br, err))
     {
-        cleanup(ss, s_dist, si);
         return NULL;
     }
+    else if (tuples == NULL || ntuples == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
 
-    for (size_t i = 0; i < lattice->size; ++i)
+    pid_shape const *lattice_shape = shape(l, err);
+    if (lattice_shape == NULL)
+    {
+        return NULL;
+    }
+    else if (check_measure(measure, l, err))
     {
-        inform_pid_source *alpha = lattice->sources[i];
-        alpha->imin = 0.0;
-        for (size_t s = 0; s < (size_t)bs; ++s)
+        return NULL;
+    }
+
+    for (size_t i = 0; i < ntuples; ++i)
+    {
+        int bases[PID_MAX_SOURCES];
+        for (size_t k = 0; k < l; ++k)
         {
-            double x = si[alpha->name[0]-1][s];
-            for (size_t k = 1; k < alpha->size; ++k)
+            if (tuples[i * l + k] >= nresponses)
             {
-                x = MIN(x, si[alpha->name[k]-1][s]);
+                INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
             }
-            alpha->imin += s_dist->histogram[s] * x;
+            bases[k] = br[tuples[i * l + k]];
+        }
+        uint64_t support;
+        if (!inform_encoder_support(bases, l, INT_MAX / bs, &support))
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EENCODE, NULL);
         }
-        alpha->imin /= s_dist->counts;
     }
 
-    for (size_t i = 0; i < lattice->size; ++i)
+    size_t const size = lattice_shape->size;
+    bool const allocate = (pi == NULL);
+    if (allocate)
     {
-        inform_pid_source *alpha = lattice->sources[i];
-        for (size_t s = 0; s < (size_t)bs; ++s)
+        pi = malloc(ntuples * size * sizeof(double));
+        if (pi == NULL)
         {
-            double u = -INFINITY;
-            for (size_t j = 0; j < alpha->n_below; ++j)
-            {
-                inform_pid_source *beta = alpha->below[j];
-                double x = si[beta->name[0]-1][s];
-                for (size_t k = 1; k < beta->size; ++k)
-                {
-                    x = MIN(x, si[beta->name[k]-1][s]);
-                }
-                u = MAX(u, x);
-            }
-            if (isinf(u))
-            {
-                u = 0.0;
-            }
-            alpha->pi += s_dist->histogram[s] * u;
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
         }
-        alpha->pi = alpha->imin - alpha->pi / s_dist->counts;
     }
 
-    cleanup(ss, s_dist, si);
+    inform_dist *s_dist = inform_dist_alloc(bs);
+    inform_error *errors = calloc(ntuples, sizeof(inform_error));
+    if (s_dist == NULL || errors == NULL)
+    {
+        free(errors);
+        inform_dist_free(s_dist);
+        if (allocate) free(pi);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    inform_dist_accumulate(s_dist, stimulus, n);
 
-    return lattice;
+    pid_batch batch = { stimulus, responses, n, bs, br, tuples, l, s_dist,
+        measure, lattice_shape, pi, errors };
+    inform_parallel_for(ntuples, batch_tuple, &batch);
+
+    inform_dist_free(s_dist);
+
+    for (size_t i = 0; i < ntuples; ++i)
+    {
+        if (errors[i] != INFORM_SUCCESS)
+        {
+            inform_error const failure = errors[i];
+            free(errors);
+            if (allocate) free(pi);
+            INFORM_ERROR_RETURN(err, failure, NULL);
+        }
+    }
+    free(errors);
+
+    return pi;
 }
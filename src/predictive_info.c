@@ -4,6 +4,8 @@
 #include <inform/predictive_info.h>
 #include <inform/shannon.h>
 
+#include "estimator.h"
+
 static void accumulate_observations(int const* series, size_t n, size_t m,
     int b, size_t kpast, size_t kfuture, inform_dist *states,
     inform_dist *histories, inform_dist *futures)
@@ -129,10 +131,14 @@ static bool check_arguments(int const *series, size_t n, size_t m, int b,
     return false;
 }
 
-double inform_predictive_info(int const *series, size_t n, size_t m, int b,
-    size_t kpast, size_t kfuture, inform_error *err)
+static double predictive_info(int const *series, size_t n, size_t m, int b,
+    size_t kpast, size_t kfuture, inform_estimator est, inform_error *err)
 {
     if (check_arguments(series, n, m, b, kpast, kfuture, err)) return NAN;
+    if (!inform_estimator_is_valid(est))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NAN);
+    }
 
     size_t const N = n * (m - kpast - kfuture + 1);
 
@@ -154,13 +160,25 @@ double inform_predictive_info(int const *series, size_t n, size_t m, int b,
     accumulate_observations(series, n, m, b, kpast, kfuture, &states,
         &histories, &futures);
 
-    double pi = inform_shannon_mi(&states, &histories, &futures, 2.0);
+    double pi = inform_shannon_mi_est(&states, &histories, &futures, 2.0, est);
 
     free(data);
 
     return pi;
 }
 
+double inform_predictive_info(int const *series, size_t n, size_t m, int b,
+    size_t kpast, size_t kfuture, inform_error *err)
+{
+    return predictive_info(series, n, m, b, kpast, kfuture, INFORM_PLUGIN, err);
+}
+
+double inform_predictive_info_est(int const *series, size_t n, size_t m, int b,
+    size_t kpast, size_t kfuture, inform_estimator est, inform_error *err)
+{
+    return predictive_info(series, n, m, b, kpast, kfuture, est, err);
+}
+
 double *inform_local_predictive_info(int const *series, size_t n, size_t m,
     int b, size_t kpast, size_t kfuture, double *pi, inform_error *err)
 {
@@ -1,63 +1,414 @@
 // Copyright 2016-2018 ELIFE. All rights reserved.
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
-#include <inform/active_info.h>
-#include <inform/transfer_entropy.h>
+#include <inform/separable_info.h>
 #include <math.h>
+#include <stdint.h>
+
+#include "parallel.h"
+
+/*
+ * The fewest observations, summed over the sources, worth dividing among
+ * threads, and the number of time steps in each block of the local
+ * evaluation.
+ */
+#define SEPARABLE_GRAIN (1 << 16)
+#define SEPARABLE_BLOCK (1 << 14)
+
+/*
+ * The destination's embedding, shared by every source: the history and
+ * predicate (history and future) of each of the `N` observations, and the
+ * histograms of the histories, predicates and futures.
+ */
+typedef struct destination
+{
+    size_t n, m, k, N;
+    int b;
+    size_t q;
+    int *history;
+    int *predicate;
+    uint32_t *histories;
+    uint32_t *predicates;
+    uint32_t *futures;
+} destination;
+
+/*
+ * The histograms of one source, indexed by the source state joined with the
+ * destination's history (`sources`) and with its predicate (`states`).
+ */
+typedef struct source_hist
+{
+    uint32_t *sources;
+    uint32_t *states;
+} source_hist;
+
+static bool check_arguments(int const *srcs, int const *dest, size_t l,
+    size_t n, size_t m, int b, size_t k, inform_error *err)
+{
+    if (l < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, true);
+    }
+    else if (dest == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if (n < 1)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOINITS, true);
+    }
+    else if (m < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, true);
+    }
+    else if (b < 2)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
+    }
+    else if (k == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, true);
+    }
+    else if (m <= k)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
+    }
+    for (size_t i = 0; i < n * m; ++i)
+    {
+        if (dest[i] < 0)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
+        }
+        else if (b <= dest[i])
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
+        }
+    }
+    if (srcs == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    }
+    else if ((k + 2) * log2(b) > 31)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
+    }
+    for (size_t i = 0; i < l * n * m; ++i)
+    {
+        if (b <= srcs[i])
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
+        }
+        else if (srcs[i] < 0)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
+        }
+    }
+    return false;
+}
+
+/*
+ * Encode the destination's histories and predicates once, accumulating the
+ * histograms shared by every source. The histograms are allocated with the
+ * code arrays, so freeing `history` frees everything.
+ */
+static bool encode_destination(int const *dest, size_t n, size_t m, int b,
+    size_t k, destination *d)
+{
+    size_t q = 1;
+    for (size_t i = 0; i < k; ++i) q *= b;
+
+    d->n = n; d->m = m; d->k = k; d->b = b; d->q = q;
+    d->N = n * (m - k);
+
+    size_t const codes = 2 * d->N * sizeof(int);
+    size_t const counts = (q + q*b + b) * sizeof(uint32_t);
+    char *data = calloc(codes + counts, 1);
+    if (data == NULL) return true;
+
+    d->history    = (int*) data;
+    d->predicate  = d->history + d->N;
+    d->histories  = (uint32_t*) (data + codes);
+    d->predicates = d->histories + q;
+    d->futures    = d->predicates + q*b;
+
+    size_t t = 0;
+    for (size_t i = 0; i < n; ++i, dest += m)
+    {
+        int history = 0;
+        for (size_t j = 0; j < k; ++j) history = history * b + dest[j];
+        for (size_t j = k; j < m; ++j, ++t)
+        {
+            int const predicate = history * b + dest[j];
+            d->history[t] = history;
+            d->predicate[t] = predicate;
+            d->histories[history]++;
+            d->predicates[predicate]++;
+            d->futures[dest[j]]++;
+            history = predicate - dest[j - k] * (int) q;
+        }
+    }
+    return false;
+}
+
+static double active_info(destination const *d)
+{
+    double const N = (double) d->N;
+    double ai = 0.0;
+    for (size_t h = 0; h < d->q; ++h)
+    {
+        double const n_history = d->histories[h];
+        if (n_history == 0) continue;
+        for (int f = 0; f < d->b; ++f)
+        {
+            double const n_predicate = d->predicates[h*d->b + f];
+            if (n_predicate == 0) continue;
+            ai += n_predicate * log2((N * n_predicate) / (n_history * d->futures[f]));
+        }
+    }
+    return ai / N;
+}
+
+/*
+ * The source state observed alongside the destination's `t`-th future, i.e.
+ * the state of `x` at the preceding time step.
+ */
+inline static int source_state(int const *x, destination const *d, size_t t)
+{
+    size_t const w = d->m - d->k;
+    return x[(t / w) * d->m + d->k + (t % w) - 1];
+}
+
+static void accumulate_source(int const *x, destination const *d,
+    source_hist *s)
+{
+    int const b = d->b;
+    size_t t = 0;
+    for (size_t i = 0; i < d->n; ++i, x += d->m)
+    {
+        for (size_t j = d->k; j < d->m; ++j, ++t)
+        {
+            s->sources[d->history[t] * b + x[j - 1]]++;
+            s->states[d->predicate[t] * b + x[j - 1]]++;
+        }
+    }
+}
+
+/*
+ * Sum the transfer entropy from an accumulated source, visiting each occupied
+ * state once through the observations rather than scanning every possible
+ * state. Each state's count is zeroed once it has been visited.
+ */
+static double transfer_entropy(int const *x, destination const *d,
+    source_hist *s)
+{
+    int const b = d->b;
+    double te = 0.0;
+    size_t t = 0;
+    for (size_t i = 0; i < d->n; ++i, x += d->m)
+    {
+        for (size_t j = d->k; j < d->m; ++j, ++t)
+        {
+            int const state = d->predicate[t] * b + x[j - 1];
+            double const n_state = s->states[state];
+            if (n_state == 0) continue;
+            double const n_history = d->histories[d->history[t]];
+            double const n_source = s->sources[d->history[t] * b + x[j - 1]];
+            double const n_predicate = d->predicates[d->predicate[t]];
+            te += n_state * log2((n_state * n_history) / (n_source * n_predicate));
+            s->states[state] = 0;
+        }
+    }
+    return te / (double) d->N;
+}
+
+/*
+ * Clear the histograms of a source by revisiting its observations, which is
+ * cheaper than zeroing them when there are fewer observations than states.
+ */
+static void clear_source(int const *x, destination const *d, source_hist *s)
+{
+    int const b = d->b;
+    size_t t = 0;
+    for (size_t i = 0; i < d->n; ++i, x += d->m)
+    {
+        for (size_t j = d->k; j < d->m; ++j, ++t)
+        {
+            s->sources[d->history[t] * b + x[j - 1]] = 0;
+            s->states[d->predicate[t] * b + x[j - 1]] = 0;
+        }
+    }
+}
+
+static bool source_hist_alloc(destination const *d, source_hist *s)
+{
+    size_t const sources_size = d->q * d->b;
+    s->sources = calloc(sources_size * (1 + d->b), sizeof(uint32_t));
+    s->states = s->sources + sources_size;
+    return s->sources == NULL;
+}
+
+/*
+ * The sources are divided into contiguous spans, each accumulated and summed
+ * in turn with a single pair of histograms, so that the memory used grows
+ * with the number of threads rather than the number of sources.
+ */
+typedef struct separable
+{
+    int const *srcs;
+    destination const *dest;
+    size_t l, spans;
+    double *te;
+} separable;
+
+static void separable_span(size_t i, void *context)
+{
+    separable const *ctx = context;
+    destination const *d = ctx->dest;
+    size_t const begin = i * ctx->l / ctx->spans;
+    size_t const end = (i + 1) * ctx->l / ctx->spans;
+
+    source_hist s;
+    if (source_hist_alloc(d, &s))
+    {
+        for (size_t j = begin; j < end; ++j) ctx->te[j] = NAN;
+        return;
+    }
+    for (size_t j = begin; j < end; ++j)
+    {
+        int const *x = ctx->srcs + j * d->n * d->m;
+        accumulate_source(x, d, &s);
+        ctx->te[j] = transfer_entropy(x, d, &s);
+        clear_source(x, d, &s);
+    }
+    free(s.sources);
+}
 
 double inform_separable_info(int const *srcs, int const *dest, size_t l,
     size_t n, size_t m, int b, size_t k, inform_error *err)
 {
-    if (l < 1) INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, NAN);
+    if (check_arguments(srcs, dest, l, n, m, b, k, err)) return NAN;
 
-    double si = inform_active_info(dest, n, m, b, k, err);
-    if (inform_failed(err)) return NAN;
+    destination d;
+    if (encode_destination(dest, n, m, b, k, &d))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
 
-    for (size_t i = 0; i < l; ++i, srcs += n*m)
+    double *te = malloc(l * sizeof(double));
+    if (te == NULL)
     {
-        si += inform_transfer_entropy(srcs, dest, NULL, 0, n, m, b, k, err);
-        if (inform_failed(err)) return NAN;
+        free(d.history);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
     }
 
+    size_t spans = 1;
+    if (l > 1 && l * d.N >= SEPARABLE_GRAIN)
+    {
+        spans = inform_parallel_threads();
+        if (spans > l) spans = l;
+    }
+    separable ctx = { srcs, &d, l, spans, te };
+    inform_parallel_for(spans, separable_span, &ctx);
+
+    double si = active_info(&d);
+    for (size_t i = 0; i < l; ++i) si += te[i];
+
+    free(te);
+    free(d.history);
+
+    if (isnan(si)) INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
     return si;
 }
 
+/*
+ * The local evaluation of one accumulated source, adding its local transfer
+ * entropy into `si` over blocks of time steps in parallel.
+ */
+typedef struct local_separable
+{
+    int const *x;
+    destination const *dest;
+    source_hist const *hist;
+    double *si;
+} local_separable;
+
+static void local_block(size_t i, void *context)
+{
+    local_separable const *ctx = context;
+    destination const *d = ctx->dest;
+    int const b = d->b;
+    size_t const begin = i * SEPARABLE_BLOCK;
+    size_t const end = (begin + SEPARABLE_BLOCK < d->N) ?
+        begin + SEPARABLE_BLOCK : d->N;
+    for (size_t t = begin; t < end; ++t)
+    {
+        int const x = source_state(ctx->x, d, t);
+        double const s = ctx->hist->states[d->predicate[t] * b + x];
+        double const v = d->histories[d->history[t]];
+        double const u = d->predicates[d->predicate[t]];
+        double const w = ctx->hist->sources[d->history[t] * b + x];
+        ctx->si[t] += log2((s * v) / (w * u));
+    }
+}
+
 double *inform_local_separable_info(int const *srcs, int const *dest,
     size_t l, size_t n, size_t m, int b, size_t k, double *si,
     inform_error *err)
 {
-    if (l < 1) INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, NULL);
-
-    bool allocated_si = (si == NULL);
+    if (check_arguments(srcs, dest, l, n, m, b, k, err)) return NULL;
 
-    si = inform_local_active_info(dest, n, m, b, k, si, err);
-    if (inform_failed(err))
+    destination d;
+    if (encode_destination(dest, n, m, b, k, &d))
     {
-        if (allocated_si) free(si);
-        return NULL;
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
 
-    const size_t N = n * (m - k);
-    double *te = malloc(n * (m - k) * sizeof(double));
-    if (te == NULL)
+    source_hist s;
+    if (source_hist_alloc(&d, &s))
     {
-        if (allocated_si) free(si);
+        free(d.history);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
 
+    bool const allocate_si = (si == NULL);
+    if (allocate_si)
+    {
+        si = malloc(d.N * sizeof(double));
+        if (si == NULL)
+        {
+            free(s.sources);
+            free(d.history);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    double const N = (double) d.N;
+    for (size_t t = 0; t < d.N; ++t)
+    {
+        double const r = d.predicates[d.predicate[t]];
+        double const h = d.histories[d.history[t]];
+        double const f = d.futures[d.predicate[t] % b];
+        si[t] = log2((r * N) / (h * f));
+    }
+
+    size_t const blocks = (d.N + SEPARABLE_BLOCK - 1) / SEPARABLE_BLOCK;
     for (size_t i = 0; i < l; ++i, srcs += n*m)
     {
-        inform_local_transfer_entropy(srcs, dest, NULL, 0, n, m, b, k, te, err);
-        if (inform_failed(err))
+        accumulate_source(srcs, &d, &s);
+        local_separable ctx = { srcs, &d, &s, si };
+        if (d.N >= SEPARABLE_GRAIN)
         {
-            free(te);
-            if (allocated_si) free(si);
-            return NULL;
+            inform_parallel_for(blocks, local_block, &ctx);
         }
-        for (size_t j = 0; j < N; ++j) si[j] += te[j];
+        else
+        {
+            for (size_t j = 0; j < blocks; ++j) local_block(j, &ctx);
+        }
+        clear_source(srcs, &d, &s);
     }
 
-    free(te);
+    free(s.sources);
+    free(d.history);
 
     return si;
 }
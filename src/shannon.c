@@ -178,3 +178,321 @@ double inform_shannon_multi_mi(inform_dist const *joint,
     }
     return pmi;
 }
+
+/*
+ * The digamma function, shifting the argument up by recurrence until its
+ * asymptotic expansion is accurate.
+ */
+static double digamma(double x)
+{
+    double r = 0.0;
+    for (; x < 6.0; x += 1.0)
+    {
+        r -= 1.0 / x;
+    }
+    double const f = 1.0 / (x * x);
+    return r + log(x) - 0.5 / x
+        - f * (1.0/12 - f * (1.0/120 - f * (1.0/252 - f * (1.0/240 - f / 132))));
+}
+
+/*
+ * The trigamma function, computed in the same way as the digamma function.
+ */
+static double trigamma(double x)
+{
+    double r = 0.0;
+    for (; x < 6.0; x += 1.0)
+    {
+        r += 1.0 / (x * x);
+    }
+    double const f = 1.0 / (x * x);
+    return r + 1.0 / x + f / 2
+        + f / x * (1.0/6 - f * (1.0/30 - f * (1.0/42 - f / 30)));
+}
+
+/*
+ * The number of occupied bins of a histogram.
+ */
+static size_t occupied(inform_dist const *dist)
+{
+    size_t m = 0;
+    for (size_t i = 0; i < dist->size; ++i)
+    {
+        m += (dist->histogram[i] != 0);
+    }
+    return m;
+}
+
+/*
+ * The plug-in entropy in nats.
+ */
+static double plugin_entropy(inform_dist const *dist)
+{
+    double const N = (double) dist->counts;
+    double h = 0.0;
+    for (size_t i = 0; i < dist->size; ++i)
+    {
+        double const n = dist->histogram[i];
+        if (n != 0)
+        {
+            h -= n * log(n);
+        }
+    }
+    return log(N) + h / N;
+}
+
+/*
+ * Grassberger's (2003) estimator in nats,
+ *
+ *     H = log(N) - (1/N) sum_i n_i G(n_i),
+ *     G(n) = digamma(n) + (-1)^n (digamma((n+1)/2) - digamma(n/2)) / 2.
+ */
+static double grassberger_entropy(inform_dist const *dist)
+{
+    double const N = (double) dist->counts;
+    double h = 0.0;
+    for (size_t i = 0; i < dist->size; ++i)
+    {
+        uint32_t const n = dist->histogram[i];
+        if (n != 0)
+        {
+            double const sign = (n & 1) ? -0.5 : 0.5;
+            double const G = digamma(n)
+                + sign * (digamma((n + 1) / 2.0) - digamma(n / 2.0));
+            h += n * G;
+        }
+    }
+    return log(N) - h / N;
+}
+
+/*
+ * The occupied bins of a histogram, grouped by their count. The NSB integrand
+ * depends on the counts only through these classes, of which there are at
+ * most sqrt(2N).
+ */
+typedef struct count_class
+{
+    double count;
+    double bins;
+} count_class;
+
+static int compare_counts(void const *a, void const *b)
+{
+    uint32_t const x = *(uint32_t const*) a, y = *(uint32_t const*) b;
+    return (x > y) - (x < y);
+}
+
+typedef struct nsb_problem
+{
+    count_class const *classes;
+    size_t nclasses;
+    double K, N, m;
+} nsb_problem;
+
+/*
+ * The logarithm of the NSB integrand with respect to u = log(beta): the
+ * Dirichlet evidence P(n|beta) times the density d(xi)/d(u) of the prior
+ * which is uniform in the a priori expected entropy xi.
+ */
+static double nsb_log_weight(nsb_problem const *p, double u)
+{
+    double const beta = exp(u), A = p->K * beta;
+    double const dxi = p->K * trigamma(A + 1) - trigamma(beta + 1);
+    if (!(dxi > 0))
+    {
+        return -INFINITY;
+    }
+    double w = log(dxi) + u + lgamma(A) - lgamma(p->N + A);
+    double const lb = lgamma(beta);
+    for (size_t i = 0; i < p->nclasses; ++i)
+    {
+        w += p->classes[i].bins * (lgamma(p->classes[i].count + beta) - lb);
+    }
+    return w;
+}
+
+/*
+ * The posterior mean entropy, in nats, under a Dirichlet prior of
+ * concentration beta.
+ */
+static double nsb_entropy_given(nsb_problem const *p, double u)
+{
+    double const beta = exp(u), A = p->N + p->K * beta;
+    double h = digamma(A + 1) - (p->K - p->m) * beta / A * digamma(beta + 1);
+    for (size_t i = 0; i < p->nclasses; ++i)
+    {
+        double const a = p->classes[i].count + beta;
+        h -= p->classes[i].bins * a / A * digamma(a + 1);
+    }
+    return h;
+}
+
+#define NSB_MIN_U (-20.0)
+#define NSB_MAX_U (15.0)
+#define NSB_GRID 351
+#define NSB_SIMPSON 512
+
+/*
+ * The Nemenman-Shafee-Bialek estimator in nats. The integrand is smooth and
+ * unimodal in log(beta), so its peak is located on a coarse grid and refined
+ * by golden-section search, and the integral is then taken by Simpson's rule
+ * over the region within which the integrand is appreciable.
+ */
+static double nsb_entropy(inform_dist const *dist)
+{
+    size_t const m = occupied(dist);
+    if (dist->size < 2)
+    {
+        return 0.0;
+    }
+
+    uint32_t *counts = malloc(m * sizeof(uint32_t));
+    count_class *classes = malloc(m * sizeof(count_class));
+    if (counts == NULL || classes == NULL)
+    {
+        free(counts);
+        free(classes);
+        return NAN;
+    }
+    for (size_t i = 0, j = 0; i < dist->size; ++i)
+    {
+        if (dist->histogram[i] != 0) counts[j++] = dist->histogram[i];
+    }
+    qsort(counts, m, sizeof(uint32_t), compare_counts);
+    size_t nclasses = 0;
+    for (size_t i = 0; i < m; ++i)
+    {
+        if (nclasses != 0 && classes[nclasses - 1].count == counts[i])
+        {
+            classes[nclasses - 1].bins += 1;
+        }
+        else
+        {
+            classes[nclasses++] = (count_class){ counts[i], 1 };
+        }
+    }
+    free(counts);
+
+    nsb_problem const p = { classes, nclasses, (double) dist->size,
+        (double) dist->counts, (double) m };
+
+    double const step = (NSB_MAX_U - NSB_MIN_U) / (NSB_GRID - 1);
+    size_t peak = 0;
+    double best = -INFINITY;
+    for (size_t i = 0; i < NSB_GRID; ++i)
+    {
+        double const w = nsb_log_weight(&p, NSB_MIN_U + i * step);
+        if (w > best)
+        {
+            best = w;
+            peak = i;
+        }
+    }
+
+    double lo = NSB_MIN_U + (peak == 0 ? 0 : peak - 1) * step;
+    double hi = NSB_MIN_U + (peak + 1 == NSB_GRID ? peak : peak + 1) * step;
+    double const phi = (sqrt(5.0) - 1) / 2;
+    double a = hi - phi * (hi - lo), b = lo + phi * (hi - lo);
+    double wa = nsb_log_weight(&p, a), wb = nsb_log_weight(&p, b);
+    while (hi - lo > 1e-6)
+    {
+        if (wa > wb)
+        {
+            hi = b; b = a; wb = wa;
+            a = hi - phi * (hi - lo);
+            wa = nsb_log_weight(&p, a);
+        }
+        else
+        {
+            lo = a; a = b; wa = wb;
+            b = lo + phi * (hi - lo);
+            wb = nsb_log_weight(&p, b);
+        }
+    }
+    double const u = (lo + hi) / 2;
+    double const w0 = nsb_log_weight(&p, u);
+
+    double const du = 1e-2;
+    double const curvature = -(nsb_log_weight(&p, u + du) - 2 * w0
+        + nsb_log_weight(&p, u - du)) / (du * du);
+    double width = (curvature > 0) ? 10 / sqrt(curvature) : NSB_MAX_U - NSB_MIN_U;
+    lo = fmax(NSB_MIN_U, u - width);
+    hi = fmin(NSB_MAX_U, u + width);
+
+    double const h = (hi - lo) / NSB_SIMPSON;
+    double z = 0.0, s = 0.0;
+    for (size_t i = 0; i <= NSB_SIMPSON; ++i)
+    {
+        double const x = lo + i * h;
+        double const c = (i == 0 || i == NSB_SIMPSON) ? 1 : ((i & 1) ? 4 : 2);
+        double const w = c * exp(nsb_log_weight(&p, x) - w0);
+        z += w;
+        s += w * nsb_entropy_given(&p, x);
+    }
+    free(classes);
+
+    return s / z;
+}
+
+double inform_shannon_entropy_est(inform_dist const *dist, double base,
+    inform_estimator est)
+{
+    if (!inform_dist_is_valid(dist))
+    {
+        return NAN;
+    }
+    switch (est)
+    {
+        case INFORM_PLUGIN:
+            return inform_shannon_entropy(dist, base);
+        case INFORM_MILLER_MADOW:
+            return (plugin_entropy(dist)
+                + (occupied(dist) - 1.0) / (2.0 * dist->counts)) / log(base);
+        case INFORM_GRASSBERGER:
+            return grassberger_entropy(dist) / log(base);
+        case INFORM_NSB:
+            return nsb_entropy(dist) / log(base);
+        default:
+            return NAN;
+    }
+}
+
+double inform_shannon_mi_est(inform_dist const *joint,
+    inform_dist const *marginal_x, inform_dist const *marginal_y, double base,
+    inform_estimator est)
+{
+    return inform_shannon_multi_mi_est(joint,
+        (inform_dist const*[2]){marginal_x, marginal_y}, 2, base, est);
+}
+
+double inform_shannon_ce_est(inform_dist const *joint,
+    inform_dist const *marginal, double base, inform_estimator est)
+{
+    return inform_shannon_entropy_est(joint, base, est) -
+        inform_shannon_entropy_est(marginal, base, est);
+}
+
+double inform_shannon_cmi_est(inform_dist const *joint,
+    inform_dist const *marginal_xz, inform_dist const *marginal_yz,
+    inform_dist const *marginal_z, double base, inform_estimator est)
+{
+    return inform_shannon_entropy_est(marginal_xz, base, est) +
+        inform_shannon_entropy_est(marginal_yz, base, est) -
+        inform_shannon_entropy_est(joint, base, est) -
+        inform_shannon_entropy_est(marginal_z, base, est);
+}
+
+double inform_shannon_multi_mi_est(inform_dist const *joint,
+    inform_dist const **marginals, size_t n, double base, inform_estimator est)
+{
+    if (n < 2)
+    {
+        return 0.0;
+    }
+    double mi = -inform_shannon_entropy_est(joint, base, est);
+    for (size_t i = 0; i < n; ++i)
+    {
+        mi += inform_shannon_entropy_est(marginals[i], base, est);
+    }
+    return mi;
+}
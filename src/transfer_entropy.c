@@ -5,108 +5,152 @@
 #include <inform/transfer_entropy.h>
 #include <string.h>
 
-static void accumulate_observations(int const *src, int const *dst,
-    int const *back, size_t l, size_t n, size_t m, int b, size_t k,
-    inform_dist *states, inform_dist *histories, inform_dist *sources,
-    inform_dist *predicates)
+#include "estimator.h"
+#include "histogram.h"
+#include "parallel.h"
+#include "view.h"
+
+/*
+ * The embedding parameters of a transfer entropy calculation:
+ *
+ *   k     - the destination history length
+ *   k_tau - the delay between successive destination history samples
+ *   h     - the source history length
+ *   h_tau - the delay between successive source history samples
+ *   u     - the delay between the most recent source sample and the
+ *           destination's future state
+ */
+typedef struct embedding
 {
-    for (size_t i = 0; i < n; ++i, src += m, dst += m)
-    {
-        int src_state, future, state, source, predicate, back_state;
-        int history = 0, q = 1;
-        for (size_t j = 0; j < k; ++j)
-        {
-            q *= b;
-            history *= b;
-            history += dst[j];
-        }
-        for (size_t j = k; j < m; ++j)
-        {
-            back_state = 0;
-            for (size_t u = 0; u < l; ++u)
-            {
-                back_state = b * back_state + back[j+m*(i+n*u)-1];
-            }
-            history += back_state * q;
+    size_t k, k_tau, h, h_tau, u;
+} embedding;
 
-            src_state = src[j-1];
-            future    = dst[j];
-            source    = history * b + src_state;
-            predicate = history * b + future;
-            state     = predicate * b + src_state;
+static embedding const default_embedding = { 0, 1, 1, 1, 1 };
 
-            states->histogram[state]++;
-            histories->histogram[history]++;
-            sources->histogram[source]++;
-            predicates->histogram[predicate]++;
+/*
+ * The first time step for which the destination's future state has a fully
+ * defined history and source embedding.
+ */
+inline static size_t first_step(embedding const *e)
+{
+    size_t const dst_start = (e->k - 1) * e->k_tau + 1;
+    size_t const src_start = (e->h - 1) * e->h_tau + e->u;
+    return (dst_start > src_start) ? dst_start : src_start;
+}
 
-            history = predicate - (dst[j - k] + back_state * b) * q;
-        }
+/*
+ * Encode the `k` samples of `x` ending at time `t`, spaced `tau` apart, where
+ * successive time steps of `x` are `stride` elements apart. When `roll` is
+ * set, the encoding is derived from `prev`, the encoding ending at `t - 1`,
+ * which is only valid when `tau == 1`. The argument `q` is `b^(k-1)`.
+ */
+inline static int embed(int const *x, ptrdiff_t stride, size_t t, size_t k,
+    size_t tau, int b, int q, int prev, bool roll)
+{
+    if (roll)
+    {
+        return (prev - x[(ptrdiff_t) (t - k) * stride] * q) * b
+            + x[(ptrdiff_t) t * stride];
+    }
+    int code = 0;
+    for (size_t p = k; p-- > 0;)
+    {
+        code = code * b + x[(ptrdiff_t) (t - p * tau) * stride];
     }
+    return code;
 }
 
-static void accumulate_local_observations(int const *src, int const *dst,
-    int const *back, size_t l, size_t n, size_t m, int b, size_t k,
-    inform_dist *states, inform_dist *histories, inform_dist *sources,
-    inform_dist *predicates, int *state, int *history, int *source,
-    int *predicate)
+inline static int power(int b, size_t k)
+{
+    int q = 1;
+    for (size_t i = 0; i < k; ++i) q *= b;
+    return q;
+}
+
+/*
+ * Walk the embedded time series, calling the accumulation or local evaluation
+ * on each observation. If `codes` is not `NULL`, the state of each of the `N`
+ * observations is encoded in `codes`, ordered by history, source and future,
+ * and its predicate in the `N` codes which follow. Otherwise, if `te` is
+ * `NULL` the histograms are accumulated, and if not the local transfer
+ * entropy is written to `te` using the previously accumulated histograms.
+ */
+static void observe(inform_view const *src, inform_view const *dst,
+    inform_view const *back, size_t l, size_t n, size_t m, int b,
+    embedding const *e, inform_dist *states, inform_dist *histories,
+    inform_dist *sources, inform_dist *predicates, double *te,
+    uint64_t *codes)
 {
+    size_t const t0 = first_step(e);
+    size_t const N = n * (m - t0);
+    int const qk = power(b, e->k), qh = power(b, e->h);
+    int const rk = qk / b, rh = qh / b;
+    bool const roll_k = (e->k_tau == 1), roll_h = (e->h_tau == 1);
+    ptrdiff_t const ss = src->time_stride, ds = dst->time_stride;
+    ptrdiff_t const bs = back->time_stride;
+
     for (size_t i = 0; i < n; ++i)
     {
-        history[0] = 0;
-        int q = 1;
-        for (size_t j = 0; j < k; ++j)
-        {
-            q *= b;
-            history[0] *= b;
-            history[0] += dst[j];
-        }
-        for (size_t j = k; j < m; ++j)
+        int const *x = inform_view_row(src, 0, i);
+        int const *y = inform_view_row(dst, 0, i);
+        int history = 0, src_state = 0;
+        for (size_t j = t0; j < m; ++j)
         {
-            size_t z = j - k;
+            history = embed(y, ds, j - 1, e->k, e->k_tau, b, rk, history,
+                roll_k && j != t0);
+            src_state = embed(x, ss, j - e->u, e->h, e->h_tau, b, rh,
+                src_state, roll_h && j != t0);
+
             int back_state = 0;
-            for (size_t u = 0; u < l; ++u)
+            for (size_t v = 0; v < l; ++v)
+            {
+                back_state = b * back_state
+                    + inform_view_row(back, v, i)[(ptrdiff_t) (j - 1) * bs];
+            }
+
+            int const full_history = history + back_state * qk;
+            int const future    = y[(ptrdiff_t) j * ds];
+            int const source    = full_history * qh + src_state;
+            int const predicate = full_history * b + future;
+            int const state     = predicate * qh + src_state;
+
+            if (codes != NULL)
+            {
+                codes[N] = (uint64_t) predicate;
+                *codes++ = (uint64_t) source * b + future;
+            }
+            else if (te == NULL)
             {
-                back_state = b * back_state + back[j+n*(i+m*u)-1];
+                states->histogram[state]++;
+                histories->histogram[full_history]++;
+                sources->histogram[source]++;
+                predicates->histogram[predicate]++;
             }
-            history[z] += back_state * q;
-            int src_state = src[j-1];
-            int future    = dst[j];
-            predicate[z]  = history[z] * b + future;
-            state[z]      = predicate[z] * b + src_state;
-            source[z]     = history[z] * b + src_state;
-
-            states->histogram[state[z]]++;
-            histories->histogram[history[z]]++;
-            sources->histogram[source[z]]++;
-            predicates->histogram[predicate[z]]++;
-
-            if (j + 1 != m)
+            else
             {
-                history[z + 1] = predicate[z] - (dst[z] + back_state * b) * q;
+                double const s = states->histogram[state];
+                double const t = sources->histogram[source];
+                double const u = predicates->histogram[predicate];
+                double const v = histories->histogram[full_history];
+                *te++ = log2((s*v)/(t*u));
             }
         }
-        src += m;
-        dst += m;
-        state += (m - k);
-        history += (m - k);
-        source += (m - k);
-        predicate += (m - k);
     }
 }
 
-static bool check_arguments(int const *src, int const *dst, int const *back,
-    size_t l, size_t n, size_t m, int b, size_t k, inform_error *err)
+static bool check_arguments(inform_view const *src, inform_view const *dst,
+    inform_view const *back, size_t l, size_t n, size_t m, int b,
+    embedding const *e, inform_validation validation, inform_error *err)
 {
-    if (src == NULL)
+    if (src->data == NULL)
     {
         INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
     }
-    else if (dst == NULL)
+    else if (dst->data == NULL)
     {
         INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
     }
-    else if (back == NULL && l != 0)
+    else if (back->data == NULL && l != 0)
     {
         INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, true);
     }
@@ -122,36 +166,57 @@ static bool check_arguments(int const *src, int const *dst, int const *back,
     {
         INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
     }
-    else if (m <= k)
+    else if (e->k == 0 || e->h == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, true);
+    }
+    else if (e->k_tau == 0 || e->h_tau == 0 || e->u == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, true);
+    }
+    else if (m <= first_step(e))
     {
         INFORM_ERROR_RETURN(err, INFORM_EKLONG, true);
     }
-    else if (k == 0)
+    else if ((e->k + e->h + l + 1) * log2(b) > 31)
     {
-        INFORM_ERROR_RETURN(err, INFORM_EKZERO, true);
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
     }
-    for (size_t i = 0; i < n * m; ++i)
+    else if (validation != INFORM_VALIDATE_FULL)
     {
-        if (b <= src[i] || b <= dst[i])
-        {
-            INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
-        }
-        else if (src[i] < 0 || dst[i] < 0)
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        int const *x = inform_view_row(src, 0, i);
+        int const *y = inform_view_row(dst, 0, i);
+        for (size_t j = 0; j < m; ++j)
         {
-            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
+            int const s = x[(ptrdiff_t) j * src->time_stride];
+            int const d = y[(ptrdiff_t) j * dst->time_stride];
+            if (b <= s || b <= d)
+            {
+                INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
+            }
+            else if (s < 0 || d < 0)
+            {
+                INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
+            }
         }
     }
-    if (back != NULL)
+    for (size_t v = 0; back->data != NULL && v < l; ++v)
     {
-        for (size_t i = 0; i < l; ++i)
+        for (size_t i = 0; i < n; ++i)
         {
-            for (size_t j = 0; j < n * m; ++j)
+            int const *z = inform_view_row(back, v, i);
+            for (size_t j = 0; j < m; ++j)
             {
-                if (b <= back[j + n*m*i])
+                int const s = z[(ptrdiff_t) j * back->time_stride];
+                if (b <= s)
                 {
                     INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
                 }
-                else if (back[j + n*m*i] < 0)
+                else if (s < 0)
                 {
                     INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
                 }
@@ -161,42 +226,58 @@ static bool check_arguments(int const *src, int const *dst, int const *back,
     return false;
 }
 
-double inform_transfer_entropy(int const *src, int const *dst, int const *back,
-    size_t l, size_t n, size_t m, int b, size_t k, inform_error *err)
+/*
+ * Allocate and accumulate the four histograms required for the transfer
+ * entropy. The returned block must be freed by the caller.
+ */
+static uint32_t *accumulate(inform_view const *src, inform_view const *dst,
+    inform_view const *back, size_t l, size_t n, size_t m, int b,
+    embedding const *e,
+    inform_dist *states, inform_dist *histories, inform_dist *sources,
+    inform_dist *predicates, inform_error *err)
 {
-    if (check_arguments(src, dst, back, l, n, m, b, k, err)) return NAN;
-
-    size_t const N = n * (m - k);
+    size_t const N = n * (m - first_step(e));
 
-    size_t const q = (size_t) pow((double) b, (double) k);
+    size_t const q = (size_t) pow((double) b, (double) e->k);
     size_t const r = (size_t) pow((double) b, (double) l);
-    size_t const states_size     = b*b*q*r;
+    size_t const p = (size_t) pow((double) b, (double) e->h);
+    size_t const states_size     = b*p*q*r;
     size_t const histories_size  = q*r;
-    size_t const sources_size    = b*q*r;
+    size_t const sources_size    = p*q*r;
     size_t const predicates_size = b*q*r;
     size_t const total_size = states_size + histories_size + sources_size + predicates_size;
 
     uint32_t *data = calloc(total_size, sizeof(uint32_t));
     if (data == NULL)
     {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
 
-    inform_dist states     = { data, states_size, N };
-    inform_dist histories  = { data + states_size, histories_size, N };
-    inform_dist sources    = { data + states_size + histories_size, sources_size, N };
-    inform_dist predicates = { data + states_size + histories_size + sources_size, predicates_size, N };
+    *states     = (inform_dist){ data, states_size, N };
+    *histories  = (inform_dist){ data + states_size, histories_size, N };
+    *sources    = (inform_dist){ data + states_size + histories_size, sources_size, N };
+    *predicates = (inform_dist){ data + states_size + histories_size + sources_size, predicates_size, N };
 
-    accumulate_observations(src, dst, back, l, n, m, b, k, &states, &histories,
-        &sources, &predicates);
+    observe(src, dst, back, l, n, m, b, e, states, histories, sources,
+        predicates, NULL, NULL);
 
+    return data;
+}
 
+/*
+ * Sum the transfer entropy over the accumulated histograms, where `qh` is the
+ * number of distinct source states.
+ */
+static double sum_transfer_entropy(inform_dist const *states,
+    inform_dist const *histories, inform_dist const *sources,
+    inform_dist const *predicates, int b, int qh)
+{
     double te = 0.0;
     int predicate, source, state;
     double n_state, n_source, n_predicate, n_history;
-    for (int history = 0; history < (int) histories_size; ++history)
+    for (int history = 0; history < (int) histories->size; ++history)
     {
-        n_history = histories.histogram[history];
+        n_history = histories->histogram[history];
         if (n_history == 0)
         {
             continue;
@@ -204,21 +285,21 @@ double inform_transfer_entropy(int const *src, int const *dst, int const *back,
         for (int future = 0; future < b; ++future)
         {
             predicate = history * b + future;
-            n_predicate = predicates.histogram[predicate];
+            n_predicate = predicates->histogram[predicate];
             if (n_predicate == 0)
             {
                 continue;
             }
-            for (int src_state = 0; src_state < b; ++src_state)
+            for (int src_state = 0; src_state < qh; ++src_state)
             {
-                source = history * b + src_state;
-                n_source = sources.histogram[source];
+                source = history * qh + src_state;
+                n_source = sources->histogram[source];
                 if (n_source == 0)
                 {
                     continue;
                 }
-                state = predicate * b + src_state;
-                n_state = states.histogram[state];
+                state = predicate * qh + src_state;
+                n_state = states->histogram[state];
                 if (n_state == 0)
                 {
                     continue;
@@ -227,19 +308,122 @@ double inform_transfer_entropy(int const *src, int const *dst, int const *back,
             }
         }
     }
+    return te / states->counts;
+}
+
+/*
+ * Compute the transfer entropy from sparse histograms, counting the runs of
+ * sorted state and predicate codes. The states are ordered by history, then
+ * source, then future, so the sources and histories are runs of them too.
+ */
+static double sparse_transfer_entropy(inform_view const *src,
+    inform_view const *dst, inform_view const *back, size_t l, size_t n,
+    size_t m, int b, embedding const *e, inform_estimator est,
+    inform_error *err)
+{
+    size_t const N = n * (m - first_step(e));
+
+    uint64_t *codes = malloc(3 * N * sizeof(uint64_t));
+    uint32_t *counts = malloc(4 * N * sizeof(uint32_t));
+    if (codes == NULL || counts == NULL)
+    {
+        free(counts);
+        free(codes);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NAN);
+    }
+
+    observe(src, dst, back, l, n, m, b, e, NULL, NULL, NULL, NULL, NULL,
+        codes);
+    inform_histogram_sort(codes, codes + 2 * N, N);
+    inform_histogram_sort(codes + N, codes + 2 * N, N);
+
+    uint64_t const qh = (uint64_t) power(b, e->h);
+    inform_dist const states = inform_histogram_runs(codes, N, 1, counts);
+    inform_dist const sources = inform_histogram_runs(codes, N, b,
+        counts + N);
+    inform_dist const histories = inform_histogram_runs(codes, N, b * qh,
+        counts + 2 * N);
+    inform_dist const predicates = inform_histogram_runs(codes + N, N, 1,
+        counts + 3 * N);
+
+    double const te = inform_shannon_cmi_est(&states, &sources, &predicates,
+        &histories, 2.0, est);
+
+    free(counts);
+    free(codes);
+
+    return te;
+}
+
+static double transfer_entropy(inform_view const *src,
+    inform_view const *dst, inform_view const *back, size_t l, size_t n,
+    size_t m, int b, embedding const *e, inform_estimator est,
+    inform_config const *config, inform_error *err)
+{
+    if (check_arguments(src, dst, back, l, n, m, b, e, config->validation,
+        err))
+    {
+        return NAN;
+    }
+    if (!inform_estimator_is_valid(est))
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NAN);
+    }
+
+    /* the states were checked to be indexable by check_arguments */
+    uint64_t const q = (uint64_t) power(b, e->k) * (uint64_t) power(b, l);
+    uint64_t const p = (uint64_t) power(b, e->h);
+    uint64_t const cells = b * p * q + q + p * q + b * q;
+    uint64_t const N = n * (m - first_step(e));
+    uint64_t const sparse = 3 * N * sizeof(uint64_t) + 4 * N * sizeof(uint32_t);
+    bool dense;
+    if (inform_histogram_choose(config, cells, sparse, est, &dense, err))
+    {
+        return NAN;
+    }
+    else if (!dense)
+    {
+        return sparse_transfer_entropy(src, dst, back, l, n, m, b, e, est,
+            err);
+    }
+
+    inform_dist states, histories, sources, predicates;
+    uint32_t *data = accumulate(src, dst, back, l, n, m, b, e, &states,
+        &histories, &sources, &predicates, err);
+    if (data == NULL)
+    {
+        return NAN;
+    }
+
+    double te;
+    if (est == INFORM_PLUGIN)
+    {
+        int const qh = (int) (sources.size / histories.size);
+        te = sum_transfer_entropy(&states, &histories, &sources, &predicates,
+            b, qh);
+    }
+    else
+    {
+        te = inform_shannon_cmi_est(&states, &sources, &predicates,
+            &histories, 2.0, est);
+    }
 
     free(data);
 
-    return te / N;
+    return te;
 }
 
-double *inform_local_transfer_entropy(int const *src, int const *dst,
-    int const *back, size_t l, size_t n, size_t m, int b, size_t k, double *te,
-    inform_error *err)
+static double *local_transfer_entropy(inform_view const *src,
+    inform_view const *dst, inform_view const *back, size_t l, size_t n,
+    size_t m, int b, embedding const *e, double *te, inform_error *err)
 {
-    if (check_arguments(src, dst, back, l, n, m, b, k, err)) return NULL;
+    if (check_arguments(src, dst, back, l, n, m, b, e, INFORM_VALIDATE_FULL,
+        err))
+    {
+        return NULL;
+    }
 
-    size_t const N = n * (m - k);
+    size_t const N = n * (m - first_step(e));
 
     bool allocate = (te == NULL);
     if (allocate)
@@ -251,52 +435,422 @@ double *inform_local_transfer_entropy(int const *src, int const *dst,
         }
     }
 
+    inform_dist states, histories, sources, predicates;
+    uint32_t *data = accumulate(src, dst, back, l, n, m, b, e, &states,
+        &histories, &sources, &predicates, err);
+    if (data == NULL)
+    {
+        if (allocate) free(te);
+        return NULL;
+    }
+
+    observe(src, dst, back, l, n, m, b, e, &states, &histories, &sources,
+        &predicates, te, NULL);
+
+    free(data);
+
+    return te;
+}
+
+double inform_transfer_entropy(int const *src, int const *dst, int const *back,
+    size_t l, size_t n, size_t m, int b, size_t k, inform_error *err)
+{
+    inform_view const x = inform_view_contiguous(src, n, m);
+    inform_view const y = inform_view_contiguous(dst, n, m);
+    inform_view const z = inform_view_contiguous(back, n, m);
+    embedding e = default_embedding;
+    e.k = k;
+    inform_config const config = inform_config_default();
+    return transfer_entropy(&x, &y, &z, l, n, m, b, &e, INFORM_PLUGIN, &config,
+        err);
+}
+
+double inform_transfer_entropy_est(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k,
+    inform_estimator est, inform_error *err)
+{
+    inform_view const x = inform_view_contiguous(src, n, m);
+    inform_view const y = inform_view_contiguous(dst, n, m);
+    inform_view const z = inform_view_contiguous(back, n, m);
+    embedding e = default_embedding;
+    e.k = k;
+    inform_config const config = inform_config_default();
+    return transfer_entropy(&x, &y, &z, l, n, m, b, &e, est, &config, err);
+}
+
+double inform_transfer_entropy_ex(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k,
+    inform_estimator est, inform_config const *config, inform_error *err)
+{
+    inform_view const x = inform_view_contiguous(src, n, m);
+    inform_view const y = inform_view_contiguous(dst, n, m);
+    inform_view const z = inform_view_contiguous(back, n, m);
+    inform_config resolved;
+    if (inform_config_resolve(config, &resolved, err)) return NAN;
+    embedding e = default_embedding;
+    e.k = k;
+    return transfer_entropy(&x, &y, &z, l, n, m, b, &e, est, &resolved, err);
+}
+
+double *inform_local_transfer_entropy(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k, double *te,
+    inform_error *err)
+{
+    inform_view const x = inform_view_contiguous(src, n, m);
+    inform_view const y = inform_view_contiguous(dst, n, m);
+    inform_view const z = inform_view_contiguous(back, n, m);
+    embedding e = default_embedding;
+    e.k = k;
+    return local_transfer_entropy(&x, &y, &z, l, n, m, b, &e, te, err);
+}
+
+double inform_transfer_entropy_embed(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k,
+    size_t k_tau, size_t h, size_t h_tau, size_t u, inform_error *err)
+{
+    inform_view const x = inform_view_contiguous(src, n, m);
+    inform_view const y = inform_view_contiguous(dst, n, m);
+    inform_view const z = inform_view_contiguous(back, n, m);
+    embedding const e = { k, k_tau, h, h_tau, u };
+    inform_config const config = inform_config_default();
+    return transfer_entropy(&x, &y, &z, l, n, m, b, &e, INFORM_PLUGIN, &config,
+        err);
+}
+
+double *inform_local_transfer_entropy_embed(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k,
+    size_t k_tau, size_t h, size_t h_tau, size_t u, double *te,
+    inform_error *err)
+{
+    inform_view const x = inform_view_contiguous(src, n, m);
+    inform_view const y = inform_view_contiguous(dst, n, m);
+    inform_view const z = inform_view_contiguous(back, n, m);
+    embedding const e = { k, k_tau, h, h_tau, u };
+    return local_transfer_entropy(&x, &y, &z, l, n, m, b, &e, te, err);
+}
+
+double inform_transfer_entropy_view(inform_view src, inform_view dst,
+    inform_view back, size_t l, size_t n, size_t m, int b, size_t k,
+    inform_error *err)
+{
+    embedding e = default_embedding;
+    e.k = k;
+    inform_config const config = inform_config_default();
+    return transfer_entropy(&src, &dst, &back, l, n, m, b, &e, INFORM_PLUGIN,
+        &config, err);
+}
+
+double *inform_local_transfer_entropy_view(inform_view src, inform_view dst,
+    inform_view back, size_t l, size_t n, size_t m, int b, size_t k,
+    double *te, inform_error *err)
+{
+    embedding e = default_embedding;
+    e.k = k;
+    return local_transfer_entropy(&src, &dst, &back, l, n, m, b, &e, te, err);
+}
+
+/*
+ * Encode the destination history (joined with the background) and predicate
+ * of each of the `n * (m - t0)` observations, and accumulate their
+ * histograms, for sharing among calculations which differ only in the
+ * source. The codes are written to a single block at `*history`, and both it
+ * and the returned histogram block must be freed by the caller.
+ */
+static uint32_t *encode_destination(int const *dst, int const *back,
+    size_t l, size_t n, size_t m, int b, size_t k, size_t t0,
+    inform_dist *histories, inform_dist *predicates, int **history,
+    int **predicate)
+{
+    size_t const N = n * (m - t0);
     size_t const q = (size_t) pow((double) b, (double) k);
     size_t const r = (size_t) pow((double) b, (double) l);
-    size_t const states_size     = b*b*q*r;
     size_t const histories_size  = q*r;
-    size_t const sources_size    = b*q*r;
     size_t const predicates_size = b*q*r;
-    size_t const total_size = states_size + histories_size + sources_size + predicates_size;
 
-    uint32_t *histogram_data = calloc(total_size, sizeof(uint32_t));
-    if (histogram_data == NULL)
+    uint32_t *histogram_data = calloc(histories_size + predicates_size,
+        sizeof(uint32_t));
+    int *codes = malloc(2 * N * sizeof(int));
+    if (histogram_data == NULL || codes == NULL)
     {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        free(codes);
+        free(histogram_data);
+        return NULL;
+    }
+    *histories  = (inform_dist){ histogram_data, histories_size, N };
+    *predicates = (inform_dist){ histogram_data + histories_size, predicates_size, N };
+    *history = codes;
+    *predicate = codes + N;
+
+    int const qk = power(b, k), rk = qk / b;
+    for (size_t i = 0, z = 0; i < n; ++i)
+    {
+        int const *x = dst + i * m;
+        int h = 0;
+        for (size_t t = t0; t < m; ++t, ++z)
+        {
+            h = embed(x, 1, t - 1, k, 1, b, rk, h, t != t0);
+            int back_state = 0;
+            for (size_t v = 0; v < l; ++v)
+            {
+                back_state = b * back_state + back[t+m*(i+n*v)-1];
+            }
+            (*history)[z] = h + back_state * qk;
+            (*predicate)[z] = (*history)[z] * b + x[t];
+            histories->histogram[(*history)[z]]++;
+            predicates->histogram[(*predicate)[z]]++;
+        }
     }
+    return histogram_data;
+}
+
+/*
+ * The shared state of a transfer entropy lag scan. The destination history
+ * and predicate codes, and their histograms, are computed once and shared by
+ * every lag.
+ */
+typedef struct lag_scan
+{
+    int const *src;
+    size_t n, m, t0;
+    int b;
+    int const *history, *predicate;
+    inform_dist const *histories, *predicates;
+    size_t const *lags;
+    double *te;
+} lag_scan;
 
-    inform_dist states     = { histogram_data, states_size, N };
-    inform_dist histories  = { histogram_data + states_size, histories_size, N };
-    inform_dist sources    = { histogram_data + states_size + histories_size, sources_size, N };
-    inform_dist predicates = { histogram_data + states_size + histories_size + sources_size, predicates_size, N };
+static void scan_lag(size_t i, void *context)
+{
+    lag_scan const *scan = context;
+    int const b = scan->b;
+    size_t const u = scan->lags[i];
+    size_t const N = scan->histories->counts;
+    size_t const sources_size = b * scan->histories->size;
+    size_t const states_size = b * sources_size;
 
-    int *state_data = malloc(4 * N * sizeof(int));
-    if (state_data == NULL)
+    uint32_t *data = calloc(states_size + sources_size, sizeof(uint32_t));
+    if (data == NULL)
+    {
+        scan->te[i] = NAN;
+        return;
+    }
+    inform_dist states  = { data, states_size, N };
+    inform_dist sources = { data + states_size, sources_size, N };
+
+    int const *history = scan->history, *predicate = scan->predicate;
+    int const *src = scan->src;
+    for (size_t j = 0; j < scan->n; ++j, src += scan->m)
+    {
+        for (size_t t = scan->t0; t < scan->m; ++t, ++history, ++predicate)
+        {
+            int const src_state = src[t - u];
+            states.histogram[*predicate * b + src_state]++;
+            sources.histogram[*history * b + src_state]++;
+        }
+    }
+
+    scan->te[i] = sum_transfer_entropy(&states, scan->histories, &sources,
+        scan->predicates, b, b);
+
+    free(data);
+}
+
+double *inform_transfer_entropy_lags(int const *src, int const *dst,
+    int const *back, size_t l, size_t n, size_t m, int b, size_t k,
+    size_t const *lags, size_t nlags, double *te, inform_error *err)
+{
+    if (lags == NULL || nlags == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    }
+    embedding e = default_embedding;
+    e.k = k;
+    for (size_t i = 0; i < nlags; ++i)
+    {
+        if (lags[i] == 0)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+        }
+        e.u = (lags[i] > e.u) ? lags[i] : e.u;
+    }
+    inform_view const src_view = inform_view_contiguous(src, n, m);
+    inform_view const dst_view = inform_view_contiguous(dst, n, m);
+    inform_view const back_view = inform_view_contiguous(back, n, m);
+    if (check_arguments(&src_view, &dst_view, &back_view, l, n, m, b, &e,
+        INFORM_VALIDATE_FULL, err))
+    {
+        return NULL;
+    }
+
+    size_t const t0 = first_step(&e);
+
+    bool allocate = (te == NULL);
+    if (allocate)
+    {
+        te = malloc(nlags * sizeof(double));
+        if (te == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    inform_dist histories, predicates;
+    int *history, *predicate;
+    uint32_t *histogram_data = encode_destination(dst, back, l, n, m, b, k,
+        t0, &histories, &predicates, &history, &predicate);
+    if (histogram_data == NULL)
     {
         if (allocate) free(te);
-        free(histogram_data);
         INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
-    int *state     = state_data;
-    int *history   = state + N;
-    int *source    = history + N;
-    int *predicate = source + N;
 
-    accumulate_local_observations(src, dst, back, l, n, m, b, k, &states,
-        &histories, &sources, &predicates, state, history, source, predicate);
+    lag_scan scan = { src, n, m, t0, b, history, predicate, &histories,
+        &predicates, lags, te };
+    inform_parallel_for(nlags, scan_lag, &scan);
+
+    free(history);
+    free(histogram_data);
+
+    for (size_t i = 0; i < nlags; ++i)
+    {
+        if (isnan(te[i]))
+        {
+            if (allocate) free(te);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
 
-    double s, t, u, v;
-    for (size_t i = 0; i < N; ++i)
+    return te;
+}
+
+/*
+ * The shared state of a multi-source local transfer entropy calculation. As
+ * with a lag scan, the destination codes and histograms are shared by every
+ * source, and the local values of source `i` are written to row `i` of `te`.
+ */
+typedef struct source_scan
+{
+    int const *srcs;
+    size_t n, m, t0;
+    int b;
+    int const *history, *predicate;
+    inform_dist const *histories, *predicates;
+    double *te;
+} source_scan;
+
+static void scan_source(size_t i, void *context)
+{
+    source_scan const *scan = context;
+    int const b = scan->b;
+    size_t const N = scan->histories->counts;
+    size_t const sources_size = b * scan->histories->size;
+    size_t const states_size = b * sources_size;
+    double *te = scan->te + i * N;
+
+    uint32_t *data = calloc(states_size + sources_size, sizeof(uint32_t));
+    if (data == NULL)
     {
-        s = states.histogram[state[i]];
-        t = sources.histogram[source[i]];
-        u = predicates.histogram[predicate[i]];
-        v = histories.histogram[history[i]];
-        te[i] = log2((s*v)/(t*u));
+        te[0] = NAN;
+        return;
     }
+    uint32_t *states = data, *sources = data + states_size;
 
-    free(state_data);
+    int const *history = scan->history, *predicate = scan->predicate;
+    int const *src = scan->srcs + i * scan->n * scan->m;
+    for (size_t j = 0, z = 0; j < scan->n; ++j)
+    {
+        for (size_t t = scan->t0; t < scan->m; ++t, ++z)
+        {
+            int const src_state = src[j * scan->m + t - 1];
+            states[predicate[z] * b + src_state]++;
+            sources[history[z] * b + src_state]++;
+        }
+    }
+
+    for (size_t j = 0, z = 0; j < scan->n; ++j)
+    {
+        for (size_t t = scan->t0; t < scan->m; ++t, ++z)
+        {
+            int const src_state = src[j * scan->m + t - 1];
+            double const s = states[predicate[z] * b + src_state];
+            double const u = scan->predicates->histogram[predicate[z]];
+            double const v = scan->histories->histogram[history[z]];
+            double const w = sources[history[z] * b + src_state];
+            te[z] = log2((s*v)/(w*u));
+        }
+    }
+
+    free(data);
+}
+
+double *inform_local_transfer_entropy_sources(int const *srcs,
+    int const *dst, int const *back, size_t nsrcs, size_t l, size_t n,
+    size_t m, int b, size_t k, double *te, inform_error *err)
+{
+    if (nsrcs == 0)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, NULL);
+    }
+    embedding e = default_embedding;
+    e.k = k;
+    inform_view const src_view = inform_view_contiguous(srcs, n, m);
+    inform_view const dst_view = inform_view_contiguous(dst, n, m);
+    inform_view const back_view = inform_view_contiguous(back, n, m);
+    if (check_arguments(&src_view, &dst_view, &back_view, l, n, m, b, &e,
+        INFORM_VALIDATE_FULL, err))
+    {
+        return NULL;
+    }
+    for (size_t i = n * m; i < nsrcs * n * m; ++i)
+    {
+        if (b <= srcs[i])
+        {
+            INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, NULL);
+        }
+        else if (srcs[i] < 0)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, NULL);
+        }
+    }
+
+    size_t const t0 = first_step(&e);
+    size_t const N = n * (m - t0);
+
+    bool allocate = (te == NULL);
+    if (allocate)
+    {
+        te = malloc(nsrcs * N * sizeof(double));
+        if (te == NULL)
+        {
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    inform_dist histories, predicates;
+    int *history, *predicate;
+    uint32_t *histogram_data = encode_destination(dst, back, l, n, m, b, k,
+        t0, &histories, &predicates, &history, &predicate);
+    if (histogram_data == NULL)
+    {
+        if (allocate) free(te);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+
+    source_scan scan = { srcs, n, m, t0, b, history, predicate, &histories,
+        &predicates, te };
+    inform_parallel_for(nsrcs, scan_source, &scan);
+
+    free(history);
     free(histogram_data);
 
+    for (size_t i = 0; i < nsrcs; ++i)
+    {
+        if (isnan(te[i * N]))
+        {
+            if (allocate) free(te);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
     return te;
 }
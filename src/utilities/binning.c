@@ -1,12 +1,49 @@
 // Copyright 2016-2018 ELIFE. All rights reserved.
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
-#include <assert.h>
 #include <float.h>
 #include <inform/utilities/binning.h>
 #include <math.h>
+#include <stdbool.h>
 #include <string.h>
 
+/*
+ * The number of samples binned at a time by `bin_bounds_blocked`.
+ */
+#define BIN_BLOCK 2048
+
+/*
+ * The largest number of bounds for which comparing each sample against every
+ * bound beats a binary search.
+ */
+#define BIN_LINEAR_BOUNDS 16
+
+static void range_of(double const *series, size_t n, double *min, double *max)
+{
+    double a = series[0], b = series[0];
+    for (size_t i = 1; i < n; ++i)
+    {
+        a = (series[i] < a) ? series[i] : a;
+        b = (b < series[i]) ? series[i] : b;
+    }
+    *min = a;
+    *max = b;
+}
+
+/*
+ * Place each sample of a series with the given extrema into bins of width
+ * `step`. Since `series[i] - min` is never negative, truncation agrees with
+ * `floor` and the loop is free to vectorize.
+ */
+static void bin_uniform(double const *series, size_t n, double min, double max,
+    double step, int *binned)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        binned[i] = (int) ((series[i] - min) / step) - (series[i] == max);
+    }
+}
+
 double inform_range(double const *series, size_t n, double *min, double *max,
     inform_error *err)
 {
@@ -15,12 +52,8 @@ double inform_range(double const *series, size_t n, double *min, double *max,
     else if (n == 0)
         INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, 0.0);
 
-    double a = series[0], b = series[0];
-    for (size_t i = 1; i < n; ++i)
-    {
-        if (series[i] < a) a = series[i];
-        if (b < series[i]) b = series[i];
-    }
+    double a, b;
+    range_of(series, n, &a, &b);
     if (min != NULL) *min = a;
     if (max != NULL) *max = b;
     return (b - a);
@@ -39,8 +72,8 @@ double inform_bin(double const *series, size_t n, int b, int *binned,
         INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0.0);
 
     double min, max;
-    double range = inform_range(series, n, &min, &max, err);
-    double step = range / b;
+    range_of(series, n, &min, &max);
+    double step = (max - min) / b;
 
     if (step <= 10.*DBL_EPSILON)
     {
@@ -48,11 +81,36 @@ double inform_bin(double const *series, size_t n, int b, int *binned,
         INFORM_ERROR_RETURN(err, INFORM_EBIN, step);
     }
 
+    bin_uniform(series, n, min, max, step, binned);
+
+    return step;
+}
+
+double inform_bin_range(double const *series, size_t n, double min,
+    double max, int b, int *binned, inform_error *err)
+{
+    if (series == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0.0);
+    else if (n == 0)
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, 0.0);
+    else if (b < 2 || !(min < max) || !isfinite(max - min))
+        INFORM_ERROR_RETURN(err, INFORM_EBIN, 0.0);
+    else if (binned == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0.0);
+
+    double step = (max - min) / b;
+    if (step <= 10.*DBL_EPSILON)
+        INFORM_ERROR_RETURN(err, INFORM_EBIN, step);
+
+    int outside = 0;
     for (size_t i = 0; i < n; ++i)
     {
-        binned[i] = (int) floor((series[i] - min) / step) - (series[i] == max);
-        assert(0 <= binned[i] && binned[i] < b);
+        outside |= !(min <= series[i] && series[i] <= max);
     }
+    if (outside)
+        INFORM_ERROR_RETURN(err, INFORM_EBIN, step);
+
+    bin_uniform(series, n, min, max, step, binned);
 
     return step;
 }
@@ -70,20 +128,88 @@ int inform_bin_step(double const *series, size_t n, double step, int *binned,
         INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0);
 
     double min, max;
-    double range = inform_range(series, n, &min, &max, err);
+    range_of(series, n, &min, &max);
+    double range = max - min;
     int b = (int) ceil(range / step);
 
     if (fmod(range,step) == 0.0) ++b;
 
     for (size_t i = 0; i < n; ++i)
     {
-        binned[i] = (int) floor((series[i] - min) / step);
-        assert(0 <= binned[i] && binned[i] < b);
+        binned[i] = (int) ((series[i] - min) / step);
     }
 
     return b;
 }
 
+/*
+ * Bin against a handful of sorted bounds by counting, for each sample, the
+ * bounds that it is not less than. The samples are processed a block at a
+ * time so that each pass over a bound is a vectorizable compare-and-add.
+ */
+static void bin_bounds_blocked(double const *series, size_t n,
+    double const *bounds, size_t m, int *binned)
+{
+    for (size_t j = 0; j < n; j += BIN_BLOCK)
+    {
+        size_t const w = (n - j < BIN_BLOCK) ? n - j : BIN_BLOCK;
+        double const *x = series + j;
+        int *y = binned + j;
+        memset(y, 0, w * sizeof(int));
+        for (size_t k = 0; k < m; ++k)
+        {
+            double const bound = bounds[k];
+            for (size_t i = 0; i < w; ++i)
+            {
+                y[i] += !(x[i] < bound);
+            }
+        }
+    }
+}
+
+/*
+ * Bin against many sorted bounds with a branchless binary search for the
+ * number of bounds that each sample is not less than.
+ */
+static void bin_bounds_search(double const *series, size_t n,
+    double const *bounds, size_t m, int *binned)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        double const x = series[i];
+        double const *base = bounds;
+        size_t len = m;
+        while (len > 1)
+        {
+            size_t const half = len / 2;
+            base = (x < base[half]) ? base : base + half;
+            len -= half;
+        }
+        binned[i] = (int) (base - bounds) + !(x < *base);
+    }
+}
+
+/*
+ * Bin against unsorted bounds, placing each sample in the bin of the first
+ * bound that it is less than.
+ */
+static void bin_bounds_scan(double const *series, size_t n,
+    double const *bounds, size_t m, int *binned)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        binned[i] = (int)m;
+        for (int x = 0; x < (int)m; ++x)
+        {
+            if (series[i] < bounds[x])
+            {
+                binned[i] = x;
+                break;
+            }
+        }
+    }
+}
+
 int inform_bin_bounds(double const *series, size_t n, double const *bounds,
     size_t m, int *binned, inform_error *err)
 {
@@ -96,18 +222,22 @@ int inform_bin_bounds(double const *series, size_t n, double const *bounds,
     else if (binned == NULL)
         INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0);
 
+    bool sorted = true;
+    for (size_t k = 1; k < m && sorted; ++k)
+    {
+        sorted = (bounds[k-1] <= bounds[k]);
+    }
+
+    if (!sorted)
+        bin_bounds_scan(series, n, bounds, m, binned);
+    else if (m <= BIN_LINEAR_BOUNDS)
+        bin_bounds_blocked(series, n, bounds, m, binned);
+    else
+        bin_bounds_search(series, n, bounds, m, binned);
+
     int b = 0;
     for (size_t i = 0; i < n; ++i)
     {
-        binned[i] = (int)m;
-        for (int x = 0; x < (int)m; ++x)
-        {
-            if (series[i] < bounds[x])
-            {
-                binned[i] = x;
-                break;
-            }
-        }
         b = (b < binned[i]) ? binned[i] : b;
     }
 
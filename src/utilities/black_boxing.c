@@ -1,17 +1,117 @@
 // Copyright 2016-2018 ELIFE. All rights reserved.
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
-#include <inform/error.h>
+#include <inform/utilities/black_boxing.h>
 #include <string.h>
 #include <math.h>
 
-#include <stdio.h>
+#include "../encoder.h"
+#include "../parallel.h"
+#include "../view.h"
 
-static bool check_arguments(int const *series, size_t l, size_t n, size_t m,
-    int const *b, size_t const *r, size_t const *s, inform_error *err)
+/*
+ * The number of time steps of a single initial condition encoded by each
+ * task of `inform_black_box`.
+ */
+#define BLACK_BOX_BLOCK 4096
+
+/*
+ * The number of encoded samples below which `inform_black_box` and its
+ * argument checks are not worth distributing across threads.
+ */
+#define BLACK_BOX_PARALLEL_GRAIN (1 << 16)
+
+typedef struct state_check
+{
+    inform_view const *series;
+    size_t rows, len, chunks;
+    int const *b;
+    inform_error *errs;
+} state_check;
+
+/*
+ * Check one chunk of at most BLACK_BOX_PARALLEL_GRAIN samples of one row of
+ * a single variable, recording the first invalid state found.
+ */
+static void check_chunk(size_t task, void *context)
 {
+    state_check const *check = context;
+    size_t const i = task / (check->rows * check->chunks);
+    size_t const row = (task / check->chunks) % check->rows;
+    size_t const j0 = (task % check->chunks) * BLACK_BOX_PARALLEL_GRAIN;
+    size_t const width = (check->len - j0 < BLACK_BOX_PARALLEL_GRAIN) ? check->len - j0 : BLACK_BOX_PARALLEL_GRAIN;
+    ptrdiff_t const stride = check->series->time_stride;
+    int const *x = inform_view_row(check->series, i, row) + (ptrdiff_t) j0 * stride;
+    int const b = check->b[i];
+
+    int bad = 0;
+    for (size_t j = 0; j < width; ++j)
+    {
+        int const state = x[(ptrdiff_t) j * stride];
+        bad |= (state < 0) | (state >= b);
+    }
+    check->errs[task] = INFORM_SUCCESS;
+    for (size_t j = 0; bad && j < width; ++j)
+    {
+        int const state = x[(ptrdiff_t) j * stride];
+        if (state < 0)
+        {
+            check->errs[task] = INFORM_ENEGSTATE;
+            break;
+        }
+        else if (state >= b)
+        {
+            check->errs[task] = INFORM_EBADSTATE;
+            break;
+        }
+    }
+}
 
-    if (series == NULL)
+/*
+ * Check that each of the `l` variables of a view, with `n` initial conditions
+ * of `m` samples each, only takes states valid for its base, reporting the
+ * first invalid state.
+ */
+static bool check_states(inform_view const *series, size_t l, size_t n,
+    size_t m, int const *b, inform_error *err)
+{
+    bool const packed = inform_view_is_packed(series, n, m);
+    size_t const rows = packed ? 1 : n, len = packed ? n * m : m;
+    size_t const chunks = (len + BLACK_BOX_PARALLEL_GRAIN - 1) / BLACK_BOX_PARALLEL_GRAIN;
+    size_t const tasks = l * rows * chunks;
+    inform_error *errs = malloc(tasks * sizeof(inform_error));
+    if (errs == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, true);
+    }
+    state_check check = { series, rows, len, chunks, b, errs };
+    if (l * n * m >= BLACK_BOX_PARALLEL_GRAIN)
+    {
+        inform_parallel_for(tasks, check_chunk, &check);
+    }
+    else
+    {
+        for (size_t i = 0; i < tasks; ++i) check_chunk(i, &check);
+    }
+    for (size_t i = 0; i < tasks; ++i)
+    {
+        if (errs[i] != INFORM_SUCCESS)
+        {
+            inform_error const e = errs[i];
+            free(errs);
+            INFORM_ERROR_RETURN(err, e, true);
+        }
+    }
+    free(errs);
+    return false;
+}
+
+static bool check_arguments(inform_view const *series, size_t l, size_t n,
+    size_t m, int const *b, size_t const *r, size_t const *s,
+    inform_error *err)
+{
+
+    if (series->data == NULL)
     {
         INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
     }
@@ -54,56 +154,20 @@ static bool check_arguments(int const *series, size_t l, size_t n, size_t m,
             }
         }
     }
-    double bits = 0.0;
-    if (r != NULL)
-    {
-        for (size_t i = 0; i < l; ++i)
-        {
-            if (b[i] < 2)
-            {
-                INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
-            }
-            bits += r[i] * log2(b[i]);
-        }
-    }
-    else
+    uint64_t support = 1;
+    for (size_t i = 0; i < l; ++i)
     {
-        for (size_t i = 0; i < l; ++i)
+        if (b[i] < 2)
         {
-            if (b[i] < 2)
-            {
-                INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
-            }
-            bits += log2(b[i]);
+            INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
         }
-    }
-    if (s != NULL)
-    {
-        for (size_t i = 0; i < l; ++i)
+        size_t const k = ((r != NULL) ? r[i] : 1) + ((s != NULL) ? s[i] : 0);
+        if (!inform_encoder_extend(&support, b[i], k, INT_MAX))
         {
-            bits += s[i] * log2(b[i]);
+            INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
         }
     }
-    if (bits > 30.0)
-    {
-        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
-    }
-    for (size_t i = 0; i < l; ++i)
-    {
-        for (size_t j = 0; j < n * m; ++j)
-        {
-            if (series[n*m*i + j] < 0)
-            {
-                INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
-            }
-            else if (series[n*m*i + j] >= b[i])
-            {
-                INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
-            }
-        }
-    }
-
-    return false;
+    return check_states(series, l, n, m, b, err);
 }
 
 static void compute_lengths(size_t const *r, size_t const *s, size_t l,
@@ -133,48 +197,85 @@ static void compute_lengths(size_t const *r, size_t const *s, size_t l,
     }
 }
 
-static void accumulate(int const *series, size_t l, size_t n, size_t m,
-    int const *b, size_t const *r, size_t const *s, size_t max_r, size_t max_s,
-    int *box, inform_error *err)
+typedef struct black_box_job
 {
-    int *data = malloc(2 * l * sizeof(int));
-    if (data == NULL) INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM);
+    inform_view const *series;
+    size_t l, n, m;
+    int const *b;
+    size_t const *r, *s;
+    size_t max_r, w, blocks;
+    int *box;
+} black_box_job;
 
-    int *qs = data, *states = qs + l;
-    size_t const w = m - max_r - max_s + 1;
-    for (size_t i = 0; i < n * w; ++i) box[i] = 0;
-    
-    for (size_t i = 0; i < l; ++i)
+/*
+ * Encode one tile of the black-boxed series: a block of at most
+ * BLACK_BOX_BLOCK consecutive time steps of a single initial condition. The
+ * tile is written directly into the output and stays in cache while each
+ * variable is folded into it.
+ */
+static void encode_tile(size_t task, void *context)
+{
+    black_box_job const *job = context;
+    size_t const j = task / job->blocks;
+    size_t const t0 = (task % job->blocks) * BLACK_BOX_BLOCK;
+    size_t const width = (job->w - t0 < BLACK_BOX_BLOCK) ? job->w - t0 : BLACK_BOX_BLOCK;
+
+    int *box = job->box + job->w * j + t0;
+    memset(box, 0, width * sizeof(int));
+    for (size_t i = 0; i < job->l; ++i)
     {
-        for (size_t j = 0; j < n; ++j)
+        // the samples of the i-th variable, offset so that the embedding
+        // of box[t] spans present[t - r, t + s)
+        ptrdiff_t const d = job->series->time_stride;
+        int const *present = inform_view_row(job->series, i, j)
+            + (ptrdiff_t) (job->max_r + t0) * d;
+        int const b = job->b[i];
+        ptrdiff_t const r = (ptrdiff_t) job->r[i], s = (ptrdiff_t) job->s[i];
+        if (r == 1 && s == 0)
         {
-            qs[i] = 1;
-            states[i] = 0;
-            for (size_t k = max_r - r[i]; k < max_r + s[i]; ++k)
-            {
-                qs[i] *= b[i];
-                states[i] *= b[i];
-                states[i] += series[k + m * (j + n * i)];
-            }
-            box[w * j] *= qs[i];
-            box[w * j] += states[i];
-
-            for (size_t k = max_r; k < m - max_s; ++k)
-            {
-                states[i] *= b[i];
-                states[i] -= series[k - r[i] + m * (j + n * i)] * qs[i];
-                states[i] += series[k + s[i] + m * (j + n * i)];
-                box[k - max_r + 1 + w * j] *= qs[i];
-                box[k - max_r + 1 + w * j] += states[i];
-            }
+            // the embedding of a single sample is the sample itself
+            inform_encoder_fold_strided(box, present - d, d, b, width);
+            continue;
+        }
+        int q = 1, state = 0;
+        for (ptrdiff_t k = -r; k < s; ++k)
+        {
+            q *= b;
+            state = state * b + present[k * d];
+        }
+        box[0] = box[0] * q + state;
+        // drop the oldest sample before shifting, so that the state never
+        // exceeds q, which may be as large as INT_MAX
+        int const top = q / b;
+        for (ptrdiff_t t = 1; t < (ptrdiff_t) width; ++t)
+        {
+            state = (state - present[(t - 1 - r) * d] * top) * b
+                + present[(t - 1 + s) * d];
+            box[t] = box[t] * q + state;
         }
     }
-        
-    free(data);
 }
 
-int* inform_black_box(int const *series, size_t l, size_t n, size_t m,
-    int const *b, size_t const *r, size_t const *s, int *box, inform_error *err)
+static void accumulate(inform_view const *series, size_t l, size_t n, size_t m,
+    int const *b, size_t const *r, size_t const *s, size_t max_r, size_t max_s,
+    int *box)
+{
+    size_t const w = m - max_r - max_s + 1;
+    size_t const blocks = (w + BLACK_BOX_BLOCK - 1) / BLACK_BOX_BLOCK;
+    black_box_job job = { series, l, n, m, b, r, s, max_r, w, blocks, box };
+    if (l * n * w >= BLACK_BOX_PARALLEL_GRAIN)
+    {
+        inform_parallel_for(n * blocks, encode_tile, &job);
+    }
+    else
+    {
+        for (size_t i = 0; i < n * blocks; ++i) encode_tile(i, &job);
+    }
+}
+
+static int *black_box(inform_view const *series, size_t l, size_t n,
+    size_t m, int const *b, size_t const *r, size_t const *s, int *box,
+    inform_error *err)
 {
     if (check_arguments(series, l, n, m, b, r, s, err))
     {
@@ -186,7 +287,7 @@ int* inform_black_box(int const *series, size_t l, size_t n, size_t m,
     bool allocate = (box == NULL);
     if (allocate)
     {
-        box = calloc(n * (m - max_r - max_s + 1), sizeof(int));
+        box = malloc(n * (m - max_r - max_s + 1) * sizeof(int));
         if (box == NULL)
         {
             INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
@@ -216,17 +317,25 @@ int* inform_black_box(int const *series, size_t l, size_t n, size_t m,
         memcpy(future, s, l * sizeof(size_t));
     }
 
-    accumulate(series, l, n, m, b, history, future, max_r, max_s, box, err);
+    accumulate(series, l, n, m, b, history, future, max_r, max_s, box);
 
-    if (inform_failed(err))
-    {
-        if (allocate) free(box);
-        box = NULL;
-    }
     free(data);
     return box;
 }
 
+int *inform_black_box(int const *series, size_t l, size_t n, size_t m,
+    int const *b, size_t const *r, size_t const *s, int *box, inform_error *err)
+{
+    inform_view const view = inform_view_contiguous(series, n, m);
+    return black_box(&view, l, n, m, b, r, s, box, err);
+}
+
+int *inform_black_box_view(inform_view series, size_t l, size_t n, size_t m,
+    int const *b, size_t const *r, size_t const *s, int *box, inform_error *err)
+{
+    return black_box(&series, l, n, m, b, r, s, box, err);
+}
+
 static int compare_ints(void const *x, void const *y)
 {
     int a = *(int const *)x;
@@ -237,7 +346,8 @@ static int compare_ints(void const *x, void const *y)
 int *inform_black_box_parts(int const *series, size_t l, size_t n, int const *b,
     size_t const *parts, size_t nparts, int *box, inform_error *err)
 {
-    if (check_arguments(series, l, 1, n, b, NULL, NULL, err))
+    inform_view const view = inform_view_contiguous(series, 1, n);
+    if (check_arguments(&view, l, 1, n, b, NULL, NULL, err))
     {
         return NULL;
     }
@@ -317,33 +427,13 @@ int *inform_black_box_parts(int const *series, size_t l, size_t n, int const *b,
             }
             else
             {
-                int *subbases = malloc(k * (1 + n) * sizeof(int));
-                int *subseries = subbases + k;
-                if (subseries == NULL)
-                {
-                    free(members);
-                    if (allocate) free(box);
-                    INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
-                }
                 bases[i] = 1;
                 for (size_t j = 0; j < k; ++j)
                 {
-                    subbases[j] = b[members[j]];
-                    bases[i] *= subbases[j];
-                    for (size_t p = 0; p < n; ++p)
-                    {
-                        subseries[p + n*j] = series[p + n*members[j]];
-                    }
-                }
-                inform_black_box(subseries, k, 1, n, subbases, NULL, NULL,
-                    partitioned + n*i, err);
-                free(subbases);
-                if (inform_failed(err))
-                {
-                    free(members);
-                    if (allocate) free(box);
-                    return NULL;
+                    bases[i] *= b[members[j]];
                 }
+                inform_encoder_columns(series, k, n, b, members,
+                    partitioned + n*i);
             }
             for (size_t i = 0; i < l; ++i) members[i] = -1;
         }
@@ -2,7 +2,23 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include <inform/utilities/coalesce.h>
-#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "../parallel.h"
+
+/*
+ * A series is coalesced through a lookup table indexed by value whenever its
+ * range is at most COALESCE_DENSE_FACTOR times its length, or at most
+ * COALESCE_DENSE_RANGE; otherwise the observed values are hashed.
+ */
+#define COALESCE_DENSE_FACTOR 4
+#define COALESCE_DENSE_RANGE (1 << 16)
+
+/*
+ * The number of values below which the columns of `inform_coalesce_columns`
+ * are not worth distributing across threads.
+ */
+#define COALESCE_PARALLEL_GRAIN (1 << 16)
 
 static int compare_ints(void const *a, void const *b)
 {
@@ -13,6 +29,136 @@ static int compare_ints(void const *a, void const *b)
     return 0;
 }
 
+/*
+ * Coalesce a series whose values lie in `[min, min + range)` by marking the
+ * observed values in a table and replacing each mark with its rank.
+ */
+static int coalesce_dense(int const *series, size_t n, int min, size_t range,
+    int *coal, inform_error *err)
+{
+    int *rank = calloc(range, sizeof(int));
+    if (rank == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, 0);
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        rank[(size_t) ((int64_t) series[i] - min)] = 1;
+    }
+    int b = 0;
+    for (size_t j = 0; j < range; ++j)
+    {
+        if (rank[j]) rank[j] = b++;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        coal[i] = rank[(size_t) ((int64_t) series[i] - min)];
+    }
+    free(rank);
+    return b;
+}
+
+/*
+ * An open-addressed hash table from observed values to their rank. An empty
+ * slot has a negative rank.
+ */
+typedef struct coalesce_slot
+{
+    int key;
+    int rank;
+} coalesce_slot;
+
+typedef struct coalesce_table
+{
+    coalesce_slot *slots;
+    unsigned bits;
+} coalesce_table;
+
+static coalesce_slot *table_find(coalesce_table const *table, int key)
+{
+    size_t const mask = ((size_t) 1 << table->bits) - 1;
+    size_t h = (size_t) (((uint32_t) key * 2654435769u) >> (32 - table->bits));
+    while (table->slots[h].rank >= 0 && table->slots[h].key != key)
+    {
+        h = (h + 1) & mask;
+    }
+    return table->slots + h;
+}
+
+static bool table_reset(coalesce_table *table, unsigned bits)
+{
+    size_t const capacity = (size_t) 1 << bits;
+    coalesce_slot *slots = realloc(table->slots, capacity * sizeof(coalesce_slot));
+    if (slots == NULL)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        slots[i].rank = -1;
+    }
+    table->slots = slots;
+    table->bits = bits;
+    return true;
+}
+
+/*
+ * Coalesce a series with a sparse range by hashing its values, sorting the
+ * distinct values and storing their ranks back into the table.
+ */
+static int coalesce_sparse(int const *series, size_t n, int *coal,
+    inform_error *err)
+{
+    coalesce_table table = { NULL, 0 };
+    int *distinct = malloc(n * sizeof(int));
+    if (distinct == NULL || !table_reset(&table, 6))
+    {
+        free(distinct);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, 0);
+    }
+
+    size_t b = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        coalesce_slot *slot = table_find(&table, series[i]);
+        if (slot->rank < 0)
+        {
+            slot->key = series[i];
+            slot->rank = 0;
+            distinct[b++] = series[i];
+            if (2 * b > ((size_t) 1 << table.bits))
+            {
+                if (table.bits == 31 || !table_reset(&table, table.bits + 1))
+                {
+                    free(table.slots);
+                    free(distinct);
+                    INFORM_ERROR_RETURN(err, INFORM_ENOMEM, 0);
+                }
+                for (size_t j = 0; j < b; ++j)
+                {
+                    slot = table_find(&table, distinct[j]);
+                    slot->key = distinct[j];
+                    slot->rank = 0;
+                }
+            }
+        }
+    }
+
+    qsort(distinct, b, sizeof(int), compare_ints);
+    for (size_t j = 0; j < b; ++j)
+    {
+        table_find(&table, distinct[j])->rank = (int) j;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        coal[i] = table_find(&table, series[i])->rank;
+    }
+
+    free(table.slots);
+    free(distinct);
+    return (int) b;
+}
+
 int inform_coalesce(int const *series, size_t n, int *coal, inform_error *err)
 {
     if (series == NULL)
@@ -22,43 +168,87 @@ int inform_coalesce(int const *series, size_t n, int *coal, inform_error *err)
     else if (coal == NULL)
         INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0);
 
-    int *tmp = malloc(n * sizeof(int));
-    if (tmp == NULL)
+    int min = series[0], max = series[0];
+    for (size_t i = 1; i < n; ++i)
     {
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, 0);
+        min = (series[i] < min) ? series[i] : min;
+        max = (series[i] > max) ? series[i] : max;
     }
-    memcpy(tmp, series, n * sizeof(int));
-    qsort(tmp, n, sizeof(int), compare_ints);
-    int b = 1;
-    for (size_t i = 1; i < n; ++i)
+
+    uint64_t const range = (uint64_t) ((int64_t) max - min) + 1;
+    if (range <= COALESCE_DENSE_RANGE || range / COALESCE_DENSE_FACTOR <= n)
     {
-        if (tmp[i] != tmp[i-1]) ++b;
+        return coalesce_dense(series, n, min, (size_t) range, coal, err);
     }
+    return coalesce_sparse(series, n, coal, err);
+}
+
+typedef struct coalesce_job
+{
+    int const *series;
+    size_t n;
+    int *coal;
+    int *b;
+    inform_error *errs;
+} coalesce_job;
 
-    int *map = malloc(b * sizeof(int));
-    if (map == NULL)
+static void coalesce_column(size_t i, void *context)
+{
+    coalesce_job const *job = context;
+    job->b[i] = inform_coalesce(job->series + i * job->n, job->n,
+        job->coal + i * job->n, job->errs + i);
+}
+
+int *inform_coalesce_columns(int const *series, size_t l, size_t n, int *coal,
+    int *b, inform_error *err)
+{
+    if (series == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, NULL);
+    else if (l == 0)
+        INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, NULL);
+    else if (n == 0)
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, NULL);
+    else if (coal == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, NULL);
+
+    inform_error *errs = calloc(l, sizeof(inform_error));
+    if (errs == NULL)
     {
-        free(tmp);
-        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, 0);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
     }
-    map[0] = tmp[0];
-    for (size_t i = 1, j = 1; i < n; ++i)
+
+    bool allocate_b = (b == NULL);
+    if (allocate_b)
     {
-        if (tmp[i] != tmp[i-1]) map[j++] = tmp[i];
+        b = malloc(l * sizeof(int));
+        if (b == NULL)
+        {
+            free(errs);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
     }
-    free(tmp);
 
-    for (size_t i = 0; i < n; ++i)
+    coalesce_job job = { series, n, coal, b, errs };
+    if (l > 1 && l * n >= COALESCE_PARALLEL_GRAIN)
+    {
+        inform_parallel_for(l, coalesce_column, &job);
+    }
+    else
     {
-        int *x = bsearch(series + i, map, b, sizeof(int), compare_ints);
-        if (x == NULL)
+        for (size_t i = 0; i < l; ++i) coalesce_column(i, &job);
+    }
+
+    for (size_t i = 0; i < l; ++i)
+    {
+        if (errs[i] != INFORM_SUCCESS)
         {
-            free(map);
-            INFORM_ERROR_RETURN(err, INFORM_EBIN, 0);
+            inform_error const e = errs[i];
+            free(errs);
+            if (allocate_b) free(b);
+            INFORM_ERROR_RETURN(err, e, NULL);
         }
-        coal[i] = (int) (x - map);
     }
 
-    free(map);
+    free(errs);
     return b;
-}
\ No newline at end of file
+}
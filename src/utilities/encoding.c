@@ -4,6 +4,8 @@
 #include <inform/utilities/encoding.h>
 #include <math.h>
 
+#include "../encoder.h"
+
 int32_t inform_encode(int const *state, size_t n, int b, inform_error *err)
 {
     if (state == NULL || n == 0)
@@ -39,3 +41,113 @@ void inform_decode(int32_t encoding, int b, int *state, size_t n, inform_error *
     if (encoding != 0)
         INFORM_ERROR_RETURN_VOID(err, INFORM_EENCODE);
 }
+
+uint64_t inform_encode_mixed(int const *state, size_t n, int const *b,
+    inform_error *err)
+{
+    if (state == NULL || n == 0)
+        INFORM_ERROR_RETURN(err, INFORM_EARG, 0);
+    else if (b == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, 0);
+    for (size_t i = 0; i < n; ++i)
+        if (b[i] < 2)
+            INFORM_ERROR_RETURN(err, INFORM_EBASE, 0);
+
+    uint64_t support;
+    if (!inform_encoder_support(b, n, UINT64_MAX, &support))
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, 0);
+
+    uint64_t encoding = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (state[i] < 0 || b[i] <= state[i])
+            INFORM_ERROR_RETURN(err, INFORM_EENCODE, 0);
+        encoding *= (uint64_t) b[i];
+        encoding += (uint64_t) state[i];
+    }
+    return encoding;
+}
+
+void inform_decode_mixed(uint64_t encoding, int const *b, int *state,
+    size_t n, inform_error *err)
+{
+    if (b == NULL)
+        INFORM_ERROR_RETURN_VOID(err, INFORM_EBASE);
+    else if (state == NULL || n == 0)
+        INFORM_ERROR_RETURN_VOID(err, INFORM_EARG);
+    for (size_t i = 0; i < n; ++i)
+        if (b[i] < 2)
+            INFORM_ERROR_RETURN_VOID(err, INFORM_EBASE);
+
+    for (size_t i = n; i-- > 0; encoding /= (uint64_t) b[i])
+        state[i] = (int) (encoding % (uint64_t) b[i]);
+
+    if (encoding != 0)
+        INFORM_ERROR_RETURN_VOID(err, INFORM_EENCODE);
+}
+
+static bool check_series(int const *series, size_t l, size_t N, int const *b,
+    uint64_t limit, inform_error *err)
+{
+    if (series == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, true);
+    else if (l == 0)
+        INFORM_ERROR_RETURN(err, INFORM_ENOSOURCES, true);
+    else if (N == 0)
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, true);
+    else if (b == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
+    for (size_t i = 0; i < l; ++i)
+        if (b[i] < 2)
+            INFORM_ERROR_RETURN(err, INFORM_EBASE, true);
+
+    uint64_t support;
+    if (!inform_encoder_support(b, l, limit, &support))
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, true);
+
+    for (size_t i = 0; i < l; ++i)
+    {
+        for (size_t j = 0; j < N; ++j)
+        {
+            if (series[j + N * i] < 0)
+                INFORM_ERROR_RETURN(err, INFORM_ENEGSTATE, true);
+            else if (b[i] <= series[j + N * i])
+                INFORM_ERROR_RETURN(err, INFORM_EBADSTATE, true);
+        }
+    }
+    return false;
+}
+
+int *inform_encode_series(int const *series, size_t l, size_t N, int const *b,
+    int *codes, inform_error *err)
+{
+    if (check_series(series, l, N, b, INT_MAX, err))
+        return NULL;
+
+    if (codes == NULL)
+    {
+        codes = malloc(N * sizeof(int));
+        if (codes == NULL)
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+
+    inform_encoder_columns(series, l, N, b, NULL, codes);
+    return codes;
+}
+
+uint64_t *inform_encode_series64(int const *series, size_t l, size_t N,
+    int const *b, uint64_t *codes, inform_error *err)
+{
+    if (check_series(series, l, N, b, UINT64_MAX, err))
+        return NULL;
+
+    if (codes == NULL)
+    {
+        codes = malloc(N * sizeof(uint64_t));
+        if (codes == NULL)
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+
+    inform_encoder_columns64(series, l, N, b, NULL, codes);
+    return codes;
+}
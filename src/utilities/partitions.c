@@ -41,4 +41,68 @@ size_t inform_next_partitioning(size_t *xs, size_t size)
         }
     }
     return n;
-}
\ No newline at end of file
+}
+
+/*
+ * Find the last element of a partitioning which is not the first member of
+ * its block, and so can be moved into the next block, returning `size` if
+ * there is none.
+ */
+static size_t last_movable(size_t const *xs, size_t size)
+{
+    for (size_t i = size; i-- > 1;)
+    {
+        if (xs[i] < size - 1)
+        {
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (xs[j] == xs[i])
+                {
+                    return i;
+                }
+            }
+        }
+    }
+    return size;
+}
+
+static void note_change(size_t *changed, size_t *nchanged, size_t block)
+{
+    for (size_t k = 0; k < *nchanged; ++k)
+    {
+        if (changed[k] == block)
+        {
+            return;
+        }
+    }
+    changed[(*nchanged)++] = block;
+}
+
+size_t inform_next_partitioning_changes(size_t *xs, size_t size,
+    size_t *changed, size_t *nchanged)
+{
+    *nchanged = 0;
+    size_t const i = (size > 1) ? last_movable(xs, size) : size;
+    if (i == size)
+    {
+        return 0;
+    }
+
+    for (size_t k = i; k < size; ++k)
+    {
+        size_t const next = (k == i) ? xs[k] + 1 : 0;
+        if (next != xs[k])
+        {
+            note_change(changed, nchanged, xs[k]);
+            note_change(changed, nchanged, next);
+            xs[k] = next;
+        }
+    }
+
+    size_t n = 0;
+    for (size_t k = 0; k < size; ++k)
+    {
+        n = (xs[k] + 1 > n) ? xs[k] + 1 : n;
+    }
+    return n;
+}
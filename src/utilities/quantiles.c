@@ -0,0 +1,476 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <inform/utilities/binning.h>
+#include <inform/utilities/quantiles.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "../parallel.h"
+
+/*
+ * The length below which exact selection is not distributed across threads.
+ */
+#define QUANTILE_PARALLEL_GRAIN (1 << 16)
+
+static int compare_doubles(void const *a, void const *b)
+{
+    double x = *(double const*)a;
+    double y = *(double const*)b;
+    if (x < y) return -1;
+    if (y < x) return  1;
+    return 0;
+}
+
+/*
+ * The rank of the `j`-th boundary of `b` equal-frequency bins of `n` values.
+ */
+static size_t quantile_rank(size_t j, size_t n, int b)
+{
+    return (size_t) (((uint64_t) j * n + (uint64_t) b - 1) / (uint64_t) b);
+}
+
+/*
+ * The capacity of level `h` of a sketch: the highest level holds `k` values
+ * and each level below holds two thirds as many, but never fewer than 2.
+ */
+static size_t level_capacity(inform_sketch const *sketch, size_t h)
+{
+    double cap = (double) sketch->k;
+    for (size_t i = h + 1; i < sketch->height; ++i)
+    {
+        cap *= 2.0 / 3.0;
+    }
+    return (cap < 2.0) ? 2 : (size_t) cap;
+}
+
+static void update_capacity(inform_sketch *sketch)
+{
+    sketch->capacity = 0;
+    for (size_t h = 0; h < sketch->height; ++h)
+    {
+        sketch->capacity += level_capacity(sketch, h);
+    }
+}
+
+static bool reserve(inform_sketch *sketch, size_t h, size_t size)
+{
+    if (size <= sketch->allocated[h])
+    {
+        return true;
+    }
+    size_t allocated = 2 * sketch->allocated[h];
+    allocated = (allocated < size) ? size : allocated;
+    double *level = realloc(sketch->levels[h], allocated * sizeof(double));
+    if (level == NULL)
+    {
+        return false;
+    }
+    sketch->levels[h] = level;
+    sketch->allocated[h] = allocated;
+    return true;
+}
+
+static bool grow(inform_sketch *sketch)
+{
+    size_t const height = sketch->height + 1;
+    double **levels = realloc(sketch->levels, height * sizeof(double*));
+    if (levels == NULL) return false;
+    sketch->levels = levels;
+    size_t *sizes = realloc(sketch->sizes, height * sizeof(size_t));
+    if (sizes == NULL) return false;
+    sketch->sizes = sizes;
+    size_t *allocated = realloc(sketch->allocated, height * sizeof(size_t));
+    if (allocated == NULL) return false;
+    sketch->allocated = allocated;
+
+    levels[height - 1] = NULL;
+    sizes[height - 1] = 0;
+    allocated[height - 1] = 0;
+    sketch->height = height;
+    update_capacity(sketch);
+    return true;
+}
+
+static uint64_t next_random(inform_sketch *sketch)
+{
+    uint64_t x = sketch->state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return sketch->state = x;
+}
+
+/*
+ * Sort level `h` and promote every other value, starting from a randomly
+ * chosen offset, to level `h + 1`. If the level holds an odd number of values,
+ * the last is kept back.
+ */
+static bool compact(inform_sketch *sketch, size_t h)
+{
+    if (h + 1 == sketch->height && !grow(sketch))
+    {
+        return false;
+    }
+    size_t const size = sketch->sizes[h];
+    size_t const even = size - (size % 2);
+    if (!reserve(sketch, h + 1, sketch->sizes[h + 1] + even / 2))
+    {
+        return false;
+    }
+
+    double *level = sketch->levels[h];
+    double *above = sketch->levels[h + 1] + sketch->sizes[h + 1];
+    qsort(level, even, sizeof(double), compare_doubles);
+    size_t const offset = (size_t) (next_random(sketch) & 1);
+    for (size_t i = offset; i < even; i += 2)
+    {
+        *above++ = level[i];
+    }
+    sketch->sizes[h + 1] += even / 2;
+    level[0] = level[size - 1];
+    sketch->sizes[h] = size - even;
+    sketch->size -= even / 2;
+    return true;
+}
+
+inform_sketch *inform_sketch_alloc(size_t k, inform_error *err)
+{
+    if (k < 8)
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+
+    inform_sketch *sketch = calloc(1, sizeof(inform_sketch));
+    if (sketch == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+
+    sketch->k = k;
+    sketch->state = 0x9E3779B97F4A7C15ull;
+    if (!grow(sketch) || !reserve(sketch, 0, k + 1))
+    {
+        inform_sketch_free(sketch);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    return sketch;
+}
+
+void inform_sketch_free(inform_sketch *sketch)
+{
+    if (sketch != NULL)
+    {
+        for (size_t h = 0; sketch->levels != NULL && h < sketch->height; ++h)
+        {
+            free(sketch->levels[h]);
+        }
+        free(sketch->levels);
+        free(sketch->sizes);
+        free(sketch->allocated);
+        free(sketch);
+    }
+}
+
+void inform_sketch_add(inform_sketch *sketch, double const *series, size_t n,
+    inform_error *err)
+{
+    if (sketch == NULL)
+        INFORM_ERROR_RETURN_VOID(err, INFORM_EARG);
+    else if (series == NULL)
+        INFORM_ERROR_RETURN_VOID(err, INFORM_ETIMESERIES);
+
+    size_t i = 0;
+    while (i < n)
+    {
+        // Copy as many values into the lowest level as fit before the sketch
+        // overflows and must be compacted.
+        size_t w = sketch->capacity + 1 - sketch->size;
+        w = (n - i < w) ? n - i : w;
+        if (!reserve(sketch, 0, sketch->sizes[0] + w))
+            INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM);
+        memcpy(sketch->levels[0] + sketch->sizes[0], series + i,
+            w * sizeof(double));
+        sketch->sizes[0] += w;
+        sketch->size += w;
+        sketch->count += w;
+        i += w;
+
+        while (sketch->size > sketch->capacity)
+        {
+            size_t h = 0;
+            while (sketch->sizes[h] <= level_capacity(sketch, h)) ++h;
+            if (!compact(sketch, h))
+                INFORM_ERROR_RETURN_VOID(err, INFORM_ENOMEM);
+        }
+    }
+}
+
+typedef struct weighted
+{
+    double value;
+    uint64_t weight;
+} weighted;
+
+static int compare_weighted(void const *a, void const *b)
+{
+    return compare_doubles(&((weighted const*)a)->value,
+        &((weighted const*)b)->value);
+}
+
+double *inform_sketch_bounds(inform_sketch const *sketch, int b,
+    double *bounds, inform_error *err)
+{
+    if (sketch == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_EARG, NULL);
+    else if (sketch->count == 0)
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, NULL);
+    else if (b < 2)
+        INFORM_ERROR_RETURN(err, INFORM_EBIN, NULL);
+
+    weighted *items = malloc(sketch->size * sizeof(weighted));
+    if (items == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+
+    bool allocate_bounds = (bounds == NULL);
+    if (allocate_bounds)
+    {
+        bounds = malloc((b - 1) * sizeof(double));
+        if (bounds == NULL)
+        {
+            free(items);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    size_t m = 0;
+    uint64_t total = 0;
+    for (size_t h = 0; h < sketch->height; ++h)
+    {
+        for (size_t i = 0; i < sketch->sizes[h]; ++i, ++m)
+        {
+            items[m].value = sketch->levels[h][i];
+            items[m].weight = (uint64_t) 1 << h;
+        }
+        total += (uint64_t) sketch->sizes[h] << h;
+    }
+    qsort(items, m, sizeof(weighted), compare_weighted);
+
+    // The compacted weight may differ slightly from the number of
+    // observations, so the ranks are taken relative to the former.
+    uint64_t below = 0;
+    size_t i = 0;
+    for (int j = 1; j < b; ++j)
+    {
+        uint64_t const rank = quantile_rank((size_t) j, (size_t) total, b);
+        while (i + 1 < m && below + items[i].weight <= rank)
+        {
+            below += items[i++].weight;
+        }
+        bounds[j - 1] = items[i].value;
+    }
+
+    free(items);
+    return bounds;
+}
+
+/*
+ * Partially order `x[lo, hi)` so that `x[k]` holds the value of rank `k`,
+ * everything before it is no greater and everything after is no less.
+ */
+static void select_rank(double *x, size_t lo, size_t hi, size_t k)
+{
+    while (hi - lo > 1)
+    {
+        double const a = x[lo], b = x[lo + (hi - lo) / 2], c = x[hi - 1];
+        double const pivot = (a < b) ? ((b < c) ? b : ((a < c) ? c : a))
+                                     : ((a < c) ? a : ((b < c) ? c : b));
+        ptrdiff_t i = (ptrdiff_t) lo, j = (ptrdiff_t) hi - 1;
+        while (i <= j)
+        {
+            while (x[i] < pivot) ++i;
+            while (pivot < x[j]) --j;
+            if (i <= j)
+            {
+                double const t = x[i];
+                x[i++] = x[j];
+                x[j--] = t;
+            }
+        }
+        if ((ptrdiff_t) k <= j)
+            hi = (size_t) j + 1;
+        else if ((ptrdiff_t) k >= i)
+            lo = (size_t) i;
+        else
+            return;
+    }
+}
+
+typedef struct select_task
+{
+    size_t lo, hi, r0, r1;
+} select_task;
+
+typedef struct select_job
+{
+    double *x;
+    size_t const *ranks;
+    select_task *tasks;
+    size_t ntasks;
+} select_job;
+
+/*
+ * Select the sorted ranks `ranks[r0, r1)` within `x[lo, hi)` by selecting
+ * the middle rank and recursing on either side of it. Once `depth` reaches
+ * zero, the remaining work is recorded as a task rather than carried out.
+ */
+static void multiselect(select_job *job, size_t lo, size_t hi, size_t r0,
+    size_t r1, size_t depth)
+{
+    if (r0 >= r1)
+    {
+        return;
+    }
+    if (depth == 0)
+    {
+        job->tasks[job->ntasks++] = (select_task){ lo, hi, r0, r1 };
+        return;
+    }
+    size_t const mid = r0 + (r1 - r0) / 2, r = job->ranks[mid];
+    select_rank(job->x, lo, hi, r);
+    size_t a = mid, c = mid + 1;
+    while (a > r0 && job->ranks[a - 1] == r) --a;
+    while (c < r1 && job->ranks[c] == r) ++c;
+    multiselect(job, lo, r, r0, a, depth - 1);
+    multiselect(job, r + 1, hi, c, r1, depth - 1);
+}
+
+static void run_select_task(size_t i, void *context)
+{
+    select_job *job = context;
+    select_task const task = job->tasks[i];
+    multiselect(job, task.lo, task.hi, task.r0, task.r1, SIZE_MAX);
+}
+
+double *inform_quantile_bounds(double const *series, size_t n, int b,
+    double *bounds, inform_error *err)
+{
+    if (series == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, NULL);
+    else if (n == 0)
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, NULL);
+    else if (b < 2)
+        INFORM_ERROR_RETURN(err, INFORM_EBIN, NULL);
+
+    double *x = malloc(n * sizeof(double));
+    size_t *ranks = malloc((b - 1) * sizeof(size_t));
+    if (x == NULL || ranks == NULL)
+    {
+        free(x);
+        free(ranks);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+
+    bool allocate_bounds = (bounds == NULL);
+    if (allocate_bounds)
+    {
+        bounds = malloc((b - 1) * sizeof(double));
+        if (bounds == NULL)
+        {
+            free(x);
+            free(ranks);
+            INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+        }
+    }
+
+    memcpy(x, series, n * sizeof(double));
+    size_t m = 0;
+    for (int j = 1; j < b; ++j)
+    {
+        size_t const r = quantile_rank((size_t) j, n, b);
+        ranks[m] = (r < n) ? r : n - 1;
+        ++m;
+    }
+
+    select_job job = { x, ranks, NULL, 0 };
+
+    // The first few levels of the recursion split the series into disjoint
+    // pieces, which are then finished in parallel.
+    size_t depth = 0;
+    size_t const threads = inform_parallel_threads();
+    while (((size_t) 1 << depth) < 2 * threads) ++depth;
+    if (n >= QUANTILE_PARALLEL_GRAIN && threads > 1)
+    {
+        job.tasks = malloc(((size_t) 1 << depth) * sizeof(select_task));
+    }
+    if (job.tasks != NULL)
+    {
+        multiselect(&job, 0, n, 0, m, depth);
+        inform_parallel_for(job.ntasks, run_select_task, &job);
+        free(job.tasks);
+    }
+    else
+    {
+        multiselect(&job, 0, n, 0, m, SIZE_MAX);
+    }
+
+    for (size_t j = 0; j < m; ++j)
+    {
+        bounds[j] = x[ranks[j]];
+    }
+
+    free(ranks);
+    free(x);
+    return bounds;
+}
+
+static int bin_with(double const *series, size_t n, double *bounds, int b,
+    int *binned, inform_error *err)
+{
+    int const bins = inform_bin_bounds(series, n, bounds, (size_t) (b - 1),
+        binned, err);
+    free(bounds);
+    return bins;
+}
+
+int inform_bin_quantiles(double const *series, size_t n, int b, int *binned,
+    inform_error *err)
+{
+    if (binned == NULL && series != NULL && n != 0)
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0);
+
+    double *bounds = inform_quantile_bounds(series, n, b, NULL, err);
+    if (bounds == NULL)
+    {
+        return 0;
+    }
+    return bin_with(series, n, bounds, b, binned, err);
+}
+
+int inform_bin_quantiles_approx(double const *series, size_t n, int b,
+    size_t k, int *binned, inform_error *err)
+{
+    if (series == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0);
+    else if (n == 0)
+        INFORM_ERROR_RETURN(err, INFORM_ESHORTSERIES, 0);
+    else if (b < 2)
+        INFORM_ERROR_RETURN(err, INFORM_EBIN, 0);
+    else if (binned == NULL)
+        INFORM_ERROR_RETURN(err, INFORM_ETIMESERIES, 0);
+
+    inform_sketch *sketch = inform_sketch_alloc(k, err);
+    if (sketch == NULL)
+    {
+        return 0;
+    }
+    inform_error e = INFORM_SUCCESS;
+    inform_sketch_add(sketch, series, n, &e);
+    double *bounds = NULL;
+    if (inform_succeeded(&e))
+    {
+        bounds = inform_sketch_bounds(sketch, b, NULL, &e);
+    }
+    inform_sketch_free(sketch);
+    if (bounds == NULL)
+    {
+        INFORM_ERROR_RETURN(err, e, 0);
+    }
+    return bin_with(series, n, bounds, b, binned, err);
+}
@@ -1,7 +1,11 @@
 // Copyright 2016-2018 ELIFE. All rights reserved.
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
-#include <inform/error.h>
+#include <inform/utilities/tpm.h>
+#include <string.h>
+
+#include "../encoder.h"
+#include "../parallel.h"
 
 inline static bool check_arguments(int const *series, size_t n, size_t m, int b, 
     inform_error *err)
@@ -85,3 +89,378 @@ double *inform_tpm(int const *series, size_t n, size_t m, int b, double *tpm,
 
     return tpm;
 }
+
+inform_sparse_tpm *inform_sparse_tpm_alloc(size_t rows, size_t cols,
+    size_t nnz, inform_error *err)
+{
+    inform_sparse_tpm *tpm = malloc(sizeof(inform_sparse_tpm));
+    if (tpm == NULL)
+    {
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    tpm->rows = rows;
+    tpm->cols = cols;
+    tpm->nnz = nnz;
+    tpm->offsets = calloc(rows + 1, sizeof(size_t));
+    tpm->indices = malloc((nnz ? nnz : 1) * sizeof(size_t));
+    tpm->values = malloc((nnz ? nnz : 1) * sizeof(double));
+    if (tpm->offsets == NULL || tpm->indices == NULL || tpm->values == NULL)
+    {
+        inform_sparse_tpm_free(tpm);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+    return tpm;
+}
+
+void inform_sparse_tpm_free(inform_sparse_tpm *tpm)
+{
+    if (tpm != NULL)
+    {
+        free(tpm->offsets);
+        free(tpm->indices);
+        free(tpm->values);
+        free(tpm);
+    }
+}
+
+/*
+ * The observed futures are bucketed by row, and then each row is sorted and
+ * reduced to its distinct futures. Rows are processed in chunks of
+ * SPARSE_TPM_CHUNK, in parallel once there are SPARSE_TPM_GRAIN observations.
+ */
+#define SPARSE_TPM_CHUNK 4096
+#define SPARSE_TPM_GRAIN (1 << 16)
+
+typedef struct sparse_build
+{
+    size_t rows;
+    bool normalize;
+    size_t const *offsets;
+    size_t *futures;
+    size_t *distinct;
+    inform_sparse_tpm *tpm;
+} sparse_build;
+
+static int compare_futures(void const *a, void const *b)
+{
+    size_t const x = *(size_t const*) a, y = *(size_t const*) b;
+    return (x > y) - (x < y);
+}
+
+static void sort_rows(size_t chunk, void *context)
+{
+    sparse_build const *build = context;
+    size_t const lo = chunk * SPARSE_TPM_CHUNK;
+    size_t const hi = (lo + SPARSE_TPM_CHUNK < build->rows) ?
+        lo + SPARSE_TPM_CHUNK : build->rows;
+    for (size_t i = lo; i < hi; ++i)
+    {
+        size_t *row = build->futures + build->offsets[i];
+        size_t const len = build->offsets[i + 1] - build->offsets[i];
+        qsort(row, len, sizeof(size_t), compare_futures);
+        size_t d = (len != 0);
+        for (size_t j = 1; j < len; ++j)
+        {
+            d += (row[j] != row[j - 1]);
+        }
+        build->distinct[i + 1] = d;
+    }
+}
+
+static void fill_rows(size_t chunk, void *context)
+{
+    sparse_build const *build = context;
+    inform_sparse_tpm *tpm = build->tpm;
+    size_t const lo = chunk * SPARSE_TPM_CHUNK;
+    size_t const hi = (lo + SPARSE_TPM_CHUNK < build->rows) ?
+        lo + SPARSE_TPM_CHUNK : build->rows;
+    for (size_t i = lo; i < hi; ++i)
+    {
+        size_t const *row = build->futures + build->offsets[i];
+        size_t const len = build->offsets[i + 1] - build->offsets[i];
+        size_t out = tpm->offsets[i];
+        double const norm = build->normalize ? (double) len : 1.0;
+        for (size_t j = 0; j < len;)
+        {
+            size_t run = j + 1;
+            while (run < len && row[run] == row[j]) ++run;
+            tpm->indices[out] = row[j];
+            tpm->values[out] = (double) (run - j) / norm;
+            ++out;
+            j = run;
+        }
+    }
+}
+
+static void for_each_chunk(size_t nchunks, bool parallel, inform_task task,
+    void *context)
+{
+    if (parallel)
+    {
+        inform_parallel_for(nchunks, task, context);
+    }
+    else
+    {
+        for (size_t i = 0; i < nchunks; ++i) task(i, context);
+    }
+}
+
+/*
+ * Build the sparse matrix of transitions between histories of length `k`, of
+ * which there are `q = b^k`. The history at time `t` is encoded from the `k`
+ * states preceding it, so the successor of history `h` upon observing state
+ * `x` is `(h*b + x) mod q`.
+ */
+static inform_sparse_tpm *sparse_tpm(int const *series, size_t n, size_t m,
+    int b, size_t k, size_t q, bool normalize, inform_error *err)
+{
+    size_t const rows = q, N = n * (m - k);
+    size_t *offsets = calloc(rows + 1, sizeof(size_t));
+    size_t *futures = malloc(N * sizeof(size_t));
+    size_t *distinct = calloc(rows + 1, sizeof(size_t));
+    if (offsets == NULL || futures == NULL || distinct == NULL)
+    {
+        free(offsets);
+        free(futures);
+        free(distinct);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+
+    // count the observations of each row, and bucket their futures
+    for (size_t i = 0; i < n; ++i)
+    {
+        int const *x = series + m * i;
+        size_t h = 0;
+        for (size_t t = 0; t < k; ++t) h = h * b + x[t];
+        for (size_t t = k; t < m; ++t)
+        {
+            offsets[h + 1]++;
+            h = (h * b + x[t]) % q;
+        }
+    }
+    for (size_t i = 0; i < rows; ++i)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        int const *x = series + m * i;
+        size_t h = 0;
+        for (size_t t = 0; t < k; ++t) h = h * b + x[t];
+        for (size_t t = k; t < m; ++t)
+        {
+            size_t const next = (h * b + x[t]) % q;
+            futures[offsets[h]++] = next;
+            h = next;
+        }
+    }
+    memmove(offsets + 1, offsets, rows * sizeof(size_t));
+    offsets[0] = 0;
+
+    sparse_build build = { rows, normalize, offsets, futures, distinct, NULL };
+    size_t const nchunks = (rows + SPARSE_TPM_CHUNK - 1) / SPARSE_TPM_CHUNK;
+    bool const parallel = (N >= SPARSE_TPM_GRAIN || rows >= SPARSE_TPM_GRAIN);
+    for_each_chunk(nchunks, parallel, sort_rows, &build);
+
+    bool empty = false;
+    for (size_t i = 0; i < rows; ++i)
+    {
+        empty |= (distinct[i + 1] == 0);
+        distinct[i + 1] += distinct[i];
+    }
+
+    inform_sparse_tpm *tpm = inform_sparse_tpm_alloc(rows, rows,
+        distinct[rows], err);
+    if (tpm != NULL)
+    {
+        memcpy(tpm->offsets, distinct, (rows + 1) * sizeof(size_t));
+        build.tpm = tpm;
+        for_each_chunk(nchunks, parallel, fill_rows, &build);
+        if (empty)
+        {
+            INFORM_ERROR(err, INFORM_ETPMROW);
+        }
+    }
+
+    free(offsets);
+    free(futures);
+    free(distinct);
+
+    return tpm;
+}
+
+inform_sparse_tpm *inform_tpm_sparse(int const *series, size_t n, size_t m,
+    int b, inform_error *err)
+{
+    if (check_arguments(series, n, m, b, err))
+        return NULL;
+
+    return sparse_tpm(series, n, m, b, 1, b, true, err);
+}
+
+inform_sparse_tpm *inform_tpm_k(int const *series, size_t n, size_t m, int b,
+    size_t k, bool normalize, inform_error *err)
+{
+    if (check_arguments(series, n, m, b, err))
+        return NULL;
+    else if (k == 0)
+        INFORM_ERROR_RETURN(err, INFORM_EKZERO, NULL);
+    else if (m <= k)
+        INFORM_ERROR_RETURN(err, INFORM_EKLONG, NULL);
+
+    uint64_t q = 1;
+    if (!inform_encoder_extend(&q, b, k, INT_MAX))
+        INFORM_ERROR_RETURN(err, INFORM_EENCODE, NULL);
+
+    return sparse_tpm(series, n, m, b, k, q, normalize, err);
+}
+
+/*
+ * Each coarse row is accumulated into a dense scratch row of length
+ * `ngroups`, remembering the columns it touches so that only those need be
+ * sorted, emitted and cleared. The rows are accumulated twice: once to count
+ * the entries of the coarse matrix, and again to fill it.
+ */
+typedef struct coarse_build
+{
+    inform_sparse_tpm const *tpm;
+    size_t const *groups;
+    size_t const *members;
+    size_t const *starts;
+    double *acc;
+    size_t *touched;
+} coarse_build;
+
+static size_t coarse_row(coarse_build const *build, size_t g, size_t *used)
+{
+    inform_sparse_tpm const *tpm = build->tpm;
+    size_t ntouched = 0;
+    *used = 0;
+    for (size_t k = build->starts[g]; k < build->starts[g + 1]; ++k)
+    {
+        size_t const i = build->members[k];
+        if (tpm->offsets[i] == tpm->offsets[i + 1])
+        {
+            continue;
+        }
+        ++(*used);
+        for (size_t j = tpm->offsets[i]; j < tpm->offsets[i + 1]; ++j)
+        {
+            if (tpm->values[j] == 0.0)
+            {
+                continue;
+            }
+            size_t const c = build->groups[tpm->indices[j]];
+            if (build->acc[c] == 0.0)
+            {
+                build->touched[ntouched++] = c;
+            }
+            build->acc[c] += tpm->values[j];
+        }
+    }
+    qsort(build->touched, ntouched, sizeof(size_t), compare_futures);
+    return ntouched;
+}
+
+inform_sparse_tpm *inform_tpm_coarse_grain(inform_sparse_tpm const *tpm,
+    size_t const *groups, size_t ngroups, inform_error *err)
+{
+    if (tpm == NULL || tpm->offsets == NULL || tpm->indices == NULL ||
+        tpm->values == NULL || tpm->rows != tpm->cols)
+        INFORM_ERROR_RETURN(err, INFORM_ETPM, NULL);
+    else if (tpm->rows == 0)
+        INFORM_ERROR_RETURN(err, INFORM_ESIZE, NULL);
+    else if (groups == NULL || ngroups == 0)
+        INFORM_ERROR_RETURN(err, INFORM_EPARTS, NULL);
+    for (size_t i = 0; i < tpm->rows; ++i)
+    {
+        if (groups[i] >= ngroups)
+            INFORM_ERROR_RETURN(err, INFORM_EPARTS, NULL);
+    }
+    for (size_t j = 0; j < tpm->nnz; ++j)
+    {
+        if (tpm->indices[j] >= tpm->cols)
+            INFORM_ERROR_RETURN(err, INFORM_ETPM, NULL);
+    }
+
+    size_t const n = tpm->rows;
+    size_t *starts = calloc(ngroups + 1, sizeof(size_t));
+    size_t *members = malloc(n * sizeof(size_t));
+    size_t *touched = malloc(ngroups * sizeof(size_t));
+    double *acc = calloc(ngroups, sizeof(double));
+    size_t *offsets = calloc(ngroups + 1, sizeof(size_t));
+    if (starts == NULL || members == NULL || touched == NULL || acc == NULL ||
+        offsets == NULL)
+    {
+        free(starts);
+        free(members);
+        free(touched);
+        free(acc);
+        free(offsets);
+        INFORM_ERROR_RETURN(err, INFORM_ENOMEM, NULL);
+    }
+
+    // bucket the states by group
+    for (size_t i = 0; i < n; ++i)
+    {
+        starts[groups[i] + 1]++;
+    }
+    for (size_t g = 0; g < ngroups; ++g)
+    {
+        starts[g + 1] += starts[g];
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        members[starts[groups[i]]++] = i;
+    }
+    memmove(starts + 1, starts, ngroups * sizeof(size_t));
+    starts[0] = 0;
+
+    coarse_build build = { tpm, groups, members, starts, acc, touched };
+
+    // count the entries of each coarse row
+    bool empty = false;
+    for (size_t g = 0; g < ngroups; ++g)
+    {
+        size_t used;
+        size_t const ntouched = coarse_row(&build, g, &used);
+        for (size_t k = 0; k < ntouched; ++k)
+        {
+            acc[touched[k]] = 0.0;
+        }
+        empty |= (ntouched == 0);
+        offsets[g + 1] = offsets[g] + ntouched;
+    }
+
+    inform_sparse_tpm *coarse = inform_sparse_tpm_alloc(ngroups, ngroups,
+        offsets[ngroups], err);
+    if (coarse != NULL)
+    {
+        memcpy(coarse->offsets, offsets, (ngroups + 1) * sizeof(size_t));
+        // each coarse row is the average of its members' non-empty rows
+        for (size_t g = 0; g < ngroups; ++g)
+        {
+            size_t used;
+            size_t const ntouched = coarse_row(&build, g, &used);
+            size_t out = offsets[g];
+            for (size_t k = 0; k < ntouched; ++k, ++out)
+            {
+                coarse->indices[out] = touched[k];
+                coarse->values[out] = acc[touched[k]] / used;
+                acc[touched[k]] = 0.0;
+            }
+        }
+        if (empty)
+        {
+            INFORM_ERROR(err, INFORM_ETPMROW);
+        }
+    }
+
+    free(starts);
+    free(members);
+    free(touched);
+    free(acc);
+    free(offsets);
+
+    return coarse;
+}
@@ -0,0 +1,15 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <inform/utilities/view.h>
+
+inform_view inform_view_contiguous(int const *series, size_t n, size_t m)
+{
+    return (inform_view){ series, 1, (ptrdiff_t) m, (ptrdiff_t) (n * m) };
+}
+
+inform_view inform_view_strided(int const *data, ptrdiff_t time_stride,
+    ptrdiff_t init_stride, ptrdiff_t var_stride)
+{
+    return (inform_view){ data, time_stride, init_stride, var_stride };
+}
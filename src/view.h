@@ -0,0 +1,29 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#pragma once
+
+#include <inform/utilities/view.h>
+#include <stdbool.h>
+
+/*
+ * The first sample of variable `v` and initial condition `i` of a view.
+ */
+static inline int const *inform_view_row(inform_view const *view, size_t v,
+    size_t i)
+{
+    return view->data + (ptrdiff_t) v * view->var_stride
+        + (ptrdiff_t) i * view->init_stride;
+}
+
+/*
+ * Whether the `n` initial conditions of `m` time steps of each variable of a
+ * view are laid out one after another, so that they may be traversed as a
+ * single contiguous row of `n * m` samples.
+ */
+static inline bool inform_view_is_packed(inform_view const *view, size_t n,
+    size_t m)
+{
+    return view->time_stride == 1
+        && (n == 1 || view->init_stride == (ptrdiff_t) m);
+}
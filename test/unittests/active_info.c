@@ -3,6 +3,7 @@
 // license that can be found in the LICENSE file.
 #include "util.h"
 #include <inform/active_info.h>
+#include <inform/utilities/random.h>
 #include <math.h>
 #include <ginger/unit.h>
 
@@ -385,6 +386,99 @@ UNIT(LocalActiveInfoEnsemble_Base4)
     }
 }
 
+UNIT(ActiveInfoEstimators)
+{
+    inform_error err = INFORM_SUCCESS;
+    int const series[9] = {0,0,1,1,1,1,0,0,0};
+    double const plugin = inform_active_info(series, 1, 9, 2, 2, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (int est = INFORM_PLUGIN; est <= INFORM_NSB; ++est)
+    {
+        double const ai = inform_active_info_est(series, 1, 9, 2, 2,
+            (inform_estimator) est, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_FALSE(isnan(ai));
+        if (est == INFORM_PLUGIN)
+        {
+            ASSERT_DBL_NEAR_TOL(plugin, ai, 1e-12);
+        }
+    }
+
+    ASSERT_NAN(inform_active_info_est(series, 1, 9, 2, 2, (inform_estimator) 5, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+}
+
+UNIT(ActiveInfoConfig)
+{
+    inform_error err = INFORM_SUCCESS;
+    int *series = inform_random_series(2000, 3);
+    ASSERT_NOT_NULL(series);
+
+    inform_config sparse = inform_config_default();
+    sparse.histogram = INFORM_HISTOGRAM_SPARSE;
+    for (int est = INFORM_PLUGIN; est <= INFORM_GRASSBERGER; ++est)
+    {
+        double const expect = inform_active_info_est(series, 4, 500, 3, 3,
+            (inform_estimator) est, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_DBL_NEAR_TOL(expect, inform_active_info_ex(series, 4, 500, 3,
+            3, (inform_estimator) est, NULL, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_DBL_NEAR_TOL(expect, inform_active_info_ex(series, 4, 500, 3,
+            3, (inform_estimator) est, &sparse, &err), 1e-10);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+    // the NSB estimator needs the size of the state space
+    ASSERT_NAN(inform_active_info_ex(series, 4, 500, 3, 3, INFORM_NSB,
+        &sparse, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    // the dense histograms need 105KB, the sparse ones 48KB
+    err = INFORM_SUCCESS;
+    double const expect = inform_active_info(series, 1, 2000, 3, 8, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    inform_config budget = inform_config_default();
+    budget.memory = 60000;
+    ASSERT_DBL_NEAR_TOL(expect, inform_active_info_ex(series, 1, 2000, 3, 8,
+        INFORM_PLUGIN, &budget, &err), 1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    budget.histogram = INFORM_HISTOGRAM_DENSE;
+    ASSERT_NAN(inform_active_info_ex(series, 1, 2000, 3, 8, INFORM_PLUGIN,
+        &budget, &err));
+    ASSERT_EQUAL(INFORM_EBUDGET, err);
+    budget.histogram = INFORM_HISTOGRAM_AUTO;
+    budget.memory = 1000;
+    ASSERT_NAN(inform_active_info_ex(series, 1, 2000, 3, 8, INFORM_PLUGIN,
+        &budget, &err));
+    ASSERT_EQUAL(INFORM_EBUDGET, err);
+    budget.histogram = (inform_histogram) 3;
+    ASSERT_NAN(inform_active_info_ex(series, 1, 2000, 3, 8, INFORM_PLUGIN,
+        &budget, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+    budget = inform_config_default();
+    budget.validation = (inform_validation) 2;
+    ASSERT_NAN(inform_active_info_ex(series, 1, 2000, 3, 8, INFORM_PLUGIN,
+        &budget, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    inform_config trusting = inform_config_default();
+    trusting.validation = INFORM_VALIDATE_ARGS;
+    ASSERT_DBL_NEAR_TOL(expect, inform_active_info_ex(series, 1, 2000, 3, 8,
+        INFORM_PLUGIN, &trusting, &err), 1e-12);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    free(series);
+
+    // too many histories to index densely, but each determines its future
+    int alternating[100];
+    for (size_t i = 0; i < 100; ++i) alternating[i] = i % 2;
+    err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(1.0, inform_active_info(alternating, 1, 100, 2, 40,
+        &err), 1e-12);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+}
+
 BEGIN_SUITE(ActiveInformation)
     ADD_UNIT(ActiveInfoSeriesNULLSeries)
     ADD_UNIT(ActiveInfoSeriesNoInits)
@@ -412,4 +506,6 @@ BEGIN_SUITE(ActiveInformation)
     ADD_UNIT(LocalActiveInfoSingleSeries_Base4)
     ADD_UNIT(LocalActiveInfoEnsemble)
     ADD_UNIT(LocalActiveInfoEnsemble_Base4)
+    ADD_UNIT(ActiveInfoEstimators)
+    ADD_UNIT(ActiveInfoConfig)
 END_SUITE
@@ -385,6 +385,25 @@ UNIT(LocalBlockEntropyEnsemble_Base4)
     }
 }
 
+UNIT(BlockEntropyEstimators)
+{
+    inform_error err = INFORM_SUCCESS;
+    int const series[12] = {0,0,1,1,1,1,0,0,0,1,0,2};
+    double const plugin = inform_block_entropy(series, 1, 12, 3, 2, &err);
+    ASSERT_DBL_NEAR_TOL(plugin,
+        inform_block_entropy_est(series, 1, 12, 3, 2, INFORM_PLUGIN, &err), 1e-12);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    // 5 distinct blocks among 11 observations
+    ASSERT_DBL_NEAR_TOL(plugin + 4.0 / (22.0 * log(2.0)),
+        inform_block_entropy_est(series, 1, 12, 3, 2, INFORM_MILLER_MADOW, &err), 1e-12);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_TRUE(plugin < inform_block_entropy_est(series, 1, 12, 3, 2, INFORM_NSB, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    ASSERT_NAN(inform_block_entropy_est(series, 1, 12, 3, 2, (inform_estimator) 9, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+}
+
 BEGIN_SUITE(BlockEntropy)
     ADD_UNIT(BlockEntropyNULLSeries)
     ADD_UNIT(BlockEntropyNoInits)
@@ -411,4 +430,5 @@ BEGIN_SUITE(BlockEntropy)
     ADD_UNIT(LocalBlockEntropySingleSeries_Base4)
     ADD_UNIT(LocalBlockEntropyEnsemble)
     ADD_UNIT(LocalBlockEntropyEnsemble_Base4)
+    ADD_UNIT(BlockEntropyEstimators)
 END_SUITE
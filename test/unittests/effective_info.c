@@ -3,6 +3,8 @@
 // license that can be found in the LICENSE file.
 #include "util.h"
 #include <inform/effective_info.h>
+#include <inform/utilities/partitions.h>
+#include <inform/utilities/tpm.h>
 #include <math.h>
 #include <ginger/unit.h>
 
@@ -220,6 +222,427 @@ UNIT(EffectiveInfoExamplesFromHoel)
     }
 }
 
+/*
+ * Store a dense TPM in compressed sparse row form.
+ */
+static inform_sparse_tpm *sparsify(double const *tpm, size_t n)
+{
+    size_t nnz = 0;
+    for (size_t i = 0; i < n * n; ++i) nnz += (tpm[i] != 0);
+    inform_sparse_tpm *sparse = inform_sparse_tpm_alloc(n, n, nnz, NULL);
+    for (size_t i = 0, k = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            if (tpm[i * n + j] != 0)
+            {
+                sparse->indices[k] = j;
+                sparse->values[k++] = tpm[i * n + j];
+            }
+        }
+        sparse->offsets[i + 1] = k;
+    }
+    return sparse;
+}
+
+UNIT(EffectiveInfoSparseInvalid)
+{
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_effective_info_sparse(NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETPM, err);
+
+    double const tpm[4] = {0.5, 0.5, 0.0, 1.0};
+    inform_sparse_tpm *sparse = sparsify(tpm, 2);
+
+    err = INFORM_SUCCESS;
+    sparse->values[0] = 0.75;
+    ASSERT_NAN(inform_effective_info_sparse(sparse, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETPM, err);
+    sparse->values[0] = 0.5;
+
+    err = INFORM_SUCCESS;
+    sparse->indices[1] = 0;
+    ASSERT_NAN(inform_effective_info_sparse(sparse, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETPM, err);
+    sparse->indices[1] = 2;
+    ASSERT_NAN(inform_effective_info_sparse(sparse, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETPM, err);
+    sparse->indices[1] = 1;
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_effective_info_sparse(sparse, (double[2]){0.5, 0.6}, &err));
+    ASSERT_EQUAL(INFORM_EDIST, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(inform_effective_info(tpm, NULL, 2, &err),
+        inform_effective_info_sparse(sparse, NULL, &err), 1e-12);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    sparse->cols = 3;
+    ASSERT_NAN(inform_effective_info_sparse(sparse, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETPM, err);
+
+    inform_sparse_tpm_free(sparse);
+}
+
+UNIT(EffectiveInfoSparse)
+{
+    inform_error err = INFORM_SUCCESS;
+    {
+        double const tpm[9] = {1.0/3, 1.0/3, 1.0/3,
+                               0.250, 0.750, 0.000,
+                               0.125, 0.500, 0.375};
+        double const inter[3] = {0.5, 0.3, 0.2};
+        inform_sparse_tpm *sparse = sparsify(tpm, 3);
+        ASSERT_DBL_NEAR_TOL(0.202701, inform_effective_info_sparse(sparse, NULL, &err), 1e-6);
+        ASSERT_DBL_NEAR_TOL(inform_effective_info(tpm, inter, 3, &err),
+            inform_effective_info_sparse(sparse, inter, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        inform_sparse_tpm_free(sparse);
+    }
+    {
+        // a large, sparse random walk, estimated from a long time series
+        size_t const n = 1, m = 400000;
+        int const b = 1024;
+        int *series = malloc(n * m * sizeof(int));
+        ASSERT_NOT_NULL(series);
+        uint64_t state = 3;
+        series[0] = 0;
+        for (size_t i = 1; i < m; ++i)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            series[i] = (series[i - 1] + 1 + (int)((state >> 33) % 96)) % b;
+        }
+        inform_sparse_tpm *sparse = inform_tpm_sparse(series, n, m, b, &err);
+        double *dense = inform_tpm(series, n, m, b, NULL, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_TRUE(sparse->nnz >= (1 << 16));
+        ASSERT_DBL_NEAR_TOL(inform_effective_info(dense, NULL, b, &err),
+            inform_effective_info_sparse(sparse, NULL, &err), 1e-9);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        free(dense);
+        inform_sparse_tpm_free(sparse);
+        free(series);
+    }
+}
+
+UNIT(EffectiveInfoSparseHistories)
+{
+    inform_error err = INFORM_SUCCESS;
+    {
+        int const series[8] = {0,0,1,1,0,1,0,0};
+        inform_sparse_tpm *sparse = inform_tpm_k(series, 1, 8, 2, 2, true, &err);
+        double const dense[16] = {
+            0.0, 1.0, 0.0, 0.0,
+            0.0, 0.0, 0.5, 0.5,
+            0.5, 0.5, 0.0, 0.0,
+            0.0, 0.0, 1.0, 0.0,
+        };
+        ASSERT_DBL_NEAR_TOL(inform_effective_info(dense, NULL, 4, &err),
+            inform_effective_info_sparse(sparse, NULL, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        inform_sparse_tpm_free(sparse);
+    }
+    {
+        // the histories 01, 10 and 11 are never observed
+        inform_sparse_tpm *sparse = inform_tpm_k((int[5]){0,0,0,0,1}, 1, 5, 2, 2, true, &err);
+        ASSERT_EQUAL(INFORM_ETPMROW, err);
+
+        err = INFORM_SUCCESS;
+        ASSERT_DBL_NEAR_TOL(0.0, inform_effective_info_sparse(sparse, NULL, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+        ASSERT_DBL_NEAR_TOL(0.0, inform_effective_info_sparse(sparse,
+            (double[4]){1.0, 0.0, 0.0, 0.0}, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+        ASSERT_NAN(inform_effective_info_sparse(sparse,
+            (double[4]){0.5, 0.5, 0.0, 0.0}, &err));
+        ASSERT_EQUAL(INFORM_ETPM, err);
+        inform_sparse_tpm_free(sparse);
+    }
+}
+
+UNIT(EffectiveInfoBatchInvalid)
+{
+    inform_error err = INFORM_SUCCESS;
+    double const tpm[4] = {0.2, 0.8, 0.75, 0.25};
+    double const inters[4] = {0.5, 0.5, 0.3, 0.7};
+    ASSERT_NULL(inform_effective_info_batch(NULL, inters, 2, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETPM, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_effective_info_batch((double[4]){0.2, 0.7, 0.75, 0.25},
+        inters, 2, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETPM, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_effective_info_batch(tpm, NULL, 2, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EDIST, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_effective_info_batch(tpm, inters, 2, 0, NULL, &err));
+    ASSERT_EQUAL(INFORM_ESIZE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_effective_info_batch(tpm, (double[4]){0.5, 0.5, 0.3, 0.6},
+        2, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EDIST, err);
+}
+
+UNIT(EffectiveInfoBatch)
+{
+    inform_error err = INFORM_SUCCESS;
+    // enough states and interventions to span several tiles of each kind
+    size_t const n = 300, k = 40;
+    double *tpm = malloc(n * n * sizeof(double));
+    double *inters = malloc(k * n * sizeof(double));
+    ASSERT_NOT_NULL(tpm);
+    ASSERT_NOT_NULL(inters);
+
+    uint64_t state = 11;
+    for (size_t i = 0; i < n; ++i)
+    {
+        double sum = 0.0;
+        for (size_t j = 0; j < n; ++j)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            // leave most transitions impossible
+            double const x = ((state >> 60) == 0) ? (double) (state >> 11) : 0.0;
+            tpm[i * n + j] = x;
+            sum += x;
+        }
+        if (sum == 0.0)
+        {
+            tpm[i * n + i] = sum = 1.0;
+        }
+        for (size_t j = 0; j < n; ++j) tpm[i * n + j] /= sum;
+    }
+    for (size_t i = 0; i < k; ++i)
+    {
+        double sum = 0.0;
+        for (size_t j = 0; j < n; ++j)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            double const x = (i % 3 == 0 && j % 2) ? 0.0 : (double) (state >> 11);
+            inters[i * n + j] = x;
+            sum += x;
+        }
+        for (size_t j = 0; j < n; ++j) inters[i * n + j] /= sum;
+    }
+
+    double *ei = inform_effective_info_batch(tpm, inters, n, k, NULL, &err);
+    ASSERT_NOT_NULL(ei);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < k; ++i)
+    {
+        ASSERT_DBL_NEAR_TOL(inform_effective_info(tpm, inters + i * n, n, &err),
+            ei[i], 1e-9);
+    }
+
+    free(ei);
+    free(inters);
+    free(tpm);
+}
+
+UNIT(CausalEmergenceInvalid)
+{
+    inform_error err = INFORM_SUCCESS;
+    int const b[2] = {2, 2};
+    ASSERT_NAN(inform_causal_emergence(NULL, 2, b, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETPM, err);
+
+    double const tpm[16] = {
+        0.5, 0.5, 0.0, 0.0,
+        0.0, 0.0, 1.0, 0.0,
+        0.0, 0.0, 0.0, 1.0,
+        1.0, 0.0, 0.0, 0.0,
+    };
+    inform_sparse_tpm *sparse = sparsify(tpm, 4);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_causal_emergence(sparse, 0, b, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_ESIZE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_causal_emergence(sparse, 2, NULL, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_causal_emergence(sparse, 2, (int[2]){2, 1}, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_causal_emergence(sparse, 2, (int[2]){2, 3}, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETPM, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_causal_emergence(sparse, 1, b, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETPM, err);
+
+    inform_sparse_tpm_free(sparse);
+}
+
+static size_t popcount(size_t x)
+{
+    size_t count = 0;
+    for (; x != 0; x >>= 1) count += x & 1;
+    return count;
+}
+
+/*
+ * Write the groups of the sum coarse-graining of a partition of `l` binary
+ * variables, returning the number of groups.
+ */
+static size_t binary_groups(size_t const *parts, size_t l, size_t *groups)
+{
+    size_t nparts = 0;
+    for (size_t v = 0; v < l; ++v)
+    {
+        nparts = (parts[v] + 1 > nparts) ? parts[v] + 1 : nparts;
+    }
+    size_t ngroups = 1;
+    for (size_t j = 0; j < nparts; ++j)
+    {
+        size_t size = 0;
+        for (size_t v = 0; v < l; ++v) size += (parts[v] == j);
+        ngroups *= size + 1;
+    }
+    for (size_t i = 0; i < ((size_t) 1 << l); ++i)
+    {
+        size_t macro = 0;
+        for (size_t j = 0; j < nparts; ++j)
+        {
+            size_t size = 0, sum = 0;
+            for (size_t v = 0; v < l; ++v)
+            {
+                if (parts[v] == j)
+                {
+                    size += 1;
+                    sum += (i >> (l - 1 - v)) & 1;
+                }
+            }
+            macro = macro * (size + 1) + sum;
+        }
+        groups[i] = macro;
+    }
+    return ngroups;
+}
+
+UNIT(CausalEmergence)
+{
+    inform_error err = INFORM_SUCCESS;
+    {
+        // the states 00, 01 and 10 transition uniformly among themselves
+        double const tpm[16] = {
+            1./3, 1./3, 1./3, 0.0,
+            1./3, 1./3, 1./3, 0.0,
+            1./3, 1./3, 1./3, 0.0,
+            0.0,  0.0,  0.0,  1.0,
+        };
+        inform_sparse_tpm *sparse = sparsify(tpm, 4);
+        size_t parts[2], groups[4];
+        double const ce = inform_causal_emergence(sparse, 2, (int[2]){2, 2},
+            parts, groups, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_DBL_NEAR_TOL(0.918296 - 0.811278, ce, 1e-6);
+        ASSERT_EQUAL(0, parts[0]);
+        ASSERT_EQUAL(0, parts[1]);
+        size_t const expected[4] = {0, 1, 1, 2};
+        for (size_t i = 0; i < 4; ++i) ASSERT_EQUAL(expected[i], groups[i]);
+
+        inform_sparse_tpm *coarse = inform_tpm_coarse_grain(sparse, groups, 3,
+            &err);
+        ASSERT_DBL_NEAR_TOL(inform_effective_info_sparse(sparse, NULL, &err) + ce,
+            inform_effective_info_sparse(coarse, NULL, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        inform_sparse_tpm_free(coarse);
+        inform_sparse_tpm_free(sparse);
+    }
+    {
+        // a permutation of the states is as effective as can be
+        double const tpm[16] = {
+            0.0, 1.0, 0.0, 0.0,
+            0.0, 0.0, 0.0, 1.0,
+            1.0, 0.0, 0.0, 0.0,
+            0.0, 0.0, 1.0, 0.0,
+        };
+        inform_sparse_tpm *sparse = sparsify(tpm, 4);
+        size_t parts[2];
+        ASSERT_DBL_NEAR_TOL(0.0, inform_causal_emergence(sparse, 2,
+            (int[2]){2, 2}, parts, NULL, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_EQUAL(0, parts[0]);
+        ASSERT_EQUAL(1, parts[1]);
+        inform_sparse_tpm_free(sparse);
+    }
+    {
+        // enough variables that the candidates span several tasks, compared
+        // against coarse-graining the matrix for every partition
+        size_t const l = 6, n = 64;
+        double *tpm = calloc(n * n, sizeof(double));
+        ASSERT_NOT_NULL(tpm);
+        uint64_t state = 5;
+        for (size_t i = 0; i < n; ++i)
+        {
+            // leave one state without any observed successor
+            if (i == 17) continue;
+            // the number of active variables in each half of the system is
+            // determined by that of the other, but which variables are active
+            // is random
+            size_t const a = popcount(i >> 3), c = popcount(i & 7);
+            size_t const next[2] = {c, (a + 1) % 4};
+            double sum = 0.0;
+            for (size_t j = 0; j < n; ++j)
+            {
+                if (popcount(j >> 3) == next[0] && popcount(j & 7) == next[1])
+                {
+                    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                    double const x = (double) ((state >> 20) % 1000 + 1);
+                    tpm[i * n + j] = x;
+                    sum += x;
+                }
+            }
+            for (size_t j = 0; j < n; ++j) tpm[i * n + j] /= sum;
+        }
+        inform_sparse_tpm *sparse = sparsify(tpm, n);
+
+        double const micro = inform_effective_info_sparse(sparse, NULL, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        double best = micro;
+        size_t groups[64], expected[64];
+        size_t *parts = inform_first_partitioning(l);
+        size_t size = 1;
+        while (size != 0)
+        {
+            size_t const ngroups = binary_groups(parts, l, groups);
+            inform_sparse_tpm *coarse = inform_tpm_coarse_grain(sparse, groups,
+                ngroups, &err);
+            double const ei = inform_effective_info_sparse(coarse, NULL, &err);
+            if (ei > best + 1e-9)
+            {
+                best = ei;
+                for (size_t i = 0; i < n; ++i) expected[i] = groups[i];
+            }
+            inform_sparse_tpm_free(coarse);
+            size = inform_next_partitioning(parts, l);
+        }
+        free(parts);
+        ASSERT_TRUE(best > micro);
+
+        err = INFORM_SUCCESS;
+        int const b[6] = {2, 2, 2, 2, 2, 2};
+        double const ce = inform_causal_emergence(sparse, l, b, NULL, groups,
+            &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_DBL_NEAR_TOL(best - micro, ce, 1e-9);
+        for (size_t i = 0; i < n; ++i) ASSERT_EQUAL(expected[i], groups[i]);
+
+        inform_sparse_tpm_free(sparse);
+        free(tpm);
+    }
+}
+
 BEGIN_SUITE(EffectiveInformation)
     ADD_UNIT(EffectiveInfoNullTPM)
     ADD_UNIT(EffectiveInfoZeroSize)
@@ -233,4 +656,11 @@ BEGIN_SUITE(EffectiveInformation)
     ADD_UNIT(EffectiveInfoNonUniformIntervention)
     ADD_UNIT(EffectiveInfoUniformIntervention)
     ADD_UNIT(EffectiveInfoExamplesFromHoel)
+    ADD_UNIT(EffectiveInfoSparseInvalid)
+    ADD_UNIT(EffectiveInfoSparse)
+    ADD_UNIT(EffectiveInfoSparseHistories)
+    ADD_UNIT(EffectiveInfoBatchInvalid)
+    ADD_UNIT(EffectiveInfoBatch)
+    ADD_UNIT(CausalEmergenceInvalid)
+    ADD_UNIT(CausalEmergence)
 END_SUITE
@@ -3,6 +3,7 @@
 // license that can be found in the LICENSE file.
 #include "util.h"
 #include <inform/entropy_rate.h>
+#include <inform/utilities/random.h>
 #include <math.h>
 #include <ginger/unit.h>
 
@@ -388,6 +389,55 @@ UNIT(LocalEntropyRateEnsemble_Base4)
     }
 }
 
+UNIT(EntropyRateConfig)
+{
+    inform_error err = INFORM_SUCCESS;
+    int *series = inform_random_series(2000, 3);
+    ASSERT_NOT_NULL(series);
+
+    inform_config sparse = inform_config_default();
+    sparse.histogram = INFORM_HISTOGRAM_SPARSE;
+    for (int est = INFORM_PLUGIN; est <= INFORM_GRASSBERGER; ++est)
+    {
+        double const expect = inform_entropy_rate_est(series, 4, 500, 3, 3,
+            (inform_estimator) est, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_DBL_NEAR_TOL(expect, inform_entropy_rate_ex(series, 4, 500, 3,
+            3, (inform_estimator) est, NULL, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_DBL_NEAR_TOL(expect, inform_entropy_rate_ex(series, 4, 500, 3,
+            3, (inform_estimator) est, &sparse, &err), 1e-10);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+    ASSERT_NAN(inform_entropy_rate_ex(series, 4, 500, 3, 3, INFORM_NSB,
+        &sparse, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    // the dense histograms need 105KB, the sparse ones 48KB
+    err = INFORM_SUCCESS;
+    double const expect = inform_entropy_rate(series, 1, 2000, 3, 8, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    inform_config budget = inform_config_default();
+    budget.memory = 60000;
+    ASSERT_DBL_NEAR_TOL(expect, inform_entropy_rate_ex(series, 1, 2000, 3, 8,
+        INFORM_PLUGIN, &budget, &err), 1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    budget.histogram = INFORM_HISTOGRAM_DENSE;
+    ASSERT_NAN(inform_entropy_rate_ex(series, 1, 2000, 3, 8, INFORM_PLUGIN,
+        &budget, &err));
+    ASSERT_EQUAL(INFORM_EBUDGET, err);
+
+    free(series);
+
+    // too many histories to index densely, but each determines its future
+    int alternating[100];
+    for (size_t i = 0; i < 100; ++i) alternating[i] = i % 2;
+    err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(0.0, inform_entropy_rate(alternating, 1, 100, 2, 40,
+        &err), 1e-12);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+}
+
 BEGIN_SUITE(EntropyRate)
     ADD_UNIT(EntropyRateNULLSeries)
     ADD_UNIT(EntropyRateNoInits)
@@ -414,4 +464,5 @@ BEGIN_SUITE(EntropyRate)
     ADD_UNIT(LocalEntropyRateSingleSeries_Base4)
     ADD_UNIT(LocalEntropyRateEnsemble)
     ADD_UNIT(LocalEntropyRateEnsemble_Base4)
+    ADD_UNIT(EntropyRateConfig)
 END_SUITE
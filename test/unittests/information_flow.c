@@ -3,6 +3,7 @@
 // license that can be found in the LICENSE file.
 #include "util.h"
 #include <inform/information_flow.h>
+#include <inform/shannon.h>
 #include <math.h>
 #include <ginger/unit.h>
 
@@ -302,6 +303,173 @@ UNIT(InformationFlow)
     }
 }
 
+UNIT(InformationFlowManyStates)
+{
+    // enough occupied joint states that the summation is divided among threads
+    size_t const l = 6, m = 200000, q = 64;
+    int *series = malloc(3 * l * m * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    uint64_t state = 7;
+    for (size_t i = 0; i < 3 * l * m; ++i)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        series[i] = (int) (state >> 63);
+    }
+    // couple the destination to the source and the background
+    for (size_t t = 0; t < m; ++t)
+    {
+        if (t % 4 == 0) series[l * m + t] = series[t] ^ series[2 * l * m + t];
+    }
+
+    inform_dist *joint = inform_dist_alloc(q * q * q);
+    inform_dist *as = inform_dist_alloc(q * q);
+    inform_dist *bs = inform_dist_alloc(q * q);
+    inform_dist *s = inform_dist_alloc(q);
+    for (size_t t = 0; t < m; ++t)
+    {
+        size_t codes[3] = {0, 0, 0};
+        for (size_t k = 0; k < 3; ++k)
+        {
+            for (size_t i = 0; i < l; ++i)
+            {
+                codes[k] = 2 * codes[k] + series[(k * l + i) * m + t];
+            }
+        }
+        inform_dist_tick(joint, (codes[0] * q + codes[1]) * q + codes[2]);
+        inform_dist_tick(as, codes[0] * q + codes[2]);
+        inform_dist_tick(bs, codes[1] * q + codes[2]);
+        inform_dist_tick(s, codes[2]);
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR_TOL(inform_shannon_cmi(joint, as, bs, s, 2.0),
+        inform_information_flow(series, series + l * m, series + 2 * l * m, l,
+            l, l, 1, m, 2, &err), 1e-9);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    inform_dist_free(s);
+    inform_dist_free(bs);
+    inform_dist_free(as);
+    inform_dist_free(joint);
+    free(series);
+}
+
+/*
+ * Replay stored series to `inform_information_flow_generated`, optionally
+ * corrupting or over-producing the first batch.
+ */
+typedef struct replay
+{
+    int const *src, *dst, *back;
+    size_t l_src, l_dst, l_back, m, t;
+    int corrupt;
+    bool overproduce;
+} replay;
+
+static size_t replay_samples(int *src, int *dst, int *back, size_t n,
+    void *context)
+{
+    replay *r = context;
+    size_t const k = (r->m - r->t < n) ? r->m - r->t : n;
+    for (size_t i = 0; i < k; ++i)
+    {
+        for (size_t v = 0; v < r->l_src; ++v) src[v*n + i] = r->src[v*r->m + r->t + i];
+        for (size_t v = 0; v < r->l_dst; ++v) dst[v*n + i] = r->dst[v*r->m + r->t + i];
+        for (size_t v = 0; v < r->l_back; ++v) back[v*n + i] = r->back[v*r->m + r->t + i];
+    }
+    if (r->corrupt && k != 0)
+    {
+        dst[k - 1] = r->corrupt;
+    }
+    r->t += k;
+    return r->overproduce ? n + 1 : k;
+}
+
+UNIT(InformationFlowGeneratedInvalid)
+{
+    int const series[6] = {1,1,0,0,0,1};
+    inform_error err = INFORM_SUCCESS;
+    replay r = { series, series, series, 1, 1, 1, 6, 0, 0, false };
+
+    ASSERT_NAN(inform_information_flow_generated(NULL, &r, 1, 1, 1, 2, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_information_flow_generated(replay_samples, &r, 0, 1, 1, 2, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_information_flow_generated(replay_samples, &r, 1, 1, 1, 1, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+
+    err = INFORM_SUCCESS;
+    r.m = 0;
+    ASSERT_NAN(inform_information_flow_generated(replay_samples, &r, 1, 1, 1, 2, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+
+    err = INFORM_SUCCESS;
+    r = (replay){ series, series, series, 1, 1, 1, 6, 0, 2, false };
+    ASSERT_NAN(inform_information_flow_generated(replay_samples, &r, 1, 1, 1, 2, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+
+    err = INFORM_SUCCESS;
+    r = (replay){ series, series, series, 1, 1, 1, 6, 0, -1, false };
+    ASSERT_NAN(inform_information_flow_generated(replay_samples, &r, 1, 1, 1, 2, &err));
+    ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+
+    err = INFORM_SUCCESS;
+    r = (replay){ series, series, series, 1, 1, 1, 6, 0, 0, true };
+    ASSERT_NAN(inform_information_flow_generated(replay_samples, &r, 1, 1, 1, 2, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+}
+
+UNIT(InformationFlowGenerated)
+{
+    inform_error err = INFORM_SUCCESS;
+    {
+        int const seriesA[12] = {1,1,0,0,0,0,
+                                 0,1,1,0,1,0};
+        int const seriesB[6]  = {0,0,1,0,1,1};
+        int const seriesS[6]  = {0,0,1,1,0,0};
+
+        replay r = { seriesA, seriesB, seriesS, 2, 1, 1, 6, 0, 0, false };
+        ASSERT_DBL_NEAR(1.0, inform_information_flow_generated(replay_samples,
+            &r, 2, 1, 1, 2, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+        r = (replay){ seriesB, seriesA, NULL, 1, 2, 0, 6, 0, 0, false };
+        ASSERT_DBL_NEAR(inform_information_flow(seriesB, seriesA, NULL, 1, 2,
+            0, 1, 6, 2, NULL), inform_information_flow_generated(replay_samples,
+            &r, 1, 2, 0, 2, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+    {
+        // several batches, the last of them partial
+        size_t const m = 100000;
+        int *series = malloc(6 * m * sizeof(int));
+        ASSERT_NOT_NULL(series);
+        uint64_t state = 3;
+        for (size_t i = 0; i < 6 * m; ++i)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            series[i] = (int) (state >> 62);
+        }
+        for (size_t t = 0; t < m; t += 3)
+        {
+            series[2 * m + t] = (series[t] + series[4 * m + t]) % 4;
+        }
+
+        replay r = { series, series + 2 * m, series + 4 * m, 2, 2, 2, m, 0,
+            0, false };
+        ASSERT_DBL_NEAR_TOL(inform_information_flow(series, series + 2 * m,
+            series + 4 * m, 2, 2, 2, 1, m, 4, NULL),
+            inform_information_flow_generated(replay_samples, &r, 2, 2, 2, 4,
+                &err), 1e-9);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        free(series);
+    }
+}
+
 BEGIN_SUITE(InformationFlow)
     ADD_UNIT(InformationFlowNULLSeries)
     ADD_UNIT(InformationFlowNoInits)
@@ -311,4 +479,7 @@ BEGIN_SUITE(InformationFlow)
     ADD_UNIT(InformationFlowBadState)
     ADD_UNIT(InformationFlowNoBackground)
     ADD_UNIT(InformationFlow)
+    ADD_UNIT(InformationFlowManyStates)
+    ADD_UNIT(InformationFlowGeneratedInvalid)
+    ADD_UNIT(InformationFlowGenerated)
 END_SUITE
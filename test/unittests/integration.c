@@ -2,7 +2,9 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include <inform/integration.h>
+#include <inform/utilities/partitions.h>
 #include <inform/utilities/random.h>
+#include <math.h>
 #include <ginger/unit.h>
 
 UNIT(IntegrationEvidenceNULLSeries)
@@ -304,6 +306,64 @@ UNIT(IntegrationEvidenceSynchronized)
     free(evidence);
 }
 
+UNIT(IntegrationEvidenceMatchesPartitions)
+{
+    srand(2203);
+    inform_error err = INFORM_SUCCESS;
+    size_t const l = 6, n = 50;
+    int const bases[6] = {2, 3, 2, 2, 3, 2};
+    int *series = malloc(l * n * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    for (size_t i = 0; i < l; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            // couple the later variables to the first
+            int const x = rand() % bases[i];
+            series[j + n*i] = (i > 2 && j % 3) ? series[j] : x;
+        }
+    }
+
+    double *evidence = inform_integration_evidence(series, l, n, bases, NULL,
+        &err);
+    ASSERT_NOT_NULL(evidence);
+    ASSERT_TRUE(inform_succeeded(&err));
+
+    double *minimum = malloc(2 * n * sizeof(double));
+    double *lmi = malloc(2 * n * sizeof(double));
+    ASSERT_NOT_NULL(minimum);
+    ASSERT_NOT_NULL(lmi);
+    double *maximum = minimum + n;
+    for (size_t i = 0; i < n; ++i)
+    {
+        minimum[i] = INFINITY;
+        maximum[i] = -INFINITY;
+    }
+    size_t *parts = inform_first_partitioning(l);
+    size_t nparts;
+    while ((nparts = inform_next_partitioning(parts, l)))
+    {
+        inform_integration_evidence_part(series, l, n, bases, parts, nparts,
+            lmi, &err);
+        ASSERT_TRUE(inform_succeeded(&err));
+        for (size_t i = 0; i < n; ++i)
+        {
+            minimum[i] = (lmi[i] < minimum[i]) ? lmi[i] : minimum[i];
+            maximum[i] = (lmi[i] > maximum[i]) ? lmi[i] : maximum[i];
+        }
+    }
+    for (size_t i = 0; i < 2 * n; ++i)
+    {
+        ASSERT_DBL_NEAR_TOL(minimum[i], evidence[i], 1e-9);
+    }
+
+    free(parts);
+    free(lmi);
+    free(minimum);
+    free(evidence);
+    free(series);
+}
+
 UNIT(IntegrationEvidencePartNULLSeries)
 {
     inform_error err = INFORM_SUCCESS;
@@ -765,6 +825,7 @@ BEGIN_SUITE(Integration)
     ADD_UNIT(IntegrationEvidenceTwoSeries)
     ADD_UNIT(IntegrationEvidenceThreeSeries)
     ADD_UNIT(IntegrationEvidenceSynchronized)
+    ADD_UNIT(IntegrationEvidenceMatchesPartitions)
 
     ADD_UNIT(IntegrationEvidencePartNULLSeries)
     ADD_UNIT(IntegrationEvidencePartTooFewSeries)
@@ -21,6 +21,7 @@ IMPORT_SUITE(RelativeEntropy);
 IMPORT_SUITE(SeparableInformation);
 IMPORT_SUITE(ShannonMulti);
 IMPORT_SUITE(ShannonUni);
+IMPORT_SUITE(ThreadPool);
 IMPORT_SUITE(TransferEntropy);
 IMPORT_SUITE(Utilities);
 
@@ -43,6 +44,7 @@ BEGIN_REGISTRATION
     REGISTER(SeparableInformation)
     REGISTER(ShannonMulti)
     REGISTER(ShannonUni)
+    REGISTER(ThreadPool)
     REGISTER(TransferEntropy)
     REGISTER(Utilities)
 END_REGISTRATION
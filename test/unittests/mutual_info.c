@@ -3,7 +3,9 @@
 // license that can be found in the LICENSE file.
 #include "util.h"
 #include <inform/mutual_info.h>
+#include <inform/utilities/random.h>
 #include <math.h>
+#include <string.h>
 #include <ginger/unit.h>
 
 UNIT(MutualInfoNULLSeries)
@@ -519,6 +521,250 @@ UNIT(LocalMutualInfoMultivariate)
     }
 }
 
+UNIT(MutualInfoView)
+{
+    inform_error err = INFORM_SUCCESS;
+    // three variables stored as the columns of a time-by-variable matrix
+    int const matrix[30] = {
+        0,1,2, 1,1,0, 1,0,1, 0,0,2, 1,1,1,
+        0,1,0, 1,0,2, 1,1,2, 0,0,0, 1,0,1,
+    };
+    int series[30];
+    for (size_t t = 0; t < 10; ++t)
+    {
+        for (size_t v = 0; v < 3; ++v)
+        {
+            series[t + 10 * v] = matrix[3 * t + v];
+        }
+    }
+    int const b[3] = {2, 2, 3};
+    inform_view const view = inform_view_strided(matrix, 3, 0, 1);
+
+    for (size_t l = 2; l <= 3; ++l)
+    {
+        double const expect = inform_mutual_info(series, l, 10, b, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_DBL_NEAR_TOL(expect, inform_mutual_info_view(view, l, 10, b, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+        double local[10], local_view[10];
+        ASSERT_NOT_NULL(inform_local_mutual_info(series, l, 10, b, local, &err));
+        ASSERT_NOT_NULL(inform_local_mutual_info_view(view, l, 10, b, local_view, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        for (size_t i = 0; i < 10; ++i)
+        {
+            ASSERT_DBL_NEAR_TOL(local[i], local_view[i], 1e-12);
+        }
+    }
+
+    inform_view const bad = inform_view_strided(NULL, 3, 0, 1);
+    ASSERT_NAN(inform_mutual_info_view(bad, 2, 10, b, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_mutual_info_view(view, 3, 10, (int[]){2,2,2}, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+}
+
+UNIT(MutualInfoMatrixInvalid)
+{
+    inform_error err = INFORM_SUCCESS;
+    int const series[8] = {0,1,1,0, 1,1,0,2};
+    ASSERT_NULL(inform_mutual_info_matrix(NULL, 2, 4, (int[]){2,2}, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_mutual_info_matrix(series, 1, 4, (int[]){2}, NULL, &err));
+    ASSERT_EQUAL(INFORM_ENOSOURCES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_mutual_info_matrix(series, 2, 0, (int[]){2,2}, NULL, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_mutual_info_matrix(series, 2, 4, (int[]){2,1}, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_mutual_info_matrix(series, 2, 4, (int[]){2,2}, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_mutual_info_matrix(series, 2, 4, (int[]){65536,65536}, NULL, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
+UNIT(MutualInfoMatrix)
+{
+    inform_error err = INFORM_SUCCESS;
+    size_t const l = 40, n = 5000;
+    int *series = malloc(l * n * sizeof(int));
+    int *b = malloc(l * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    ASSERT_NOT_NULL(b);
+
+    uint64_t state = 12345;
+    for (size_t i = 0; i < l; ++i)
+    {
+        b[i] = 2 + (int)(i % 4);
+        for (size_t t = 0; t < n; ++t)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            int const noise = (int)(state >> 33) % b[i];
+            // make neighbouring series dependent on one another
+            series[i * n + t] = (i > 0 && (state >> 62) != 0)
+                ? series[(i - 1) * n + t] % b[i] : noise;
+        }
+    }
+
+    double *mi = inform_mutual_info_matrix(series, l, n, b, NULL, &err);
+    ASSERT_NOT_NULL(mi);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < l; ++i)
+    {
+        for (size_t j = 0; j < l; ++j)
+        {
+            // the diagonal is the mutual information of a series with itself
+            int const pair[2] = {b[i], b[j]};
+            int *xs = malloc(2 * n * sizeof(int));
+            memcpy(xs, series + i * n, n * sizeof(int));
+            memcpy(xs + n, series + j * n, n * sizeof(int));
+            double const expect = inform_mutual_info(xs, 2, n, pair, &err);
+            free(xs);
+            ASSERT_EQUAL(INFORM_SUCCESS, err);
+            ASSERT_DBL_NEAR_TOL(expect, mi[i * l + j], 1e-10);
+        }
+    }
+
+    // large bases shrink the tiles
+    for (size_t i = 0; i < l; ++i)
+    {
+        b[i] = 100;
+        for (size_t t = 0; t < n; ++t)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            series[i * n + t] = (i > 0 && (state >> 63) != 0)
+                ? series[(i - 1) * n + t] : (int)((state >> 33) % 100);
+        }
+    }
+    ASSERT_NOT_NULL(inform_mutual_info_matrix(series, l, n, b, mi, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < l; ++i)
+    {
+        for (size_t j = i + 1; j < l; ++j)
+        {
+            int *xs = malloc(2 * n * sizeof(int));
+            memcpy(xs, series + i * n, n * sizeof(int));
+            memcpy(xs + n, series + j * n, n * sizeof(int));
+            double const expect = inform_mutual_info(xs, 2, n, (int[]){100,100}, &err);
+            free(xs);
+            ASSERT_DBL_NEAR_TOL(expect, mi[i * l + j], 1e-10);
+            ASSERT_DBL_NEAR_TOL(expect, mi[j * l + i], 1e-10);
+        }
+    }
+
+    // the same series read as the columns of a time-by-variable matrix
+    int *matrix = malloc(l * n * sizeof(int));
+    ASSERT_NOT_NULL(matrix);
+    for (size_t i = 0; i < l; ++i)
+    {
+        for (size_t t = 0; t < n; ++t)
+        {
+            matrix[t * l + i] = series[i * n + t];
+        }
+    }
+    inform_view const view = inform_view_strided(matrix, l, 0, 1);
+    double *mi_view = inform_mutual_info_matrix_view(view, l, n, b, NULL, &err);
+    ASSERT_NOT_NULL(mi_view);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < l * l; ++i)
+    {
+        ASSERT_DBL_NEAR_TOL(mi[i], mi_view[i], 1e-12);
+    }
+
+    free(mi_view);
+    free(matrix);
+    free(mi);
+    free(b);
+    free(series);
+}
+
+UNIT(MutualInfoEstimators)
+{
+    inform_error err = INFORM_SUCCESS;
+    int const series[20] = {0,0,1,1,1,1,0,0,0,1,
+                            0,1,1,1,0,1,0,0,1,1};
+    int const b[2] = {2, 2};
+    ASSERT_DBL_NEAR_TOL(inform_mutual_info(series, 2, 10, b, &err),
+        inform_mutual_info_est(series, 2, 10, b, INFORM_PLUGIN, &err), 1e-12);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    // every state and pair is observed, so Miller-Madow subtracts
+    // (2 - 1) + (2 - 1) - (4 - 1) halves of an observation
+    ASSERT_DBL_NEAR_TOL(inform_mutual_info(series, 2, 10, b, &err) - 1.0 / (20.0 * log(2.0)),
+        inform_mutual_info_est(series, 2, 10, b, INFORM_MILLER_MADOW, &err), 1e-12);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    ASSERT_NAN(inform_mutual_info_est(series, 2, 10, b, (inform_estimator) -1, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+}
+
+UNIT(MutualInfoMatrixConfig)
+{
+    inform_error err = INFORM_SUCCESS;
+    size_t const l = 40, n = 1000;
+    int *series = inform_random_series(l * n, 4);
+    ASSERT_NOT_NULL(series);
+    int b[40];
+    for (size_t i = 0; i < l; ++i) b[i] = 4;
+
+    double *expect = inform_mutual_info_matrix(series, l, n, b, NULL, &err);
+    ASSERT_NOT_NULL(expect);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    // a budget for only one tile at a time
+    inform_config config = inform_config_default();
+    config.memory = 300000;
+    config.validation = INFORM_VALIDATE_ARGS;
+    double *mi = inform_mutual_info_matrix_ex(series, l, n, b, NULL, &config,
+        &err);
+    ASSERT_NOT_NULL(mi);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < l * l; ++i)
+    {
+        ASSERT_DBL_NEAR_TOL(expect[i], mi[i], 1e-12);
+    }
+
+    ASSERT_NOT_NULL(inform_mutual_info_matrix_ex(series, l, n, b, mi, NULL,
+        &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < l * l; ++i)
+    {
+        ASSERT_DBL_NEAR_TOL(expect[i], mi[i], 1e-12);
+    }
+
+    config.memory = 1000;
+    ASSERT_NULL(inform_mutual_info_matrix_ex(series, l, n, b, mi, &config,
+        &err));
+    ASSERT_EQUAL(INFORM_EBUDGET, err);
+
+    config = inform_config_default();
+    config.histogram = INFORM_HISTOGRAM_SPARSE;
+    ASSERT_NULL(inform_mutual_info_matrix_ex(series, l, n, b, mi, &config,
+        &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    // an unknown validation level must not skip the state checks
+    config = inform_config_default();
+    config.validation = (inform_validation) -1;
+    ASSERT_NULL(inform_mutual_info_matrix_ex(series, l, n, b, mi, &config,
+        &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    free(mi);
+    free(expect);
+    free(series);
+}
+
 BEGIN_SUITE(MutualInfo)
     ADD_UNIT(MutualInfoNULLSeries)
     ADD_UNIT(MutualInfoTooFewSeries)
@@ -538,4 +784,9 @@ BEGIN_SUITE(MutualInfo)
     ADD_UNIT(LocalMutualInfoAllocatesOutput)
     ADD_UNIT(LocalMutualInfoUnivariate)
     ADD_UNIT(LocalMutualInfoMultivariate)
+    ADD_UNIT(MutualInfoView)
+    ADD_UNIT(MutualInfoMatrixInvalid)
+    ADD_UNIT(MutualInfoMatrix)
+    ADD_UNIT(MutualInfoEstimators)
+    ADD_UNIT(MutualInfoMatrixConfig)
 END_SUITE
@@ -70,6 +70,29 @@ UNIT(PIDNoResponses)
 }
 
 
+UNIT(PIDTooManySources)
+{
+    // subsets of the sources are bitmasks, so there must be fewer sources
+    // than bits in a size_t
+    size_t const l = 8 * sizeof(size_t);
+    int const stimulus[5] = {0,1,1,0,0};
+    int responses[5 * 8 * sizeof(size_t)] = {0};
+    int br[8 * sizeof(size_t)];
+    for (size_t i = 0; i < l; ++i) br[i] = 2;
+
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid(stimulus, responses, l, 5, 2, br, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_flat(stimulus, responses, l, 5, 2, br, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    // the error is optional
+    ASSERT_NULL(inform_pid(stimulus, responses, l, 5, 2, br, NULL));
+    ASSERT_NULL(inform_pid_flat(stimulus, responses, l, 5, 2, br, NULL));
+}
+
 UNIT(PIDShortSeries)
 {
     int const stimulus[5] = {0,1,1,0,0};
@@ -323,6 +346,28 @@ UNIT(PIDOR)
     inform_pid_lattice_free(l);
 }
 
+UNIT(PIDMixedBases)
+{
+    double const x = log2(3);
+    double const imin[4] = { 0., 0., x, x };
+    double const pi[4]   = { 0., 0., x, 0. };
+
+    int const data[18] = {0,1,2,0,1,2, 0,0,0,1,1,1, 0,1,2,0,1,2};
+
+    inform_error err = INFORM_SUCCESS;
+    inform_pid_lattice *l = inform_pid(data, data+6, 2, 6, 3, (int[]){2,3}, &err);
+
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_NOT_NULL(l);
+    for (size_t i = 0; i < l->size; ++i)
+    {
+        ASSERT_DBL_NEAR(imin[i], l->sources[i]->imin);
+        ASSERT_DBL_NEAR(pi[i], l->sources[i]->pi);
+    }
+
+    inform_pid_lattice_free(l);
+}
+
 UNIT(PIDStochastic)
 {
     double const imin[4] = { 0.001317, 0.011000, 0.001317, 0.012888 };
@@ -435,6 +480,407 @@ UNIT(PIDRandom)
     free(data);
 }
 
+static size_t node_position(inform_pid_lattice const *l,
+    inform_pid_source const *node)
+{
+    size_t i = 0;
+    while (i < l->size && l->sources[i] != node) ++i;
+    return i;
+}
+
+UNIT(PIDLatticeReuse)
+{
+    int *data = inform_random_series(400, 2);
+    ASSERT_NOT_NULL(data);
+
+    inform_error err = INFORM_SUCCESS;
+    inform_pid_lattice *a = inform_pid(data, data+100, 3, 100, 2, (int[]){2,2,2}, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_NOT_NULL(a);
+
+    // each decomposition has its own copy of the shared lattice
+    inform_pid_lattice *b = inform_pid(data+100, data+200, 2, 100, 2, (int[]){2,2}, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_NOT_NULL(b);
+    inform_pid_lattice_free(b);
+
+    b = inform_pid(data, data+100, 3, 100, 2, (int[]){2,2,2}, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_NOT_NULL(b);
+    ASSERT_TRUE(a->sources != b->sources);
+    ASSERT_EQUAL_U(a->size, b->size);
+    for (size_t i = 0; i < a->size; ++i)
+    {
+        inform_pid_source const *x = a->sources[i], *y = b->sources[i];
+        ASSERT_EQUAL_U(x->size, y->size);
+        ASSERT_EQUAL_U(0, memcmp(x->name, y->name, x->size * sizeof(size_t)));
+        ASSERT_EQUAL_U(x->n_above, y->n_above);
+        ASSERT_EQUAL_U(x->n_below, y->n_below);
+        for (size_t j = 0; j < x->n_below; ++j)
+        {
+            ASSERT_EQUAL_U(node_position(a, x->below[j]),
+                node_position(b, y->below[j]));
+        }
+        ASSERT_DBL_NEAR(x->imin, y->imin);
+        ASSERT_DBL_NEAR(x->pi, y->pi);
+    }
+    ASSERT_TRUE(a->top == a->sources[a->size - 1]);
+    ASSERT_TRUE(b->bottom == b->sources[0]);
+
+    inform_pid_lattice_free(b);
+    inform_pid_lattice_free(a);
+    free(data);
+}
+
+UNIT(PIDFlatInvalid)
+{
+    int const stimulus[5] = {0,0,1,1,0};
+    int const responses[10] = {0,1,0,1,1, 1,1,0,0,0};
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_flat(NULL, responses, 2, 5, 2, (int[2]){2,2}, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_flat(stimulus, responses, 0, 5, 2, (int[2]){2,2}, &err));
+    ASSERT_EQUAL(INFORM_ENOSOURCES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_flat(stimulus, responses, 2, 5, 2, (int[2]){2,1}, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+}
+
+UNIT(PIDFlat)
+{
+    {
+        int const data[12] = {0,1,1,0, 0,0,1,1, 0,1,0,1};
+        inform_error err = INFORM_SUCCESS;
+        inform_pid_flat_lattice *l = inform_pid_flat(data, data+4, 2, 4, 2, (int[]){2,2}, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_NOT_NULL(l);
+        ASSERT_EQUAL_U(4, l->size);
+
+        size_t const name_offsets[5] = {0, 2, 3, 4, 5};
+        size_t const names[5] = {1, 2, 1, 2, 3};
+        size_t const above_offsets[5] = {0, 2, 3, 4, 4};
+        size_t const above[4] = {1, 2, 3, 3};
+        size_t const below_offsets[5] = {0, 0, 1, 2, 4};
+        size_t const below[4] = {0, 0, 1, 2};
+        ASSERT_EQUAL_U(0, memcmp(name_offsets, l->name_offsets, sizeof name_offsets));
+        ASSERT_EQUAL_U(0, memcmp(names, l->names, sizeof names));
+        ASSERT_EQUAL_U(0, memcmp(above_offsets, l->above_offsets, sizeof above_offsets));
+        ASSERT_EQUAL_U(0, memcmp(above, l->above, sizeof above));
+        ASSERT_EQUAL_U(0, memcmp(below_offsets, l->below_offsets, sizeof below_offsets));
+        ASSERT_EQUAL_U(0, memcmp(below, l->below, sizeof below));
+
+        double const imin[4] = { 0., 0., 0., 1. };
+        double const pi[4]   = { 0., 0., 0., 1. };
+        for (size_t i = 0; i < l->size; ++i)
+        {
+            ASSERT_DBL_NEAR(imin[i], l->imin[i]);
+            ASSERT_DBL_NEAR(pi[i], l->pi[i]);
+        }
+        inform_pid_flat_lattice_free(l);
+    }
+
+    {
+        int *data = inform_random_series(2000, 3);
+        ASSERT_NOT_NULL(data);
+        int const bases[3] = {3,3,3};
+
+        inform_error err = INFORM_SUCCESS;
+        inform_pid_lattice *l = inform_pid(data, data+500, 3, 500, 3, bases, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_NOT_NULL(l);
+        inform_pid_flat_lattice *f = inform_pid_flat(data, data+500, 3, 500, 3, bases, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_NOT_NULL(f);
+
+        ASSERT_EQUAL_U(l->size, f->size);
+        for (size_t i = 0; i < f->size; ++i)
+        {
+            inform_pid_source const *x = l->sources[i];
+            ASSERT_EQUAL_U(x->size, f->name_offsets[i+1] - f->name_offsets[i]);
+            ASSERT_EQUAL_U(0, memcmp(x->name, f->names + f->name_offsets[i], x->size * sizeof(size_t)));
+            ASSERT_EQUAL_U(x->n_above, f->above_offsets[i+1] - f->above_offsets[i]);
+            for (size_t j = 0; j < x->n_above; ++j)
+            {
+                ASSERT_EQUAL_U(node_position(l, x->above[j]), f->above[f->above_offsets[i] + j]);
+            }
+            ASSERT_DBL_NEAR(x->imin, f->imin[i]);
+            ASSERT_DBL_NEAR(x->pi, f->pi[i]);
+        }
+
+        inform_pid_flat_lattice_free(f);
+        inform_pid_lattice_free(l);
+        free(data);
+    }
+}
+
+UNIT(PIDBatchInvalid)
+{
+    int const stimulus[5] = {0,0,1,1,0};
+    int const responses[10] = {0,1,0,1,1, 1,1,0,0,0};
+    size_t const tuples[2] = {0, 1};
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_batch(NULL, responses, 2, 5, 2, (int[2]){2,2}, tuples, 2, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_batch(stimulus, responses, 2, 5, 2, (int[2]){2,2}, NULL, 2, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_batch(stimulus, responses, 2, 5, 2, (int[2]){2,2}, tuples, 2, 0, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_batch(stimulus, responses, 2, 5, 2, (int[2]){2,2}, tuples, 0, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_ENOSOURCES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_batch(stimulus, responses, 2, 5, 2, (int[2]){2,2}, (size_t[2]){0, 2}, 2, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL_U(0, inform_pid_lattice_size(0, &err));
+    ASSERT_EQUAL(INFORM_ENOSOURCES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL_U(0, inform_pid_lattice_size(8 * sizeof(size_t), &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    // the error is optional
+    size_t const many[8 * sizeof(size_t)] = {0};
+    ASSERT_EQUAL_U(0, inform_pid_lattice_size(0, NULL));
+    ASSERT_EQUAL_U(0, inform_pid_lattice_size(8 * sizeof(size_t), NULL));
+    ASSERT_NULL(inform_pid_batch(stimulus, responses, 2, 5, 2, (int[2]){2,2}, tuples, 0, 1, NULL, NULL));
+    ASSERT_NULL(inform_pid_batch(stimulus, responses, 2, 5, 2, (int[2]){2,2}, many, 8 * sizeof(size_t), 1, NULL, NULL));
+}
+
+UNIT(PIDBatch)
+{
+    ASSERT_EQUAL_U(1, inform_pid_lattice_size(1, NULL));
+    ASSERT_EQUAL_U(4, inform_pid_lattice_size(2, NULL));
+    ASSERT_EQUAL_U(18, inform_pid_lattice_size(3, NULL));
+    ASSERT_EQUAL_U(166, inform_pid_lattice_size(4, NULL));
+
+    size_t const nresponses = 5, n = 200;
+    int *data = inform_random_series((nresponses + 1) * n, 3);
+    ASSERT_NOT_NULL(data);
+    int const bases[5] = {3,3,3,3,3};
+    int const *stimulus = data, *responses = data + n;
+
+    {
+        size_t tuples[2 * 10];
+        size_t ntuples = 0;
+        for (size_t i = 0; i < nresponses; ++i)
+        {
+            for (size_t j = i + 1; j < nresponses; ++j, ++ntuples)
+            {
+                tuples[2 * ntuples] = j;
+                tuples[2 * ntuples + 1] = i;
+            }
+        }
+
+        inform_error err = INFORM_SUCCESS;
+        double *pi = inform_pid_batch(stimulus, responses, nresponses, n, 3,
+            bases, tuples, 2, ntuples, NULL, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_NOT_NULL(pi);
+
+        int pair[2 * 200];
+        for (size_t t = 0; t < ntuples; ++t)
+        {
+            memcpy(pair, responses + tuples[2 * t] * n, n * sizeof(int));
+            memcpy(pair + n, responses + tuples[2 * t + 1] * n, n * sizeof(int));
+            inform_pid_flat_lattice *f = inform_pid_flat(stimulus, pair, 2, n,
+                3, bases, &err);
+            ASSERT_EQUAL(INFORM_SUCCESS, err);
+            ASSERT_NOT_NULL(f);
+            for (size_t i = 0; i < f->size; ++i)
+            {
+                ASSERT_DBL_NEAR(f->pi[i], pi[t * f->size + i]);
+            }
+            inform_pid_flat_lattice_free(f);
+        }
+        free(pi);
+    }
+
+    {
+        size_t const tuples[6] = {0, 2, 4, 3, 1, 0};
+        double pi[2 * 18];
+        inform_error err = INFORM_SUCCESS;
+        ASSERT_NOT_NULL(inform_pid_batch(stimulus, responses, nresponses, n,
+            3, bases, tuples, 3, 2, pi, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+        int triple[3 * 200];
+        for (size_t t = 0; t < 2; ++t)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                memcpy(triple + k * n, responses + tuples[3 * t + k] * n, n * sizeof(int));
+            }
+            inform_pid_flat_lattice *f = inform_pid_flat(stimulus, triple, 3, n,
+                3, bases, &err);
+            ASSERT_EQUAL(INFORM_SUCCESS, err);
+            ASSERT_NOT_NULL(f);
+            for (size_t i = 0; i < f->size; ++i)
+            {
+                ASSERT_DBL_NEAR(f->pi[i], pi[t * f->size + i]);
+            }
+            inform_pid_flat_lattice_free(f);
+        }
+    }
+
+    free(data);
+}
+
+UNIT(PIDMeasureInvalid)
+{
+    int const stimulus[5] = {0,0,1,1,0};
+    int const responses[15] = {0,1,0,1,1, 1,1,0,0,0, 0,0,1,1,1};
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_flat_measure(stimulus, responses, 2, 5, 2, (int[2]){2,2}, (inform_pid_measure) 3, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_flat_measure(stimulus, responses, 3, 5, 2, (int[3]){2,2,2}, INFORM_PID_BROJA, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_flat_measure(NULL, responses, 2, 5, 2, (int[2]){2,2}, INFORM_PID_CCS, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_batch_measure(stimulus, responses, 3, 5, 2, (int[3]){2,2,2}, (size_t[3]){0,1,2}, 3, 1, INFORM_PID_BROJA, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pid_batch_measure(stimulus, responses, 3, 5, 2, (int[3]){2,2,2}, (size_t[2]){0,1}, 2, 1, (inform_pid_measure) -1, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+}
+
+static void assert_measure(int const *data, size_t n, int bs, int const *br,
+        inform_pid_measure measure, double const *red, double const *pi)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_pid_flat_lattice *f = inform_pid_flat_measure(data, data+n, 2, n,
+        bs, br, measure, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_NOT_NULL(f);
+    ASSERT_EQUAL_U(4, f->size);
+    for (size_t i = 0; i < f->size; ++i)
+    {
+        ASSERT_DBL_NEAR_TOL(red[i], f->imin[i], 1e-6);
+        ASSERT_DBL_NEAR_TOL(pi[i], f->pi[i], 1e-6);
+    }
+    inform_pid_flat_lattice_free(f);
+}
+
+UNIT(PIDMeasureCCS)
+{
+    int const xor[12] = {0,1,1,0, 0,1,0,1, 0,0,1,1};
+    assert_measure(xor, 4, 2, (int[2]){2,2}, INFORM_PID_CCS,
+        (double[4]){0., 0., 0., 1.}, (double[4]){0., 0., 0., 1.});
+
+    double const x = 1.5 - 0.75 * log2(3);
+    int const and[12] = {0,0,0,1, 0,1,0,1, 0,0,1,1};
+    assert_measure(and, 4, 2, (int[2]){2,2}, INFORM_PID_CCS,
+        (double[4]){0.103759, x, x, x + 0.5},
+        (double[4]){0.103759, x - 0.103759, x - 0.103759, 0.5 - x + 0.103759});
+
+    int const rdn[6] = {0,1, 0,1, 0,1};
+    assert_measure(rdn, 2, 2, (int[2]){2,2}, INFORM_PID_CCS,
+        (double[4]){1., 1., 1., 1.}, (double[4]){1., 0., 0., 0.});
+
+    int const copy[12] = {0,1,2,3, 0,1,0,1, 0,0,1,1};
+    assert_measure(copy, 4, 4, (int[2]){2,2}, INFORM_PID_CCS,
+        (double[4]){0., 1., 1., 2.}, (double[4]){0., 1., 1., 0.});
+}
+
+UNIT(PIDMeasureBROJA)
+{
+    int const xor[12] = {0,1,1,0, 0,1,0,1, 0,0,1,1};
+    assert_measure(xor, 4, 2, (int[2]){2,2}, INFORM_PID_BROJA,
+        (double[4]){0., 0., 0., 1.}, (double[4]){0., 0., 0., 1.});
+
+    double const x = 1.5 - 0.75 * log2(3);
+    int const and[12] = {0,0,0,1, 0,1,0,1, 0,0,1,1};
+    assert_measure(and, 4, 2, (int[2]){2,2}, INFORM_PID_BROJA,
+        (double[4]){x, x, x, x + 0.5}, (double[4]){x, 0., 0., 0.5});
+
+    int const rdn[6] = {0,1, 0,1, 0,1};
+    assert_measure(rdn, 2, 2, (int[2]){2,2}, INFORM_PID_BROJA,
+        (double[4]){1., 1., 1., 1.}, (double[4]){1., 0., 0., 0.});
+
+    int const copy[12] = {0,1,2,3, 0,1,0,1, 0,0,1,1};
+    assert_measure(copy, 4, 4, (int[2]){2,2}, INFORM_PID_BROJA,
+        (double[4]){0., 1., 1., 2.}, (double[4]){0., 1., 1., 0.});
+}
+
+UNIT(PIDBatchMeasure)
+{
+    size_t const nresponses = 4, n = 200;
+    int *data = inform_random_series((nresponses + 1) * n, 3);
+    ASSERT_NOT_NULL(data);
+    int const bases[4] = {3,3,3,3};
+    int const *stimulus = data, *responses = data + n;
+
+    size_t const tuples[6] = {0, 1, 3, 2, 1, 3};
+    inform_pid_measure const measures[3] = {
+        INFORM_PID_IMIN, INFORM_PID_CCS, INFORM_PID_BROJA
+    };
+    for (size_t m = 0; m < 3; ++m)
+    {
+        inform_error err = INFORM_SUCCESS;
+        double *pi = inform_pid_batch_measure(stimulus, responses, nresponses,
+            n, 3, bases, tuples, 2, 3, measures[m], NULL, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_NOT_NULL(pi);
+
+        int pair[2 * 200];
+        for (size_t t = 0; t < 3; ++t)
+        {
+            memcpy(pair, responses + tuples[2 * t] * n, n * sizeof(int));
+            memcpy(pair + n, responses + tuples[2 * t + 1] * n, n * sizeof(int));
+            inform_pid_flat_lattice *f = inform_pid_flat_measure(stimulus,
+                pair, 2, n, 3, bases, measures[m], &err);
+            ASSERT_EQUAL(INFORM_SUCCESS, err);
+            ASSERT_NOT_NULL(f);
+            double total = 0.0;
+            for (size_t i = 0; i < f->size; ++i)
+            {
+                ASSERT_DBL_NEAR(f->pi[i], pi[t * f->size + i]);
+                total += f->pi[i];
+            }
+            ASSERT_DBL_NEAR(f->imin[f->size - 1], total);
+            inform_pid_flat_lattice_free(f);
+        }
+        free(pi);
+    }
+
+    {
+        size_t const triple[3] = {0, 1, 2};
+        inform_error err = INFORM_SUCCESS;
+        double *pi = inform_pid_batch_measure(stimulus, responses, nresponses,
+            n, 3, bases, triple, 3, 1, INFORM_PID_CCS, NULL, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_NOT_NULL(pi);
+        double total = 0.0;
+        for (size_t i = 0; i < 18; ++i) total += pi[i];
+
+        inform_pid_flat_lattice *f = inform_pid_flat(stimulus, responses, 3,
+            n, 3, bases, &err);
+        ASSERT_NOT_NULL(f);
+        ASSERT_DBL_NEAR(f->imin[f->size - 1], total);
+        inform_pid_flat_lattice_free(f);
+        free(pi);
+    }
+
+    free(data);
+}
+
 // UNIT(PIDMemory)
 // {
 //     size_t const m = 7, n = 10000;
@@ -456,6 +902,7 @@ BEGIN_SUITE(PID)
     ADD_UNIT(PIDNULLStimulus)
     ADD_UNIT(PIDNULLResponses)
     ADD_UNIT(PIDNoResponses)
+    ADD_UNIT(PIDTooManySources)
     ADD_UNIT(PIDShortSeries)
     ADD_UNIT(PIDInvalidBase)
     ADD_UNIT(PIDNegativeState)
@@ -465,10 +912,20 @@ BEGIN_SUITE(PID)
     ADD_UNIT(PIDXOR)
     ADD_UNIT(PIDAND)
     ADD_UNIT(PIDOR)
+    ADD_UNIT(PIDMixedBases)
     ADD_UNIT(PIDStochastic)
     ADD_UNIT(PIDWilliamsBeer4a)
     ADD_UNIT(PIDWilliamsBeer4b)
     ADD_UNIT(PID4Variables)
     ADD_UNIT(PIDRandom)
+    ADD_UNIT(PIDLatticeReuse)
+    ADD_UNIT(PIDFlatInvalid)
+    ADD_UNIT(PIDFlat)
+    ADD_UNIT(PIDBatchInvalid)
+    ADD_UNIT(PIDBatch)
+    ADD_UNIT(PIDMeasureInvalid)
+    ADD_UNIT(PIDMeasureCCS)
+    ADD_UNIT(PIDMeasureBROJA)
+    ADD_UNIT(PIDBatchMeasure)
     // ADD_UNIT(PIDMemory)
 END_SUITE
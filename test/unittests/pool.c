@@ -0,0 +1,376 @@
+// Copyright 2016-2018 ELIFE. All rights reserved.
+// Use of this source code is governed by a MIT
+// license that can be found in the LICENSE file.
+#include <inform/config.h>
+#include <inform/information_flow.h>
+#include <inform/mutual_info.h>
+#include <inform/pool.h>
+#include <inform/utilities/random.h>
+#include <ginger/unit.h>
+#include <math.h>
+
+#ifdef INFORM_HAVE_PTHREADS
+#include <pthread.h>
+#endif
+
+/*
+ * A host pool which either runs what it is given at once, on the submitting
+ * thread, or holds on to it until told to run it.
+ */
+typedef struct host_pool
+{
+    bool inline_run;
+    void (*hook)(void *arg);
+    void *hook_arg;
+    size_t n;
+    void (*run[64])(void *arg);
+    void *arg[64];
+} host_pool;
+
+static void host_submit(void (*run)(void *arg), void *arg, void *host)
+{
+    host_pool *h = host;
+    if (h->hook != NULL)
+    {
+        h->hook(h->hook_arg);
+    }
+    if (h->inline_run)
+    {
+        run(arg);
+    }
+    else if (h->n < 64)
+    {
+        h->run[h->n] = run;
+        h->arg[h->n++] = arg;
+    }
+}
+
+static void host_drain(host_pool *h)
+{
+    for (size_t i = 0; i < h->n; ++i) h->run[i](h->arg[i]);
+    h->n = 0;
+}
+
+static void assert_matrix(int const *series, size_t l, size_t n, int const *b,
+    double const *expect, inform_config const *config)
+{
+    inform_error err = INFORM_SUCCESS;
+    double *mi = inform_mutual_info_matrix_ex(series, l, n, b, NULL, config,
+        &err);
+    ASSERT_NOT_NULL(mi);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < l * l; ++i)
+    {
+        ASSERT_DBL_NEAR_TOL(expect[i], mi[i], 1e-12);
+    }
+    free(mi);
+}
+
+/*
+ * Series in which one variable in eight has 32 states and the rest have two,
+ * so that the tiles of a mutual information matrix differ greatly in cost
+ * and the pool's threads have to steal from one another.
+ */
+static int *uneven_series(size_t l, size_t n, int *b)
+{
+    int *series = inform_random_series(l * n, 32);
+    if (series != NULL)
+    {
+        for (size_t i = 0; i < l; ++i)
+        {
+            b[i] = (i % 8 == 0) ? 32 : 2;
+            for (size_t t = 0; t < n; ++t) series[i*n + t] %= b[i];
+        }
+    }
+    return series;
+}
+
+/*
+ * A mutual information matrix to recompute, possibly from within a task of
+ * a pool or on several threads at once, and compare to the serial result.
+ * Failures are counted rather than asserted, since the checks may not run on
+ * the test's thread.
+ */
+typedef struct matrix_check
+{
+    int const *series, *b;
+    size_t l, n;
+    double const *expect;
+    inform_config const *config;
+    size_t calls, failures, batches;
+} matrix_check;
+
+static void recompute_matrix(void *arg)
+{
+    matrix_check *c = arg;
+    inform_error err = INFORM_SUCCESS;
+    double *mi = inform_mutual_info_matrix_ex(c->series, c->l, c->n, c->b,
+        NULL, c->config, &err);
+    bool same = (mi != NULL && err == INFORM_SUCCESS);
+    for (size_t i = 0; same && i < c->l * c->l; ++i)
+    {
+        same = fabs(c->expect[i] - mi[i]) < 1e-12;
+    }
+    c->calls++;
+    c->failures += !same;
+    free(mi);
+}
+
+/*
+ * A generator for `inform_information_flow_generated` which recomputes the
+ * matrix before producing each of a few batches. All but the first batch
+ * are generated within a task of the default pool.
+ */
+static size_t matrix_samples(int *src, int *dst, int *back, size_t n,
+    void *context)
+{
+    (void) back;
+    matrix_check *c = context;
+    if (c->batches == 4)
+    {
+        return 0;
+    }
+    c->batches++;
+    recompute_matrix(c);
+    for (size_t i = 0; i < n; ++i)
+    {
+        src[i] = i % 2;
+        dst[i] = (i / 2) % 2;
+    }
+    return n;
+}
+
+static double *serial_matrix(int const *series, size_t l, size_t n,
+    int const *b)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_config serial = inform_config_default();
+    serial.threads = 1;
+    double *mi = inform_mutual_info_matrix_ex(series, l, n, b, NULL, &serial,
+        &err);
+    ASSERT_NOT_NULL(mi);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    return mi;
+}
+
+UNIT(PoolAlloc)
+{
+    inform_error err = INFORM_SUCCESS;
+    inform_pool *pool = inform_pool_alloc(0, &err);
+    ASSERT_NOT_NULL(pool);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_TRUE(inform_pool_size(pool) >= 1);
+    inform_pool_free(pool);
+
+    pool = inform_pool_alloc(3, &err);
+    ASSERT_NOT_NULL(pool);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    // without threading support, every pool has just the calling thread
+    ASSERT_TRUE(inform_pool_size(pool) == 3 || inform_pool_size(pool) == 1);
+    inform_pool_free(pool);
+
+    inform_pool_free(NULL);
+}
+
+UNIT(PoolAllocSharedInvalid)
+{
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_pool_alloc_shared(4, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+}
+
+UNIT(PoolDefault)
+{
+    inform_error err = INFORM_SUCCESS;
+    size_t const l = 40, n = 1000;
+    int *series = inform_random_series(l * n, 3);
+    ASSERT_NOT_NULL(series);
+    int b[40];
+    for (size_t i = 0; i < l; ++i) b[i] = 3;
+
+    size_t const size = inform_pool_size(NULL);
+    ASSERT_TRUE(size >= 1);
+    double *expect = inform_mutual_info_matrix(series, l, n, b, NULL, &err);
+    ASSERT_NOT_NULL(expect);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    inform_pool *pool = inform_pool_alloc(2, &err);
+    ASSERT_NOT_NULL(pool);
+    inform_pool_set_default(pool);
+    ASSERT_EQUAL_U(inform_pool_size(pool), inform_pool_size(NULL));
+    assert_matrix(series, l, n, b, expect, NULL);
+
+    // freeing the default pool restores the library's own
+    inform_pool_free(pool);
+    ASSERT_EQUAL_U(size, inform_pool_size(NULL));
+    assert_matrix(series, l, n, b, expect, NULL);
+
+    free(expect);
+    free(series);
+}
+
+UNIT(PoolShared)
+{
+    inform_error err = INFORM_SUCCESS;
+    size_t const l = 40, n = 1000;
+    int *series = inform_random_series(l * n, 3);
+    ASSERT_NOT_NULL(series);
+    int b[40];
+    for (size_t i = 0; i < l; ++i) b[i] = 3;
+
+    double *expect = inform_mutual_info_matrix(series, l, n, b, NULL, &err);
+    ASSERT_NOT_NULL(expect);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    host_pool host = { .inline_run = true, .n = 0 };
+    inform_config config = inform_config_default();
+    config.pool = inform_pool_alloc_shared(4, host_submit, &host, &err);
+    ASSERT_NOT_NULL(config.pool);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    // the host runs the helpers as they are submitted
+    assert_matrix(series, l, n, b, expect, &config);
+
+    // the host is too busy to run the helpers until the call has returned
+    host.inline_run = false;
+    assert_matrix(series, l, n, b, expect, &config);
+    ASSERT_EQUAL_U(inform_pool_size(config.pool) - 1, host.n);
+    host_drain(&host);
+
+    // at most `threads` of the pool's threads are used
+    config.threads = 2;
+    assert_matrix(series, l, n, b, expect, &config);
+    ASSERT_TRUE(host.n <= 1);
+    host_drain(&host);
+
+    inform_pool_free(config.pool);
+    free(expect);
+    free(series);
+}
+
+UNIT(PoolNested)
+{
+    inform_error err = INFORM_SUCCESS;
+    size_t const l = 24, n = 500;
+    int b[24];
+    int *series = uneven_series(l, n, b);
+    ASSERT_NOT_NULL(series);
+    double *expect = serial_matrix(series, l, n, b);
+
+    inform_pool *pool = inform_pool_alloc(4, &err);
+    ASSERT_NOT_NULL(pool);
+    inform_pool *other = inform_pool_alloc(3, &err);
+    ASSERT_NOT_NULL(other);
+    inform_pool_set_default(pool);
+
+    // the generator runs as a task of the default pool, and calls estimators
+    // on the same pool, on the default pool and on another pool
+    inform_config config = inform_config_default();
+    inform_pool *pools[3] = { pool, NULL, other };
+    for (size_t k = 0; k < 3; ++k)
+    {
+        config.pool = pools[k];
+        matrix_check check = { series, b, l, n, expect, &config, 0, 0, 0 };
+        double const flow = inform_information_flow_generated(matrix_samples,
+            &check, 1, 1, 0, 2, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_FALSE(isnan(flow));
+        ASSERT_EQUAL_U(4, check.calls);
+        ASSERT_EQUAL_U(0, check.failures);
+    }
+
+    // the host calls an estimator on another pool while a call is submitting
+    // helpers to it
+    host_pool host = { .inline_run = true, .hook = recompute_matrix, .n = 0 };
+    config.pool = other;
+    matrix_check check = { series, b, l, n, expect, &config, 0, 0, 0 };
+    host.hook_arg = &check;
+    inform_config hosted = inform_config_default();
+    hosted.pool = inform_pool_alloc_shared(4, host_submit, &host, &err);
+    ASSERT_NOT_NULL(hosted.pool);
+    assert_matrix(series, l, n, b, expect, &hosted);
+    ASSERT_EQUAL_U(inform_pool_size(hosted.pool) - 1, check.calls);
+    ASSERT_EQUAL_U(0, check.failures);
+
+    inform_pool_free(hosted.pool);
+    inform_pool_free(other);
+    inform_pool_free(pool);
+    free(expect);
+    free(series);
+}
+
+#ifdef INFORM_HAVE_PTHREADS
+static void *recompute_matrices(void *arg)
+{
+    matrix_check *c = arg;
+    // a check which starts with a batch to its name recomputes the matrix
+    // within the tasks of an information flow, rather than directly
+    if (c->batches == 0)
+    {
+        for (size_t k = 0; k < 4; ++k) recompute_matrix(c);
+    }
+    else
+    {
+        inform_error err = INFORM_SUCCESS;
+        c->batches = 0;
+        double const flow = inform_information_flow_generated(matrix_samples,
+            c, 1, 1, 0, 2, &err);
+        c->failures += (err != INFORM_SUCCESS || isnan(flow));
+    }
+    return NULL;
+}
+#endif
+
+UNIT(PoolConcurrent)
+{
+#ifdef INFORM_HAVE_PTHREADS
+    inform_error err = INFORM_SUCCESS;
+    size_t const l = 24, n = 500;
+    int b[24];
+    int *series = uneven_series(l, n, b);
+    ASSERT_NOT_NULL(series);
+    double *expect = serial_matrix(series, l, n, b);
+
+    inform_pool *pool = inform_pool_alloc(4, &err);
+    ASSERT_NOT_NULL(pool);
+    inform_pool_set_default(pool);
+
+    // several threads share the pool at once, whether given it explicitly,
+    // by default or with fewer threads, and some while in its tasks
+    inform_config configs[3];
+    for (size_t k = 0; k < 3; ++k) configs[k] = inform_config_default();
+    configs[0].pool = pool;
+    configs[2].pool = pool;
+    configs[2].threads = 2;
+
+    pthread_t threads[6];
+    matrix_check checks[6];
+    for (size_t k = 0; k < 6; ++k)
+    {
+        checks[k] = (matrix_check) {
+            series, b, l, n, expect, configs + k % 3, 0, 0, k / 3
+        };
+        ASSERT_EQUAL(0, pthread_create(threads + k, NULL, recompute_matrices,
+            checks + k));
+    }
+    for (size_t k = 0; k < 6; ++k)
+    {
+        pthread_join(threads[k], NULL);
+        ASSERT_EQUAL_U(4, checks[k].calls);
+        ASSERT_EQUAL_U(0, checks[k].failures);
+    }
+
+    inform_pool_free(pool);
+    free(expect);
+    free(series);
+#endif
+}
+
+BEGIN_SUITE(ThreadPool)
+    ADD_UNIT(PoolAlloc)
+    ADD_UNIT(PoolAllocSharedInvalid)
+    ADD_UNIT(PoolDefault)
+    ADD_UNIT(PoolShared)
+    ADD_UNIT(PoolNested)
+    ADD_UNIT(PoolConcurrent)
+END_SUITE
@@ -2,7 +2,9 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include "util.h"
+#include <inform/active_info.h>
 #include <inform/separable_info.h>
+#include <inform/transfer_entropy.h>
 #include <math.h>
 #include <ginger/unit.h>
 
@@ -344,6 +346,75 @@ UNIT(SeparableInformationMultipleEnsembles)
     }
 }
 
+UNIT(SeparableInformationManySources)
+{
+    size_t const l = 50, n = 3, m = 500, k = 2;
+    int const b = 3;
+    int *srcs = malloc(l * n * m * sizeof(int));
+    int *dest = malloc(n * m * sizeof(int));
+    double *si = malloc(n * (m - k) * sizeof(double));
+    double *expect = malloc(n * (m - k) * sizeof(double));
+    double *te = malloc(n * (m - k) * sizeof(double));
+    ASSERT_NOT_NULL(srcs);
+    ASSERT_NOT_NULL(dest);
+    ASSERT_NOT_NULL(si);
+    ASSERT_NOT_NULL(expect);
+    ASSERT_NOT_NULL(te);
+
+    uint64_t state = 7;
+    for (size_t i = 0; i < l * n * m; ++i)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        srcs[i] = (int) ((state >> 33) % b);
+    }
+    // the destination mostly copies a few of the sources, with some noise
+    for (size_t i = 0; i < n; ++i)
+    {
+        dest[i * m] = 0;
+        for (size_t j = 1; j < m; ++j)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            size_t const v = (state >> 33) % 4;
+            int const noise = (int) ((state >> 40) % 5 == 0);
+            dest[i * m + j] = (srcs[(v * n + i) * m + j - 1] + noise) % b;
+        }
+    }
+
+    inform_error err = INFORM_SUCCESS;
+    double expected = inform_active_info(dest, n, m, b, k, &err);
+    ASSERT_FALSE(inform_failed(&err));
+    inform_local_active_info(dest, n, m, b, k, expect, &err);
+    ASSERT_FALSE(inform_failed(&err));
+    for (size_t i = 0; i < l; ++i)
+    {
+        expected += inform_transfer_entropy(srcs + i * n * m, dest, NULL, 0,
+            n, m, b, k, &err);
+        ASSERT_FALSE(inform_failed(&err));
+        inform_local_transfer_entropy(srcs + i * n * m, dest, NULL, 0, n, m,
+            b, k, te, &err);
+        ASSERT_FALSE(inform_failed(&err));
+        for (size_t j = 0; j < n * (m - k); ++j) expect[j] += te[j];
+    }
+
+    ASSERT_DBL_NEAR_TOL(expected,
+        inform_separable_info(srcs, dest, l, n, m, b, k, &err), 1e-9);
+    ASSERT_FALSE(inform_failed(&err));
+
+    ASSERT_NOT_NULL(inform_local_separable_info(srcs, dest, l, n, m, b, k,
+        si, &err));
+    ASSERT_FALSE(inform_failed(&err));
+    for (size_t j = 0; j < n * (m - k); ++j)
+    {
+        ASSERT_DBL_NEAR_TOL(expect[j], si[j], 1e-9);
+    }
+
+    free(te);
+    free(expect);
+    free(si);
+    free(dest);
+    free(srcs);
+}
+
 UNIT(LocalSeparableInformationNULLSeries)
 {
     double si[8], *got;
@@ -734,6 +805,7 @@ BEGIN_SUITE(SeparableInformation)
     ADD_UNIT(SeparableInformationMultipleSources)
     ADD_UNIT(SeparableInformationSingleEnsemble)
     ADD_UNIT(SeparableInformationMultipleEnsembles)
+    ADD_UNIT(SeparableInformationManySources)
 
     ADD_UNIT(LocalSeparableInformationNULLSeries)
     ADD_UNIT(LocalSeparableInformationNoSources)
@@ -499,11 +499,67 @@ UNIT(ShannonUniCrossEntropyDefined)
     inform_dist_free(p);
 }
 
+UNIT(ShannonUniEstimatorsInvalid)
+{
+    ASSERT_NAN(inform_shannon_entropy_est(NULL, 2, INFORM_MILLER_MADOW));
+
+    inform_dist *dist = inform_dist_alloc(4);
+    ASSERT_NAN(inform_shannon_entropy_est(dist, 2, INFORM_NSB));
+    inform_dist_fill(dist, 1, 2, 3, 4);
+    ASSERT_NAN(inform_shannon_entropy_est(dist, 2, (inform_estimator) 17));
+    inform_dist_free(dist);
+}
+
+UNIT(ShannonUniEstimators)
+{
+    inform_dist *dist = inform_dist_alloc(4);
+    inform_dist_fill(dist, 25, 25, 25, 25);
+    ASSERT_DBL_NEAR_TOL(inform_shannon_entropy(dist, 2),
+        inform_shannon_entropy_est(dist, 2, INFORM_PLUGIN), 1e-12);
+    ASSERT_DBL_NEAR_TOL(2.0 + 3.0 / (200.0 * log(2.0)),
+        inform_shannon_entropy_est(dist, 2, INFORM_MILLER_MADOW), 1e-12);
+    ASSERT_DBL_NEAR_TOL(2.058477,
+        inform_shannon_entropy_est(dist, 2, INFORM_GRASSBERGER), 1e-6);
+    ASSERT_DBL_NEAR_TOL(2.0, inform_shannon_entropy_est(dist, 2, INFORM_NSB), 2e-2);
+    ASSERT_DBL_NEAR_TOL(inform_shannon_entropy_est(dist, 2, INFORM_GRASSBERGER) * log(2) / log(3),
+        inform_shannon_entropy_est(dist, 3, INFORM_GRASSBERGER), 1e-12);
+
+    inform_dist_fill(dist, 7, 0, 0, 0);
+    ASSERT_DBL_NEAR_TOL(0.0, inform_shannon_entropy_est(dist, 2, INFORM_MILLER_MADOW), 1e-12);
+    inform_dist_free(dist);
+}
+
+UNIT(ShannonUniEstimatorsReduceBias)
+{
+    // 300 samples of a uniform distribution over 1000 states, whose entropy
+    // the plug-in estimate badly underestimates
+    size_t const K = 1000, N = 300;
+    inform_dist *dist = inform_dist_alloc(K);
+    uint64_t state = 1;
+    for (size_t i = 0; i < N; ++i)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        inform_dist_tick(dist, (state >> 33) % K);
+    }
+    double const H = log2((double) K);
+    double const plugin = inform_shannon_entropy(dist, 2);
+    double const mm = inform_shannon_entropy_est(dist, 2, INFORM_MILLER_MADOW);
+    double const g = inform_shannon_entropy_est(dist, 2, INFORM_GRASSBERGER);
+    double const nsb = inform_shannon_entropy_est(dist, 2, INFORM_NSB);
+    ASSERT_TRUE(plugin < mm && mm < g && g < nsb);
+    ASSERT_TRUE(nsb <= H + 1e-9);
+    ASSERT_DBL_NEAR_TOL(H, nsb, 0.2);
+    inform_dist_free(dist);
+}
+
 BEGIN_SUITE(ShannonUni)
     ADD_UNIT(ShannonUniInvalidDistribution)
     ADD_UNIT(ShannonUniDeltaFunction)
     ADD_UNIT(ShannonUniUniform)
     ADD_UNIT(ShannonUniNonUniform)
+    ADD_UNIT(ShannonUniEstimatorsInvalid)
+    ADD_UNIT(ShannonUniEstimators)
+    ADD_UNIT(ShannonUniEstimatorsReduceBias)
 
     ADD_UNIT(ShannonUniMutualInformationIndependent)
     ADD_UNIT(ShannonUniMutualInformationDependent)
@@ -3,6 +3,7 @@
 // license that can be found in the LICENSE file.
 #include "util.h"
 #include <inform/transfer_entropy.h>
+#include <inform/utilities/random.h>
 #include <math.h>
 #include <ginger/unit.h>
 
@@ -348,6 +349,65 @@ UNIT(CompleteTransferEntropy)
     }
 }
 
+UNIT(TransferEntropyLagsInvalidLags)
+{
+    int const series[] = {1,1,0,0,1,0,0,1};
+    size_t const lags[] = {1, 0, 2};
+    double te[3];
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_transfer_entropy_lags(series, series, NULL, 0, 1, 8, 2, 2, NULL, 3, te, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_transfer_entropy_lags(series, series, NULL, 0, 1, 8, 2, 2, lags, 0, te, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_transfer_entropy_lags(series, series, NULL, 0, 1, 8, 2, 2, lags, 3, te, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_transfer_entropy_lags(series, series, NULL, 0, 1, 8, 2, 2, (size_t[]){8}, 1, te, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+}
+
+UNIT(TransferEntropyLags)
+{
+    int const xs[20] = {0,1,1,1,1,0,0,0,0,1, 1,1,0,0,1,0,1,1,0,0};
+    int const ys[20] = {0,0,1,1,1,1,0,0,0,0, 1,0,1,1,0,0,1,0,1,1};
+    int const ws[20] = {1,0,1,0,1,1,1,1,1,0, 0,1,1,0,0,1,0,1,1,0};
+    {
+        double te[1];
+        ASSERT_NOT_NULL(inform_transfer_entropy_lags(xs, ys, NULL, 0, 2, 10, 2, 2, (size_t[]){1}, 1, te, NULL));
+        ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(xs, ys, NULL, 0, 2, 10, 2, 2, NULL), te[0], 1e-6);
+    }
+    {
+        inform_error err = INFORM_SUCCESS;
+        double *te = inform_transfer_entropy_lags(xs, ys, NULL, 0, 1, 20, 2, 2,
+            (size_t[]){1, 2, 3, 4}, 4, NULL, &err);
+        ASSERT_NOT_NULL(te);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_DBL_NEAR_TOL(0.655639, te[0], 1e-6);
+        ASSERT_DBL_NEAR_TOL(0.483459, te[1], 1e-6);
+        ASSERT_DBL_NEAR_TOL(0.077820, te[2], 1e-6);
+        ASSERT_DBL_NEAR_TOL(0.311278, te[3], 1e-6);
+        free(te);
+    }
+    {
+        double te[3];
+        ASSERT_NOT_NULL(inform_transfer_entropy_lags(xs, ys, NULL, 0, 2, 10, 2, 1, (size_t[]){3, 1, 2}, 3, te, NULL));
+        ASSERT_DBL_NEAR_TOL(0.099564, te[0], 1e-6);
+        ASSERT_DBL_NEAR_TOL(0.046787, te[1], 1e-6);
+        ASSERT_DBL_NEAR_TOL(0.660365, te[2], 1e-6);
+    }
+    {
+        double te[2];
+        ASSERT_NOT_NULL(inform_transfer_entropy_lags(xs, ys, ws, 1, 2, 10, 2, 2, (size_t[]){1, 2}, 2, te, NULL));
+        ASSERT_DBL_NEAR_TOL(0.422180, te[0], 1e-6);
+        ASSERT_DBL_NEAR_TOL(0.469361, te[1], 1e-6);
+    }
+}
+
 UNIT(LocalTransferEntropyNULLSeries)
 {
     double te[8];
@@ -697,6 +757,297 @@ UNIT(LocalTransferEntropyEnsemble_Base2)
     }
 }
 
+UNIT(TransferEntropyEmbedInvalidEmbedding)
+{
+    int const series[] = {1,1,0,0,1,0,0,1};
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_transfer_entropy_embed(series, series, NULL, 0, 1, 8, 2, 2, 1, 0, 1, 1, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_transfer_entropy_embed(series, series, NULL, 0, 1, 8, 2, 2, 0, 1, 1, 1, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_transfer_entropy_embed(series, series, NULL, 0, 1, 8, 2, 2, 1, 1, 1, 0, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_transfer_entropy_embed(series, series, NULL, 0, 1, 8, 2, 2, 7, 1, 1, 1, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NAN(inform_transfer_entropy_embed(series, series, NULL, 0, 1, 8, 2, 2, 1, 1, 2, 8, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+}
+
+UNIT(TransferEntropyEmbedDefaultsMatch)
+{
+    int const xs[20] = {0,1,1,1,1,0,0,0,0,1, 1,1,0,0,1,0,1,1,0,0};
+    int const ys[20] = {0,0,1,1,1,1,0,0,0,0, 1,0,1,1,0,0,1,0,1,1};
+    for (size_t k = 1; k < 4; ++k)
+    {
+        ASSERT_DBL_NEAR_TOL(
+            inform_transfer_entropy(xs, ys, NULL, 0, 2, 10, 2, k, NULL),
+            inform_transfer_entropy_embed(xs, ys, NULL, 0, 2, 10, 2, k, 1, 1, 1, 1, NULL),
+            1e-6);
+    }
+}
+
+UNIT(TransferEntropyEmbed)
+{
+    int const xs[20] = {0,1,1,1,1,0,0,0,0,1, 1,1,0,0,1,0,1,1,0,0};
+    int const ys[20] = {0,0,1,1,1,1,0,0,0,0, 1,0,1,1,0,0,1,0,1,1};
+    int const ws[20] = {1,0,1,0,1,1,1,1,1,0, 0,1,1,0,0,1,0,1,1,0};
+
+    ASSERT_DBL_NEAR_TOL(0.872750,
+        inform_transfer_entropy_embed(xs, ys, NULL, 0, 1, 20, 2, 2, 1, 2, 1, 1, NULL), 1e-6);
+    ASSERT_DBL_NEAR_TOL(0.952820,
+        inform_transfer_entropy_embed(xs, ys, NULL, 0, 2, 10, 2, 2, 1, 2, 1, 1, NULL), 1e-6);
+
+    ASSERT_DBL_NEAR_TOL(0.349319,
+        inform_transfer_entropy_embed(xs, ys, NULL, 0, 1, 20, 2, 1, 1, 1, 1, 2, NULL), 1e-6);
+    ASSERT_DBL_NEAR_TOL(0.507856,
+        inform_transfer_entropy_embed(xs, ys, NULL, 0, 2, 10, 2, 1, 1, 1, 1, 2, NULL), 1e-6);
+
+    ASSERT_DBL_NEAR_TOL(0.298842,
+        inform_transfer_entropy_embed(xs, ys, NULL, 0, 1, 20, 2, 2, 2, 1, 1, 1, NULL), 1e-6);
+    ASSERT_DBL_NEAR_TOL(0.301826,
+        inform_transfer_entropy_embed(xs, ys, NULL, 0, 2, 10, 2, 2, 2, 1, 1, 1, NULL), 1e-6);
+
+    ASSERT_DBL_NEAR_TOL(0.530639,
+        inform_transfer_entropy_embed(xs, ys, NULL, 0, 1, 20, 2, 1, 1, 2, 2, 2, NULL), 1e-6);
+    ASSERT_DBL_NEAR_TOL(0.792481,
+        inform_transfer_entropy_embed(xs, ys, NULL, 0, 2, 10, 2, 1, 1, 2, 2, 2, NULL), 1e-6);
+
+    ASSERT_DBL_NEAR_TOL(0.389098,
+        inform_transfer_entropy_embed(xs, ys, NULL, 0, 1, 20, 2, 2, 2, 2, 1, 3, NULL), 1e-6);
+    ASSERT_DBL_NEAR_TOL(0.562907,
+        inform_transfer_entropy_embed(xs, ys, NULL, 0, 2, 10, 2, 2, 2, 2, 1, 3, NULL), 1e-6);
+
+    ASSERT_DBL_NEAR_TOL(0.594361,
+        inform_transfer_entropy_embed(xs, ys, ws, 1, 2, 10, 2, 2, 1, 2, 1, 1, NULL), 1e-6);
+    ASSERT_DBL_NEAR_TOL(0.547180,
+        inform_transfer_entropy_embed(xs, ys, ws, 1, 2, 10, 2, 1, 1, 1, 1, 2, NULL), 1e-6);
+}
+
+UNIT(LocalTransferEntropyEmbed)
+{
+    int const xs[20] = {0,1,1,1,1,0,0,0,0,1, 1,1,0,0,1,0,1,1,0,0};
+    int const ys[20] = {0,0,1,1,1,1,0,0,0,0, 1,0,1,1,0,0,1,0,1,1};
+    int const ws[20] = {1,0,1,0,1,1,1,1,1,0, 0,1,1,0,0,1,0,1,1,0};
+    {
+        double te[16];
+        ASSERT_NOT_NULL(inform_local_transfer_entropy_embed(xs, ys, NULL, 0, 2, 10, 2, 2, 1, 2, 1, 1, te, NULL));
+        ASSERT_DBL_NEAR_TOL(0.952820, AVERAGE(te), 1e-6);
+        ASSERT_NOT_NULL(inform_local_transfer_entropy_embed(xs, ys, ws, 1, 2, 10, 2, 2, 1, 2, 1, 1, te, NULL));
+        ASSERT_DBL_NEAR_TOL(0.594361, AVERAGE(te), 1e-6);
+    }
+    {
+        double te[12];
+        ASSERT_NOT_NULL(inform_local_transfer_entropy_embed(xs, ys, NULL, 0, 2, 10, 2, 2, 2, 2, 1, 3, te, NULL));
+        ASSERT_DBL_NEAR_TOL(0.562907, AVERAGE(te), 1e-6);
+    }
+}
+
+UNIT(LocalTransferEntropySourcesInvalid)
+{
+    int const series[] = {1,1,0,0,1,0,0,1, 1,0,1,0,2,0,0,1};
+    double te[12];
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_local_transfer_entropy_sources(series, series, NULL, 0, 0, 1, 8, 2, 2, te, &err));
+    ASSERT_EQUAL(INFORM_ENOSOURCES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_local_transfer_entropy_sources(NULL, series, NULL, 1, 0, 1, 8, 2, 2, te, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_local_transfer_entropy_sources(series, series, NULL, 1, 0, 1, 8, 2, 8, te, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_local_transfer_entropy_sources(series, series, NULL, 2, 0, 1, 8, 2, 2, te, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+}
+
+UNIT(LocalTransferEntropySources)
+{
+    int const xs[60] = {
+        0,1,1,1,1,0,0,0,0,1, 1,1,0,0,1,0,1,1,0,0,
+        1,0,1,0,1,1,1,1,1,0, 0,1,1,0,0,1,0,1,1,0,
+        0,0,0,1,1,1,0,1,0,0, 1,0,1,0,1,0,0,0,1,0,
+    };
+    int const ys[20] = {0,0,1,1,1,1,0,0,0,0, 1,0,1,1,0,0,1,0,1,1};
+    int const ws[20] = {1,1,0,1,0,1,1,0,0,1, 0,0,1,1,1,0,1,0,0,1};
+    double expect[16];
+    {
+        double te[3 * 16];
+        ASSERT_NOT_NULL(inform_local_transfer_entropy_sources(xs, ys, NULL, 3, 0, 2, 10, 2, 2, te, NULL));
+        for (size_t i = 0; i < 3; ++i)
+        {
+            inform_local_transfer_entropy(xs + 20*i, ys, NULL, 0, 2, 10, 2, 2, expect, NULL);
+            for (size_t j = 0; j < 16; ++j)
+            {
+                ASSERT_DBL_NEAR_TOL(expect[j], te[16*i + j], 1e-6);
+            }
+        }
+    }
+    {
+        inform_error err = INFORM_SUCCESS;
+        double *te = inform_local_transfer_entropy_sources(xs, ys, ws, 3, 1, 2, 10, 2, 2, NULL, &err);
+        ASSERT_NOT_NULL(te);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        for (size_t i = 0; i < 3; ++i)
+        {
+            inform_local_transfer_entropy(xs + 20*i, ys, ws, 1, 2, 10, 2, 2, expect, NULL);
+            for (size_t j = 0; j < 16; ++j)
+            {
+                ASSERT_DBL_NEAR_TOL(expect[j], te[16*i + j], 1e-6);
+            }
+        }
+        free(te);
+    }
+}
+
+UNIT(TransferEntropyView)
+{
+    inform_error err = INFORM_SUCCESS;
+    size_t const n = 3, m = 12, nodes = 4;
+    // an initial condition by time by node array, as exported in C order
+    int data[3 * 12 * 4];
+    for (size_t i = 0; i < n * m * nodes; ++i)
+    {
+        data[i] = (int) ((i * 7 + i / 5 + (i * i) / 11) % 2);
+    }
+    int src[36], dst[36], back[72];
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t t = 0; t < m; ++t)
+        {
+            int const *sample = data + nodes * (t + m * i);
+            src[t + m * i] = sample[0];
+            dst[t + m * i] = sample[1];
+            back[t + m * i] = sample[2];
+            back[t + m * (i + n)] = sample[3];
+        }
+    }
+    inform_view const x = inform_view_strided(data, nodes, m * nodes, 1);
+    inform_view const y = inform_view_strided(data + 1, nodes, m * nodes, 1);
+    inform_view const z = inform_view_strided(data + 2, nodes, m * nodes, 1);
+
+    for (size_t l = 0; l <= 2; ++l)
+    {
+        double const expect = inform_transfer_entropy(src, dst, back, l, n, m, 2, 2, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_DBL_NEAR_TOL(expect, inform_transfer_entropy_view(x, y, z, l, n, m, 2, 2, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+        double local[30], local_view[30];
+        ASSERT_NOT_NULL(inform_local_transfer_entropy(src, dst, back, l, n, m, 2, 2, local, &err));
+        ASSERT_NOT_NULL(inform_local_transfer_entropy_view(x, y, z, l, n, m, 2, 2, local_view, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        for (size_t i = 0; i < 30; ++i)
+        {
+            ASSERT_DBL_NEAR_TOL(local[i], local_view[i], 1e-12);
+        }
+    }
+
+    // reading the destination backwards in time
+    int reversed[36];
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t t = 0; t < m; ++t)
+        {
+            reversed[t + m * i] = dst[(m - 1 - t) + m * i];
+        }
+    }
+    inform_view const w = inform_view_strided(dst + m - 1, -1, m, 0);
+    inform_view const none = inform_view_strided(NULL, 1, m, n * m);
+    ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(src, reversed, NULL, 0, n, m, 2, 2, &err),
+        inform_transfer_entropy_view(x, w, none, 0, n, m, 2, 2, &err), 1e-12);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    ASSERT_NAN(inform_transfer_entropy_view(x, y, none, 1, n, m, 2, 2, &err));
+    ASSERT_EQUAL(INFORM_ENOSOURCES, err);
+}
+
+UNIT(TransferEntropyEstimators)
+{
+    inform_error err = INFORM_SUCCESS;
+    int const xs[10] = {0,1,1,1,1,0,0,0,0,1};
+    int const ys[10] = {1,0,1,1,1,1,0,0,0,1};
+    for (int est = INFORM_PLUGIN; est <= INFORM_NSB; ++est)
+    {
+        // with an arbitrary estimator the transfer entropy is assembled from
+        // entropies, which for the plug-in estimator agree with the direct sum
+        double const te = inform_transfer_entropy_est(xs, ys, NULL, 0, 1, 10, 2,
+            2, (inform_estimator) est, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_FALSE(isnan(te));
+    }
+    ASSERT_DBL_NEAR_TOL(inform_transfer_entropy(xs, ys, NULL, 0, 1, 10, 2, 2, &err),
+        inform_transfer_entropy_est(xs, ys, NULL, 0, 1, 10, 2, 2, INFORM_PLUGIN, &err),
+        1e-12);
+
+    ASSERT_NAN(inform_transfer_entropy_est(xs, ys, NULL, 0, 1, 10, 2, 2,
+        (inform_estimator) 4, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+}
+
+UNIT(TransferEntropyConfig)
+{
+    inform_error err = INFORM_SUCCESS;
+    int *series = inform_random_series(6000, 3);
+    ASSERT_NOT_NULL(series);
+    int const *src = series, *dst = series + 2000, *back = series + 4000;
+
+    inform_config sparse = inform_config_default();
+    sparse.histogram = INFORM_HISTOGRAM_SPARSE;
+    for (int est = INFORM_PLUGIN; est <= INFORM_GRASSBERGER; ++est)
+    {
+        double const expect = inform_transfer_entropy_est(src, dst, NULL, 0,
+            4, 500, 3, 2, (inform_estimator) est, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_DBL_NEAR_TOL(expect, inform_transfer_entropy_ex(src, dst,
+            NULL, 0, 4, 500, 3, 2, (inform_estimator) est, NULL, &err), 1e-12);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_DBL_NEAR_TOL(expect, inform_transfer_entropy_ex(src, dst,
+            NULL, 0, 4, 500, 3, 2, (inform_estimator) est, &sparse, &err),
+            1e-10);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+    ASSERT_NAN(inform_transfer_entropy_ex(src, dst, NULL, 0, 4, 500, 3, 2,
+        INFORM_NSB, &sparse, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    // with a background, the dense histograms need 140KB, the sparse ones 80KB
+    err = INFORM_SUCCESS;
+    double const expect = inform_transfer_entropy(src, dst, back, 1,
+        1, 2000, 3, 6, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    inform_config budget = inform_config_default();
+    budget.memory = 100000;
+    ASSERT_DBL_NEAR_TOL(expect, inform_transfer_entropy_ex(src, dst,
+        back, 1, 1, 2000, 3, 6, INFORM_PLUGIN, &budget, &err),
+        1e-10);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    budget.histogram = INFORM_HISTOGRAM_DENSE;
+    ASSERT_NAN(inform_transfer_entropy_ex(src, dst, back, 1, 1, 2000, 3, 6,
+        INFORM_PLUGIN, &budget, &err));
+    ASSERT_EQUAL(INFORM_EBUDGET, err);
+
+    err = INFORM_SUCCESS;
+    inform_config trusting = inform_config_default();
+    trusting.validation = INFORM_VALIDATE_ARGS;
+    ASSERT_DBL_NEAR_TOL(expect, inform_transfer_entropy_ex(src, dst,
+        back, 1, 1, 2000, 3, 6, INFORM_PLUGIN, &trusting, &err),
+        1e-12);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    free(series);
+}
+
 BEGIN_SUITE(TransferEntropy)
     ADD_UNIT(TransferEntropyNULLSeries)
     ADD_UNIT(TransferEntropyNoInits)
@@ -710,6 +1061,11 @@ BEGIN_SUITE(TransferEntropy)
     ADD_UNIT(TransferEntropySingleSeries_Base2)
     ADD_UNIT(TransferEntropyEnsemble_Base2)
     ADD_UNIT(CompleteTransferEntropy)
+    ADD_UNIT(TransferEntropyEmbedInvalidEmbedding)
+    ADD_UNIT(TransferEntropyEmbedDefaultsMatch)
+    ADD_UNIT(TransferEntropyEmbed)
+    ADD_UNIT(TransferEntropyLagsInvalidLags)
+    ADD_UNIT(TransferEntropyLags)
 
     ADD_UNIT(LocalTransferEntropyNULLSeries)
     ADD_UNIT(LocalTransferEntropyNoInits)
@@ -724,4 +1080,10 @@ BEGIN_SUITE(TransferEntropy)
     ADD_UNIT(LocalTransferEntropySingleSeries_Base2)
     ADD_UNIT(LocalTransferEntropyEnsemble_Base2)
     ADD_UNIT(LocalCompleteTransferEntropy)
+    ADD_UNIT(LocalTransferEntropyEmbed)
+    ADD_UNIT(LocalTransferEntropySourcesInvalid)
+    ADD_UNIT(LocalTransferEntropySources)
+    ADD_UNIT(TransferEntropyView)
+    ADD_UNIT(TransferEntropyEstimators)
+    ADD_UNIT(TransferEntropyConfig)
 END_SUITE
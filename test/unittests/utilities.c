@@ -2,6 +2,7 @@
 // Use of this source code is governed by a MIT
 // license that can be found in the LICENSE file.
 #include <float.h>
+#include <limits.h>
 #include <inform/dist.h>
 #include <inform/utilities.h>
 #include <ginger/unit.h>
@@ -304,6 +305,308 @@ UNIT(BinBoundsAll)
     }
 }
 
+UNIT(BinRangeInvalid)
+{
+    inform_error err = INFORM_SUCCESS;
+    double series[6] = {1,2,3,4,5,6};
+    int binned[6];
+
+    ASSERT_DBL_NEAR(0.0, inform_bin_range(NULL, 6, 1, 6, 2, binned, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR(0.0, inform_bin_range(series, 0, 1, 6, 2, binned, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR(0.0, inform_bin_range(series, 6, 1, 6, 1, binned, &err));
+    ASSERT_EQUAL(INFORM_EBIN, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR(0.0, inform_bin_range(series, 6, 6, 1, 2, binned, &err));
+    ASSERT_EQUAL(INFORM_EBIN, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR(0.0, inform_bin_range(series, 6, 1, 6, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_DBL_NEAR(1.5, inform_bin_range(series, 6, 2, 5, 2, binned, &err));
+    ASSERT_EQUAL(INFORM_EBIN, err);
+}
+
+UNIT(BinRange)
+{
+    inform_error err = INFORM_SUCCESS;
+    double series[6] = {1,2,3,4,5,6};
+    int binned[6], expect[6];
+
+    for (int b = 2; b <= 6; ++b)
+    {
+        double step = inform_bin(series, 6, b, expect, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_DBL_NEAR(step, inform_bin_range(series, 6, 1, 6, b, binned, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        for (size_t i = 0; i < 6; ++i)
+        {
+            ASSERT_EQUAL(expect[i], binned[i]);
+        }
+    }
+
+    ASSERT_DBL_NEAR(2.5, inform_bin_range(series, 6, 1, 11, 4, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    int wide[6] = {0,0,0,1,1,2};
+    for (size_t i = 0; i < 6; ++i)
+    {
+        ASSERT_EQUAL(wide[i], binned[i]);
+    }
+}
+
+UNIT(BinBoundsMany)
+{
+    inform_error err = INFORM_SUCCESS;
+    double bounds[40];
+    for (size_t k = 0; k < 40; ++k)
+    {
+        bounds[k] = 0.5 * (double) k;
+    }
+    double series[10000];
+    int binned[10000];
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        series[i] = 0.25 * (double) (i % 90) - 1.0;
+    }
+    for (size_t m = 1; m <= 40; ++m)
+    {
+        int b = inform_bin_bounds(series, 10000, bounds, m, binned, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        int max = 0;
+        for (size_t i = 0; i < 10000; ++i)
+        {
+            int expect = (int) m;
+            for (size_t k = 0; k < m; ++k)
+            {
+                if (series[i] < bounds[k])
+                {
+                    expect = (int) k;
+                    break;
+                }
+            }
+            ASSERT_EQUAL(expect, binned[i]);
+            max = (expect > max) ? expect : max;
+        }
+        ASSERT_EQUAL(max + 1, b);
+    }
+}
+
+UNIT(BinBoundsUnsorted)
+{
+    inform_error err = INFORM_SUCCESS;
+    double series[6] = {1,2,3,4,5,6};
+    int binned[6];
+    int expect[6] = {0,0,0,1,1,3};
+    ASSERT_EQUAL(4, inform_bin_bounds(series, 6, (double[]){3.5, 6, 5}, 3, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        ASSERT_EQUAL(expect[i], binned[i]);
+    }
+}
+
+UNIT(SketchInvalid)
+{
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_sketch_alloc(7, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    inform_sketch *sketch = inform_sketch_alloc(8, &err);
+    ASSERT_NOT_NULL(sketch);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    ASSERT_NULL(inform_sketch_bounds(sketch, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+
+    err = INFORM_SUCCESS;
+    inform_sketch_add(sketch, NULL, 3, &err);
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    inform_sketch_add(sketch, (double[]){1,2,3}, 3, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_NULL(inform_sketch_bounds(sketch, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBIN, err);
+
+    inform_sketch_free(sketch);
+}
+
+UNIT(SketchSmallIsExact)
+{
+    inform_error err = INFORM_SUCCESS;
+    double series[100];
+    for (size_t i = 0; i < 100; ++i)
+    {
+        series[i] = (double) ((i * 37) % 100);
+    }
+    inform_sketch *sketch = inform_sketch_alloc(200, &err);
+    ASSERT_NOT_NULL(sketch);
+    inform_sketch_add(sketch, series, 100, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    double bounds[3];
+    ASSERT_EQUAL_P(bounds, inform_sketch_bounds(sketch, 4, bounds, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_DBL_NEAR(25.0, bounds[0]);
+    ASSERT_DBL_NEAR(50.0, bounds[1]);
+    ASSERT_DBL_NEAR(75.0, bounds[2]);
+
+    inform_sketch_free(sketch);
+}
+
+UNIT(SketchLarge)
+{
+    inform_error err = INFORM_SUCCESS;
+    size_t const n = 200000;
+    double *series = malloc(n * sizeof(double));
+    ASSERT_NOT_NULL(series);
+    for (size_t i = 0; i < n; ++i)
+    {
+        series[i] = (double) ((i * 7919) % n);
+    }
+
+    inform_sketch *whole = inform_sketch_alloc(200, &err);
+    inform_sketch *parts = inform_sketch_alloc(200, &err);
+    ASSERT_NOT_NULL(whole);
+    ASSERT_NOT_NULL(parts);
+    inform_sketch_add(whole, series, n, &err);
+    for (size_t i = 0; i < n; i += 1013)
+    {
+        inform_sketch_add(parts, series + i, (n - i < 1013) ? n - i : 1013, &err);
+    }
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    double *bounds = inform_sketch_bounds(whole, 10, NULL, &err);
+    double *chunked = inform_sketch_bounds(parts, 10, NULL, &err);
+    ASSERT_NOT_NULL(bounds);
+    ASSERT_NOT_NULL(chunked);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (int j = 1; j < 10; ++j)
+    {
+        ASSERT_DBL_NEAR_TOL(20000.0 * j, bounds[j - 1], 0.02 * n);
+        ASSERT_DBL_NEAR(bounds[j - 1], chunked[j - 1]);
+    }
+
+    free(chunked);
+    free(bounds);
+    inform_sketch_free(parts);
+    inform_sketch_free(whole);
+    free(series);
+}
+
+UNIT(QuantileBoundsInvalid)
+{
+    inform_error err = INFORM_SUCCESS;
+    double series[4] = {1,2,3,4};
+    ASSERT_NULL(inform_quantile_bounds(NULL, 4, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_quantile_bounds(series, 0, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_quantile_bounds(series, 4, 1, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBIN, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_bin_quantiles(series, 4, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_bin_quantiles_approx(series, 4, 2, 4, (int[4]){0}, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+}
+
+UNIT(QuantileBounds)
+{
+    inform_error err = INFORM_SUCCESS;
+    double series[10] = {9,3,7,1,5,0,8,2,6,4};
+    double *bounds = inform_quantile_bounds(series, 10, 4, NULL, &err);
+    ASSERT_NOT_NULL(bounds);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_DBL_NEAR(3.0, bounds[0]);
+    ASSERT_DBL_NEAR(5.0, bounds[1]);
+    ASSERT_DBL_NEAR(8.0, bounds[2]);
+    free(bounds);
+
+    double repeated[6] = {2,0,1,2,0,1};
+    double fine[5];
+    ASSERT_EQUAL_P(fine, inform_quantile_bounds(repeated, 6, 6, fine, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    double expect[5] = {0,1,1,2,2};
+    for (size_t i = 0; i < 5; ++i)
+    {
+        ASSERT_DBL_NEAR(expect[i], fine[i]);
+    }
+}
+
+UNIT(BinQuantiles)
+{
+    inform_error err = INFORM_SUCCESS;
+    double series[8] = {0.5,-1,3,2.5,10,7,-3,4};
+    int binned[8];
+    int expect[8] = {1,0,2,1,3,3,0,2};
+    ASSERT_EQUAL(4, inform_bin_quantiles(series, 8, 4, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        ASSERT_EQUAL(expect[i], binned[i]);
+    }
+
+    ASSERT_EQUAL(4, inform_bin_quantiles_approx(series, 8, 4, 8, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        ASSERT_EQUAL(expect[i], binned[i]);
+    }
+}
+
+UNIT(BinQuantilesLarge)
+{
+    inform_error err = INFORM_SUCCESS;
+    size_t const n = 300000;
+    double *series = malloc(n * sizeof(double));
+    int *binned = malloc(n * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    ASSERT_NOT_NULL(binned);
+    for (size_t i = 0; i < n; ++i)
+    {
+        series[i] = (double) ((i * 7919) % n) / 3.0;
+    }
+
+    ASSERT_EQUAL(16, inform_bin_quantiles(series, n, 16, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < n; ++i)
+    {
+        ASSERT_EQUAL((int) (((i * 7919) % n) * 16 / n), binned[i]);
+    }
+
+    ASSERT_EQUAL(16, inform_bin_quantiles_approx(series, n, 16, 200, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    size_t counts[16] = {0};
+    for (size_t i = 0; i < n; ++i)
+    {
+        counts[binned[i]] += 1;
+    }
+    for (size_t j = 0; j < 16; ++j)
+    {
+        ASSERT_DBL_NEAR_TOL(n / 16.0, (double) counts[j], 0.03 * n);
+    }
+
+    free(binned);
+    free(series);
+}
+
 UNIT(CoalesceNullSeries)
 {
     inform_error err = INFORM_SUCCESS;
@@ -367,6 +670,92 @@ UNIT(CoalesceNoGaps)
     }
 }
 
+UNIT(CoalesceSparse)
+{
+    inform_error err = INFORM_SUCCESS;
+    int series[8] = {INT_MAX,-7,1000000,INT_MIN,-7,1000000,INT_MAX,0};
+    int binned[8];
+    int expect[8] = {4,1,3,0,1,3,4,2};
+    ASSERT_EQUAL(5, inform_coalesce(series, 8, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        ASSERT_EQUAL(expect[i], binned[i]);
+    }
+}
+
+UNIT(CoalesceSparseMany)
+{
+    inform_error err = INFORM_SUCCESS;
+    int series[1000], binned[1000];
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        series[i] = 1000003 * (int)((i * 7) % 500) - 250000000;
+    }
+    ASSERT_EQUAL(500, inform_coalesce(series, 1000, binned, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQUAL((int)((i * 7) % 500), binned[i]);
+    }
+}
+
+UNIT(CoalesceColumnsInvalid)
+{
+    inform_error err = INFORM_SUCCESS;
+    int series[4] = {1,2,3,4};
+    int coal[4];
+    ASSERT_NULL(inform_coalesce_columns(NULL, 2, 2, coal, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_coalesce_columns(series, 0, 2, coal, NULL, &err));
+    ASSERT_EQUAL(INFORM_ENOSOURCES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_coalesce_columns(series, 2, 0, coal, NULL, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_coalesce_columns(series, 2, 2, NULL, NULL, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+}
+
+UNIT(CoalesceColumns)
+{
+    inform_error err = INFORM_SUCCESS;
+    int series[18] = {
+        0,2,2,1,2,3,
+        1,3,3,2,3,4,
+        5,-1,5,5,-1,5,
+    };
+    int coal[18];
+    int expect[18] = {
+        0,2,2,1,2,3,
+        0,2,2,1,2,3,
+        1,0,1,1,0,1,
+    };
+    int *b = inform_coalesce_columns(series, 3, 6, coal, NULL, &err);
+    ASSERT_NOT_NULL(b);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    ASSERT_EQUAL(4, b[0]);
+    ASSERT_EQUAL(4, b[1]);
+    ASSERT_EQUAL(2, b[2]);
+    for (size_t i = 0; i < 18; ++i)
+    {
+        ASSERT_EQUAL(expect[i], coal[i]);
+    }
+
+    int bases[3];
+    ASSERT_EQUAL_P(bases, inform_coalesce_columns(series, 3, 6, coal, bases, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        ASSERT_EQUAL(b[i], bases[i]);
+    }
+    free(b);
+}
+
 UNIT(EncodeNullState)
 {
     inform_error err = INFORM_SUCCESS;
@@ -556,6 +945,149 @@ UNIT(DecodeEncode)
     }
 }
 
+UNIT(EncodeMixedInvalid)
+{
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_encode_mixed(NULL, 2, (int[]){2,3}, &err));
+    ASSERT_EQUAL(INFORM_EARG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_encode_mixed((int[]){0,1}, 2, NULL, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_encode_mixed((int[]){0,1}, 2, (int[]){2,1}, &err));
+    ASSERT_EQUAL(INFORM_EBASE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_encode_mixed((int[]){0,3}, 2, (int[]){2,3}, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_encode_mixed((int[]){0,-1}, 2, (int[]){2,3}, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
+UNIT(EncodeMixed)
+{
+    int const b[3] = {2, 3, 4};
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_encode_mixed((int[]){0,0,0}, 3, b, &err));
+    ASSERT_EQUAL(3, inform_encode_mixed((int[]){0,0,3}, 3, b, &err));
+    ASSERT_EQUAL(4, inform_encode_mixed((int[]){0,1,0}, 3, b, &err));
+    ASSERT_EQUAL(12, inform_encode_mixed((int[]){1,0,0}, 3, b, &err));
+    ASSERT_EQUAL(23, inform_encode_mixed((int[]){1,2,3}, 3, b, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+}
+
+UNIT(EncodeMixed64Bits)
+{
+    int state[40], b[40];
+    for (size_t i = 0; i < 40; ++i)
+    {
+        state[i] = 1;
+        b[i] = 3;
+    }
+    inform_error err = INFORM_SUCCESS;
+    uint64_t expect = 0;
+    for (size_t i = 0; i < 40; ++i) expect = 3 * expect + 1;
+    ASSERT_TRUE(expect == inform_encode_mixed(state, 40, b, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+    int decoded[40];
+    inform_decode_mixed(expect, b, decoded, 40, &err);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 40; ++i) ASSERT_EQUAL(1, decoded[i]);
+
+    int big[41];
+    for (size_t i = 0; i < 41; ++i) big[i] = 3;
+    err = INFORM_SUCCESS;
+    ASSERT_EQUAL(0, inform_encode_mixed(state, 41, big, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
+UNIT(DecodeMixed)
+{
+    int const b[3] = {2, 3, 4};
+    int state[3];
+    inform_error err = INFORM_SUCCESS;
+    for (int i = 0; i < 24; ++i)
+    {
+        inform_decode_mixed(i, b, state, 3, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_TRUE((uint64_t) i == inform_encode_mixed(state, 3, b, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+    }
+
+    inform_decode_mixed(24, b, state, 3, &err);
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
+UNIT(EncodeSeriesInvalid)
+{
+    int const series[6] = {0,1,2, 1,1,0};
+    int codes[3];
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_encode_series(NULL, 2, 3, (int[]){3,2}, codes, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_encode_series(series, 0, 3, (int[]){3,2}, codes, &err));
+    ASSERT_EQUAL(INFORM_ENOSOURCES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_encode_series(series, 2, 0, (int[]){3,2}, codes, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_encode_series(series, 2, 3, (int[]){2,2}, codes, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_encode_series(series, 2, 3, (int[]){65536,65536}, codes, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
+UNIT(EncodeSeries)
+{
+    int const series[6] = {0,1,2, 1,1,0};
+    int const b[2] = {3,2};
+    {
+        int codes[3];
+        inform_error err = INFORM_SUCCESS;
+        ASSERT_NOT_NULL(inform_encode_series(series, 2, 3, b, codes, &err));
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_EQUAL(1, codes[0]);
+        ASSERT_EQUAL(3, codes[1]);
+        ASSERT_EQUAL(4, codes[2]);
+    }
+    {
+        inform_error err = INFORM_SUCCESS;
+        uint64_t *codes = inform_encode_series64(series, 2, 3, b, NULL, &err);
+        ASSERT_NOT_NULL(codes);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_TRUE(1 == codes[0]);
+        ASSERT_TRUE(3 == codes[1]);
+        ASSERT_TRUE(4 == codes[2]);
+        free(codes);
+    }
+    {
+        size_t const N = 5000;
+        int *xs = malloc(3 * N * sizeof(int));
+        for (size_t i = 0; i < 3 * N; ++i) xs[i] = (int)((i * 7) % 5);
+        inform_error err = INFORM_SUCCESS;
+        int *codes = inform_encode_series(xs, 3, N, (int[]){5,5,5}, NULL, &err);
+        ASSERT_NOT_NULL(codes);
+        for (size_t j = 0; j < N; ++j)
+        {
+            int state[3] = { xs[j], xs[j + N], xs[j + 2*N] };
+            ASSERT_EQUAL(inform_encode(state, 3, 5, NULL), codes[j]);
+        }
+        free(codes);
+        free(xs);
+    }
+}
+
 UNIT(RandomInt)
 {
     for (int b = 2; b < 5; ++b)
@@ -677,6 +1209,258 @@ UNIT(TPMZeroRow)
     }
 }
 
+UNIT(TPMSparseInvalid)
+{
+    inform_error err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_tpm_sparse(NULL, 1, 10, 2, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_tpm_sparse((int[6]){0,1,0,1,1,0}, 0, 6, 2, &err));
+    ASSERT_EQUAL(INFORM_ENOINITS, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_tpm_sparse((int[6]){0,1,0,1,1,0}, 6, 1, 2, &err));
+    ASSERT_EQUAL(INFORM_ESHORTSERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_tpm_sparse((int[6]){0,-1,0,1,1,0}, 2, 3, 2, &err));
+    ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_tpm_sparse((int[6]){0,1,0,1,2,0}, 2, 3, 2, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+}
+
+UNIT(TPMSparse)
+{
+    inform_error err = INFORM_SUCCESS;
+    {
+        inform_sparse_tpm *tpm = inform_tpm_sparse((int[6]){0,1,0,1,1,0}, 2, 3, 2, &err);
+        ASSERT_NOT_NULL(tpm);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_EQUAL(2, tpm->rows);
+        ASSERT_EQUAL(2, tpm->cols);
+        ASSERT_EQUAL(3, tpm->nnz);
+        size_t const offsets[3] = {0, 1, 3}, indices[3] = {1, 0, 1};
+        double const values[3] = {1.0, 2.0/3, 1.0/3};
+        for (size_t i = 0; i < 3; ++i)
+        {
+            ASSERT_EQUAL(offsets[i], tpm->offsets[i]);
+            ASSERT_EQUAL(indices[i], tpm->indices[i]);
+            ASSERT_DBL_NEAR_TOL(values[i], tpm->values[i], 1e-12);
+        }
+        inform_sparse_tpm_free(tpm);
+    }
+    {
+        // state 2 is never followed by another state
+        inform_sparse_tpm *tpm = inform_tpm_sparse((int[4]){0,1,1,2}, 1, 4, 3, &err);
+        ASSERT_NOT_NULL(tpm);
+        ASSERT_EQUAL(INFORM_ETPMROW, err);
+        ASSERT_EQUAL(tpm->offsets[2], tpm->offsets[3]);
+        inform_sparse_tpm_free(tpm);
+    }
+    {
+        // enough transitions among enough states to be built in parallel
+        size_t const n = 4, m = 50000;
+        int const b = 5000;
+        int *series = malloc(n * m * sizeof(int));
+        ASSERT_NOT_NULL(series);
+        uint64_t state = 7;
+        for (size_t i = 0; i < n * m; ++i)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            int const prev = (i % m == 0) ? 0 : series[i - 1];
+            series[i] = (prev + 1 + (int)((state >> 33) % 8)) % b;
+        }
+        err = INFORM_SUCCESS;
+        inform_sparse_tpm *tpm = inform_tpm_sparse(series, n, m, b, &err);
+        ASSERT_NOT_NULL(tpm);
+        double *dense = inform_tpm(series, n, m, b, NULL, &err);
+        ASSERT_NOT_NULL(dense);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        size_t nnz = 0;
+        for (size_t i = 0; i < (size_t) b; ++i)
+        {
+            for (size_t j = tpm->offsets[i]; j < tpm->offsets[i + 1]; ++j)
+            {
+                ASSERT_TRUE(j == tpm->offsets[i] || tpm->indices[j - 1] < tpm->indices[j]);
+                ASSERT_DBL_NEAR_TOL(dense[i * b + tpm->indices[j]], tpm->values[j], 1e-12);
+            }
+            for (size_t j = 0; j < (size_t) b; ++j)
+            {
+                nnz += (dense[i * b + j] != 0);
+            }
+        }
+        ASSERT_EQUAL(nnz, tpm->nnz);
+        free(dense);
+        inform_sparse_tpm_free(tpm);
+        free(series);
+    }
+}
+
+UNIT(TPMKInvalid)
+{
+    inform_error err = INFORM_SUCCESS;
+    int const series[6] = {0,1,0,1,1,0};
+    ASSERT_NULL(inform_tpm_k(NULL, 1, 6, 2, 2, true, &err));
+    ASSERT_EQUAL(INFORM_ETIMESERIES, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_tpm_k(series, 1, 6, 2, 0, true, &err));
+    ASSERT_EQUAL(INFORM_EKZERO, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_tpm_k(series, 2, 3, 2, 3, true, &err));
+    ASSERT_EQUAL(INFORM_EKLONG, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_tpm_k(series, 1, 6, 1000, 4, true, &err));
+    ASSERT_EQUAL(INFORM_EENCODE, err);
+}
+
+UNIT(TPMK)
+{
+    inform_error err = INFORM_SUCCESS;
+    int const series[8] = {0,0,1,1,0,1,0,0};
+    {
+        inform_sparse_tpm *tpm = inform_tpm_k(series, 1, 8, 2, 2, false, &err);
+        ASSERT_NOT_NULL(tpm);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_EQUAL(4, tpm->rows);
+        ASSERT_EQUAL(4, tpm->cols);
+        size_t const offsets[5] = {0, 1, 3, 5, 6}, indices[6] = {1, 2, 3, 0, 1, 2};
+        for (size_t i = 0; i < 5; ++i) ASSERT_EQUAL(offsets[i], tpm->offsets[i]);
+        for (size_t i = 0; i < 6; ++i)
+        {
+            ASSERT_EQUAL(indices[i], tpm->indices[i]);
+            ASSERT_DBL_NEAR_TOL(1.0, tpm->values[i], 1e-12);
+        }
+        inform_sparse_tpm_free(tpm);
+    }
+    {
+        inform_sparse_tpm *tpm = inform_tpm_k(series, 1, 8, 2, 2, true, &err);
+        ASSERT_NOT_NULL(tpm);
+        double const values[6] = {1.0, 0.5, 0.5, 0.5, 0.5, 1.0};
+        for (size_t i = 0; i < 6; ++i)
+        {
+            ASSERT_DBL_NEAR_TOL(values[i], tpm->values[i], 1e-12);
+        }
+        inform_sparse_tpm_free(tpm);
+    }
+    {
+        // with k = 1 the matrix is the first-order TPM
+        inform_sparse_tpm *a = inform_tpm_k(series, 2, 4, 2, 1, true, &err);
+        inform_sparse_tpm *b = inform_tpm_sparse(series, 2, 4, 2, &err);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_EQUAL(b->nnz, a->nnz);
+        for (size_t i = 0; i < a->nnz; ++i)
+        {
+            ASSERT_EQUAL(b->indices[i], a->indices[i]);
+            ASSERT_DBL_NEAR_TOL(b->values[i], a->values[i], 1e-12);
+        }
+        inform_sparse_tpm_free(a);
+        inform_sparse_tpm_free(b);
+    }
+    {
+        // only the history 00 is ever observed
+        inform_sparse_tpm *tpm = inform_tpm_k((int[4]){0,0,0,1}, 1, 4, 2, 2, true, &err);
+        ASSERT_NOT_NULL(tpm);
+        ASSERT_EQUAL(INFORM_ETPMROW, err);
+        ASSERT_EQUAL(2, tpm->nnz);
+        inform_sparse_tpm_free(tpm);
+    }
+}
+
+UNIT(TPMCoarseGrainInvalid)
+{
+    inform_error err = INFORM_SUCCESS;
+    size_t const groups[4] = {0, 0, 1, 1};
+    ASSERT_NULL(inform_tpm_coarse_grain(NULL, groups, 2, &err));
+    ASSERT_EQUAL(INFORM_ETPM, err);
+
+    inform_sparse_tpm *tpm = inform_tpm_sparse((int[5]){0,1,2,3,0}, 1, 5, 4, &err);
+    ASSERT_NOT_NULL(tpm);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_tpm_coarse_grain(tpm, NULL, 2, &err));
+    ASSERT_EQUAL(INFORM_EPARTS, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_tpm_coarse_grain(tpm, groups, 0, &err));
+    ASSERT_EQUAL(INFORM_EPARTS, err);
+
+    err = INFORM_SUCCESS;
+    ASSERT_NULL(inform_tpm_coarse_grain(tpm, (size_t[4]){0, 1, 2, 2}, 2, &err));
+    ASSERT_EQUAL(INFORM_EPARTS, err);
+
+    inform_sparse_tpm_free(tpm);
+}
+
+UNIT(TPMCoarseGrain)
+{
+    inform_error err = INFORM_SUCCESS;
+    {
+        // 0 -> 1 -> 2 -> 3 -> 0, and 1 -> 3
+        inform_sparse_tpm *tpm = inform_tpm_sparse((int[7]){0,1,2,3,0,1,3}, 1, 7,
+            4, &err);
+        ASSERT_NOT_NULL(tpm);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+
+        inform_sparse_tpm *coarse = inform_tpm_coarse_grain(tpm,
+            (size_t[4]){0, 0, 1, 1}, 2, &err);
+        ASSERT_NOT_NULL(coarse);
+        ASSERT_EQUAL(INFORM_SUCCESS, err);
+        ASSERT_EQUAL(2, coarse->rows);
+        ASSERT_EQUAL(2, coarse->cols);
+        ASSERT_EQUAL(4, coarse->nnz);
+        size_t const offsets[3] = {0, 2, 4}, indices[4] = {0, 1, 0, 1};
+        double const values[4] = {0.5, 0.5, 0.5, 0.5};
+        for (size_t i = 0; i < 3; ++i) ASSERT_EQUAL(offsets[i], coarse->offsets[i]);
+        for (size_t i = 0; i < 4; ++i)
+        {
+            ASSERT_EQUAL(indices[i], coarse->indices[i]);
+            ASSERT_DBL_NEAR_TOL(values[i], coarse->values[i], 1e-12);
+        }
+        inform_sparse_tpm_free(coarse);
+
+        // the identity grouping reproduces the matrix
+        coarse = inform_tpm_coarse_grain(tpm, (size_t[4]){0, 1, 2, 3}, 4, &err);
+        ASSERT_NOT_NULL(coarse);
+        ASSERT_EQUAL(tpm->nnz, coarse->nnz);
+        for (size_t i = 0; i < tpm->nnz; ++i)
+        {
+            ASSERT_EQUAL(tpm->indices[i], coarse->indices[i]);
+            ASSERT_DBL_NEAR_TOL(tpm->values[i], coarse->values[i], 1e-12);
+        }
+        inform_sparse_tpm_free(coarse);
+        inform_sparse_tpm_free(tpm);
+    }
+    {
+        // the state 2 is never followed by another, so is ignored by its
+        // group, and the group containing only state 3 has an empty row
+        inform_sparse_tpm *tpm = inform_tpm_sparse((int[5]){0,1,0,0,2}, 1, 5, 4,
+            &err);
+        ASSERT_EQUAL(INFORM_ETPMROW, err);
+
+        err = INFORM_SUCCESS;
+        inform_sparse_tpm *coarse = inform_tpm_coarse_grain(tpm,
+            (size_t[4]){0, 1, 1, 2}, 3, &err);
+        ASSERT_NOT_NULL(coarse);
+        ASSERT_EQUAL(INFORM_ETPMROW, err);
+        size_t const offsets[4] = {0, 2, 3, 3}, indices[3] = {0, 1, 0};
+        double const values[3] = {1.0/3, 2.0/3, 1.0};
+        for (size_t i = 0; i < 4; ++i) ASSERT_EQUAL(offsets[i], coarse->offsets[i]);
+        for (size_t i = 0; i < 3; ++i)
+        {
+            ASSERT_EQUAL(indices[i], coarse->indices[i]);
+            ASSERT_DBL_NEAR_TOL(values[i], coarse->values[i], 1e-12);
+        }
+        inform_sparse_tpm_free(coarse);
+        inform_sparse_tpm_free(tpm);
+    }
+}
+
 UNIT(TPMBase2)
 {
     inform_error err;
@@ -910,6 +1694,29 @@ UNIT(BlackBoxEncodingError)
     }
 }
 
+UNIT(BlackBoxEncodingLimit)
+{
+    inform_error err = INFORM_SUCCESS;
+    // 3^19 = 1162261467 is the largest power of 3 no greater than INT_MAX
+    size_t const m = 100, r = 19, w = m - r + 1;
+    int const b = 3;
+    int series[100], box[82];
+    for (size_t t = 0; t < m; ++t)
+    {
+        series[t] = (t < 40) ? 2 : (int) ((t * 7 + t / 5) % 3);
+    }
+
+    ASSERT_EQUAL_P(box, inform_black_box(series, 1, 1, m, &b, &r, NULL, box,
+        &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t t = 0; t < w; ++t)
+    {
+        int64_t expect = 0;
+        for (size_t k = t; k < t + r; ++k) expect = expect * b + series[k];
+        ASSERT_EQUAL(expect, box[t]);
+    }
+}
+
 UNIT(BlackBoxAllocates)
 {
     inform_error err = INFORM_SUCCESS;
@@ -1330,6 +2137,158 @@ UNIT(BlackBoxMultipleSeriesEnsemble)
     }
 }
 
+UNIT(BlackBoxLongEnsemble)
+{
+    inform_error err = INFORM_SUCCESS;
+    size_t const l = 3, n = 4, m = 10000;
+    int const b[3] = {2, 3, 2};
+    size_t const r[3] = {2, 1, 3};
+    size_t const s[3] = {1, 0, 2};
+    size_t const max_r = 3, max_s = 2, w = m - max_r - max_s + 1;
+
+    int *series = malloc(l * n * m * sizeof(int));
+    int *box = malloc(n * w * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    ASSERT_NOT_NULL(box);
+    for (size_t i = 0; i < l; ++i)
+    {
+        for (size_t j = 0; j < n * m; ++j)
+        {
+            series[j + n * m * i] = (int) ((j * (2 * i + 7) + j / 13) % (size_t) b[i]);
+        }
+    }
+
+    ASSERT_EQUAL_P(box, inform_black_box(series, l, n, m, b, r, s, box, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t j = 0; j < n; ++j)
+    {
+        for (size_t t = 0; t < w; ++t)
+        {
+            int expect = 0;
+            for (size_t i = 0; i < l; ++i)
+            {
+                for (size_t k = t + max_r - r[i]; k < t + max_r + s[i]; ++k)
+                {
+                    expect = expect * b[i] + series[k + m * (j + n * i)];
+                }
+            }
+            ASSERT_EQUAL(expect, box[t + w * j]);
+        }
+    }
+
+    series[2 * n * m + 5] = 2;
+    series[2 * n * m - 1] = -1;
+    ASSERT_NULL(inform_black_box(series, l, n, m, b, r, s, box, &err));
+    ASSERT_EQUAL(INFORM_ENEGSTATE, err);
+
+    free(box);
+    free(series);
+}
+
+UNIT(BlackBoxLongEnsembleLimit)
+{
+    inform_error err = INFORM_SUCCESS;
+    // a support of 3^19 = 1162261467 leaves no headroom below INT_MAX, and
+    // each initial condition spans several tiles
+    size_t const n = 3, m = 25000, r = 19, w = m - r + 1;
+    int const b = 3;
+
+    int *series = malloc(n * m * sizeof(int));
+    int *data = malloc(2 * n * m * sizeof(int));
+    int *box = malloc(n * w * sizeof(int));
+    ASSERT_NOT_NULL(series);
+    ASSERT_NOT_NULL(data);
+    ASSERT_NOT_NULL(box);
+    for (size_t j = 0; j < n * m; ++j)
+    {
+        // mostly the largest state, so the rolling states stay near 3^19
+        series[j] = (j % 23 == 0) ? (int) (j % 2) : 2;
+        data[2 * j] = series[j];
+        data[2 * j + 1] = -1;
+    }
+
+    ASSERT_EQUAL_P(box, inform_black_box(series, 1, n, m, &b, &r, NULL, box,
+        &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t j = 0; j < n; ++j)
+    {
+        for (size_t t = 0; t < w; ++t)
+        {
+            int64_t expect = 0;
+            for (size_t k = t; k < t + r; ++k)
+            {
+                expect = expect * b + series[k + m * j];
+            }
+            ASSERT_EQUAL(expect, box[t + w * j]);
+        }
+    }
+
+    // the same samples, read through a view which skips every other element
+    inform_view const view = inform_view_strided(data, 2, 2 * m, 2 * n * m);
+    int *viewed = inform_black_box_view(view, 1, n, m, &b, &r, NULL, NULL,
+        &err);
+    ASSERT_NOT_NULL(viewed);
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < n * w; ++i)
+    {
+        ASSERT_EQUAL(box[i], viewed[i]);
+    }
+
+    free(viewed);
+    free(box);
+    free(data);
+    free(series);
+}
+
+UNIT(BlackBoxView)
+{
+    inform_error err = INFORM_SUCCESS;
+    size_t const l = 3, n = 2, m = 9;
+    int const b[3] = {2, 3, 2};
+    size_t const r[3] = {2, 1, 1};
+    size_t const s[3] = {0, 1, 1};
+    // a time by variable matrix for each initial condition
+    int data[54], series[54];
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t t = 0; t < m; ++t)
+        {
+            for (size_t v = 0; v < l; ++v)
+            {
+                int const x = (int) ((t * 5 + v * 3 + i + t / 3) % (size_t) b[v]);
+                data[v + l * (t + m * i)] = x;
+                series[t + m * (i + n * v)] = x;
+            }
+        }
+    }
+
+    int *expect = inform_black_box(series, l, n, m, b, r, s, NULL, &err);
+    ASSERT_NOT_NULL(expect);
+    int box[14];
+    inform_view const view = inform_view_strided(data, l, l * m, 1);
+    ASSERT_EQUAL_P(box, inform_black_box_view(view, l, n, m, b, r, s, box, &err));
+    ASSERT_EQUAL(INFORM_SUCCESS, err);
+    for (size_t i = 0; i < 14; ++i)
+    {
+        ASSERT_EQUAL(expect[i], box[i]);
+    }
+    free(expect);
+
+    data[1 + l * 4] = 3;
+    ASSERT_NULL(inform_black_box_view(view, l, n, m, b, r, s, box, &err));
+    ASSERT_EQUAL(INFORM_EBADSTATE, err);
+}
+
+UNIT(ViewContiguous)
+{
+    int const series[12] = {0};
+    inform_view const view = inform_view_contiguous(series, 2, 3);
+    ASSERT_TRUE(series == view.data);
+    ASSERT_EQUAL(1, (int) view.time_stride);
+    ASSERT_EQUAL(3, (int) view.init_stride);
+    ASSERT_EQUAL(6, (int) view.var_stride);
+}
+
 UNIT(BlackBoxPartsNullSeries)
 {
     inform_error err = INFORM_SUCCESS;
@@ -1691,6 +2650,46 @@ UNIT(PartitionsBellNumbers)
         ASSERT_EQUAL_U(bell_numbers[i-1], bell_number(i));
 }
 
+UNIT(PartitionsNextChanges)
+{
+    for (size_t size = 1; size <= 7; ++size)
+    {
+        size_t *parts = inform_first_partitioning(size);
+        size_t *expected = inform_first_partitioning(size);
+        size_t *previous = inform_first_partitioning(size);
+        size_t *changed = malloc(size * sizeof(size_t));
+        ASSERT_NOT_NULL(changed);
+
+        size_t n, nchanged;
+        while ((n = inform_next_partitioning_changes(parts, size, changed, &nchanged)))
+        {
+            ASSERT_EQUAL_U(inform_next_partitioning(expected, size), n);
+            for (size_t i = 0; i < size; ++i)
+                ASSERT_EQUAL_U(expected[i], parts[i]);
+
+            // a block has changed if and only if some element joined or left it
+            for (size_t j = 0; j < size; ++j)
+            {
+                bool differs = false;
+                for (size_t i = 0; i < size; ++i)
+                    differs |= ((previous[i] == j) != (parts[i] == j));
+                size_t reported = 0;
+                for (size_t k = 0; k < nchanged; ++k)
+                    reported += (changed[k] == j);
+                ASSERT_EQUAL_U(differs ? 1 : 0, reported);
+            }
+            memcpy(previous, parts, size * sizeof(size_t));
+        }
+        ASSERT_EQUAL_U(0, inform_next_partitioning(expected, size));
+        ASSERT_EQUAL_U(0, nchanged);
+
+        free(changed);
+        free(previous);
+        free(expected);
+        free(parts);
+    }
+}
+
 BEGIN_SUITE(Utilities)
     ADD_UNIT(RangeNullSeries)
     ADD_UNIT(RangeEmpty)
@@ -1723,6 +2722,18 @@ BEGIN_SUITE(Utilities)
     ADD_UNIT(BinBoundsTwo)
     ADD_UNIT(BinBoundsNone)
     ADD_UNIT(BinBoundsAll)
+    ADD_UNIT(BinBoundsMany)
+    ADD_UNIT(BinBoundsUnsorted)
+    ADD_UNIT(BinRangeInvalid)
+    ADD_UNIT(BinRange)
+
+    ADD_UNIT(SketchInvalid)
+    ADD_UNIT(SketchSmallIsExact)
+    ADD_UNIT(SketchLarge)
+    ADD_UNIT(QuantileBoundsInvalid)
+    ADD_UNIT(QuantileBounds)
+    ADD_UNIT(BinQuantiles)
+    ADD_UNIT(BinQuantilesLarge)
 
     ADD_UNIT(CoalesceNullSeries)
     ADD_UNIT(CoalesceEmpty)
@@ -1730,6 +2741,10 @@ BEGIN_SUITE(Utilities)
     ADD_UNIT(CoalesceUnchanged)
     ADD_UNIT(CoalesceShifted)
     ADD_UNIT(CoalesceNoGaps)
+    ADD_UNIT(CoalesceSparse)
+    ADD_UNIT(CoalesceSparseMany)
+    ADD_UNIT(CoalesceColumnsInvalid)
+    ADD_UNIT(CoalesceColumns)
 
     ADD_UNIT(EncodeNullState)
     ADD_UNIT(EncodeEmpty)
@@ -1749,6 +2764,13 @@ BEGIN_SUITE(Utilities)
 
     ADD_UNIT(DecodeEncode)
 
+    ADD_UNIT(EncodeMixedInvalid)
+    ADD_UNIT(EncodeMixed)
+    ADD_UNIT(EncodeMixed64Bits)
+    ADD_UNIT(DecodeMixed)
+    ADD_UNIT(EncodeSeriesInvalid)
+    ADD_UNIT(EncodeSeries)
+
     ADD_UNIT(RandomInt)
     ADD_UNIT(RandomIntMinMax)
 
@@ -1762,6 +2784,12 @@ BEGIN_SUITE(Utilities)
     ADD_UNIT(TPMZeroRow)
     ADD_UNIT(TPMBase2)
     ADD_UNIT(TPMBase3)
+    ADD_UNIT(TPMSparseInvalid)
+    ADD_UNIT(TPMSparse)
+    ADD_UNIT(TPMKInvalid)
+    ADD_UNIT(TPMK)
+    ADD_UNIT(TPMCoarseGrainInvalid)
+    ADD_UNIT(TPMCoarseGrain)
 
     ADD_UNIT(BlackBoxNullSeries)
     ADD_UNIT(BlackBoxEmptySeries)
@@ -1773,11 +2801,16 @@ BEGIN_SUITE(Utilities)
     ADD_UNIT(BlackBoxInvalidHistory)
     ADD_UNIT(BlackBoxHistoryFutureTooLong)
     ADD_UNIT(BlackBoxEncodingError)
+    ADD_UNIT(BlackBoxEncodingLimit)
     ADD_UNIT(BlackBoxAllocates)
     ADD_UNIT(BlackBoxSingleSeries)
     ADD_UNIT(BlackBoxSingleSeriesEnsemble)
     ADD_UNIT(BlackBoxMultipleSeries)
     ADD_UNIT(BlackBoxMultipleSeriesEnsemble)
+    ADD_UNIT(BlackBoxLongEnsemble)
+    ADD_UNIT(BlackBoxLongEnsembleLimit)
+    ADD_UNIT(BlackBoxView)
+    ADD_UNIT(ViewContiguous)
 
     ADD_UNIT(BlackBoxPartsNullSeries)
     ADD_UNIT(BlackBoxPartsEmptySeries)
@@ -1794,5 +2827,6 @@ BEGIN_SUITE(Utilities)
     ADD_UNIT(PartitionsNext2)
     ADD_UNIT(PartitionsNext3)
     ADD_UNIT(PartitionsNext4)
+    ADD_UNIT(PartitionsNextChanges)
     ADD_UNIT(PartitionsBellNumbers)
 END_SUITE